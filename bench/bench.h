@@ -0,0 +1,38 @@
+#ifndef E1F4B7A0_3C92_4D6E_8B15_7A2C9D0E4F61
+#define E1F4B7A0_3C92_4D6E_8B15_7A2C9D0E4F61
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+// seconds since some fixed point in the past (monotonic clock)
+static inline double bench_now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// print one line of results, count is number of operations done in seconds
+static inline void bench_report(const char *name, double seconds, uint64_t count)
+{
+    printf("%-44s %10.3f ms %10.2f ns/op\n", name, seconds * 1e3, count ? seconds * 1e9 / count : 0.0);
+}
+
+// xorshift64* pseudo random generator, so that runs are reproducible
+static inline uint64_t bench_random(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+// first command line argument as number of elements or default_count if it isn't given
+static inline uint64_t bench_count(int argc, char *argv[], uint64_t default_count)
+{
+    return argc > 1 ? strtoull(argv[1], NULL, 10) : default_count;
+}
+
+#endif /* E1F4B7A0_3C92_4D6E_8B15_7A2C9D0E4F61 */
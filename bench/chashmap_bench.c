@@ -0,0 +1,185 @@
+#include <pthread.h>
+#include <unistd.h>
+#include "bench.h"
+#include "../src/hashmap.h"
+#include "../src/chashmap.h"
+
+#define LOOKUPS_PER_THREAD 2000000
+#define WRITE_PAUSE_US 10 // writer sleeps this long between writes (tens of thousands of writes per second)
+
+static uint32_t int_hash(void *data)
+{
+    // murmur3 finalizer
+    uint32_t hash = (uint32_t) *(int *) data;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// ways of sharing a map between threads
+#define SHARE_MUTEX 0 // Hashmap behind one mutex
+#define SHARE_RWLOCK 1 // Hashmap behind read/write lock
+#define SHARE_CONCURRENT 2 // CHashmap
+
+typedef struct shared_map {
+    int kind;
+    Hashmap *map;
+    CHashmap *concurrent;
+    pthread_mutex_t mutex;
+    pthread_rwlock_t rwlock;
+    int *values;
+    uint32_t count;
+    int stop; // tells writer to finish
+    uint64_t hits;
+} shared_map;
+
+typedef struct worker {
+    shared_map *shared;
+    pthread_t thread;
+    uint64_t seed;
+} worker;
+
+static void *reader(void *arg)
+{
+    worker *self = arg;
+    shared_map *shared = self->shared;
+    uint64_t state = self->seed, hits = 0;
+    uint32_t i;
+
+    for (i = 0; i < LOOKUPS_PER_THREAD; i++) {
+        int *key = &shared->values[bench_random(&state) % shared->count];
+        switch (shared->kind) {
+            case SHARE_MUTEX:
+                pthread_mutex_lock(&shared->mutex);
+                hits += Hashmap_find(shared->map, key) != NULL;
+                pthread_mutex_unlock(&shared->mutex);
+                break;
+            case SHARE_RWLOCK:
+                pthread_rwlock_rdlock(&shared->rwlock);
+                hits += Hashmap_find(shared->map, key) != NULL;
+                pthread_rwlock_unlock(&shared->rwlock);
+                break;
+            default:
+                hits += CHashmap_find(shared->concurrent, key) != NULL;
+        }
+    }
+    __atomic_add_fetch(&shared->hits, hits, __ATOMIC_RELAXED);
+
+    return NULL;
+}
+
+// removes and inserts back keys from second half of values until readers are done
+static void *writer(void *arg)
+{
+    worker *self = arg;
+    shared_map *shared = self->shared;
+    uint64_t state = self->seed;
+
+    while (!__atomic_load_n(&shared->stop, __ATOMIC_ACQUIRE)) {
+        int *key = &shared->values[shared->count / 2 + bench_random(&state) % (shared->count / 2)];
+        switch (shared->kind) {
+            case SHARE_MUTEX:
+                pthread_mutex_lock(&shared->mutex);
+                if (!Hashmap_remove(shared->map, key)) Hashmap_insert(shared->map, key);
+                pthread_mutex_unlock(&shared->mutex);
+                break;
+            case SHARE_RWLOCK:
+                pthread_rwlock_wrlock(&shared->rwlock);
+                if (!Hashmap_remove(shared->map, key)) Hashmap_insert(shared->map, key);
+                pthread_rwlock_unlock(&shared->rwlock);
+                break;
+            default:
+                if (!CHashmap_remove(shared->concurrent, key)) CHashmap_insert(shared->concurrent, key);
+        }
+        usleep(WRITE_PAUSE_US);
+    }
+
+    return NULL;
+}
+
+// run readers (and writer) on shared map, report lookup throughput
+static void run(shared_map *shared, uint32_t threads, int with_writer, const char *kind)
+{
+    worker *workers = calloc(threads, sizeof(worker));
+    worker writing = {shared, 0, 12345};
+    char name[64];
+    uint32_t i;
+
+    if (!workers) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        exit(1);
+    }
+
+    shared->stop = 0;
+    if (with_writer) pthread_create(&writing.thread, NULL, writer, &writing);
+
+    double start = bench_now();
+    for (i = 0; i < threads; i++) {
+        workers[i].shared = shared;
+        workers[i].seed = 88172645463325252ULL + i;
+        pthread_create(&workers[i].thread, NULL, reader, &workers[i]);
+    }
+    for (i = 0; i < threads; i++) pthread_join(workers[i].thread, NULL);
+    double took = bench_now() - start;
+
+    __atomic_store_n(&shared->stop, 1, __ATOMIC_RELEASE);
+    if (with_writer) pthread_join(writing.thread, NULL);
+
+    snprintf(name, sizeof(name), "%s, %u readers%s", kind, threads, with_writer ? " + writer" : "");
+    // ns/op is wall time per lookup of all threads together, so it drops as throughput scales
+    bench_report(name, took, (uint64_t) threads * LOOKUPS_PER_THREAD);
+
+    free(workers);
+}
+
+// usage: chashmap_bench [number of keys] [max threads], readers double from 1 up to max threads
+int main(int argc, char *argv[])
+{
+    uint32_t count = (uint32_t) bench_count(argc, argv, 1 << 20), i, threads;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_threads = argc > 2 ? (uint32_t) strtoul(argv[2], NULL, 10) : (online > 0 ? (uint32_t) online : 1);
+    const char *kinds[] = {"Hashmap + mutex", "Hashmap + rwlock", "CHashmap"};
+    shared_map shared = {0};
+    int kind, with_writer;
+
+    shared.count = count;
+    shared.values = malloc(sizeof(int) * count);
+    shared.map = Hashmap_create(NULL, int_hash, count);
+    shared.concurrent = CHashmap_create(NULL, int_hash, count);
+    if (!shared.values || !shared.map || !shared.concurrent || count < 2 || max_threads == 0) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+    pthread_mutex_init(&shared.mutex, NULL);
+    pthread_rwlock_init(&shared.rwlock, NULL);
+
+    for (i = 0; i < count; i++) {
+        shared.values[i] = (int) i;
+        Hashmap_insert(shared.map, &shared.values[i]);
+        CHashmap_insert(shared.concurrent, &shared.values[i]);
+    }
+
+    printf("--- %u keys, %u lookups per reader, %ld online processors\n", count, LOOKUPS_PER_THREAD, online);
+
+    for (with_writer = 0; with_writer < 2; with_writer++) {
+        for (threads = 1; threads <= max_threads; threads *= 2) {
+            for (kind = SHARE_MUTEX; kind <= SHARE_CONCURRENT; kind++) {
+                shared.kind = kind;
+                run(&shared, threads, with_writer, kinds[kind]);
+            }
+        }
+    }
+
+    printf("hits: %llu\n", (unsigned long long) shared.hits);
+
+    Hashmap_destroy(&shared.map, NULL);
+    CHashmap_destroy(&shared.concurrent, NULL);
+    pthread_mutex_destroy(&shared.mutex);
+    pthread_rwlock_destroy(&shared.rwlock);
+    free(shared.values);
+
+    return 0;
+}
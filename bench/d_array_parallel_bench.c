@@ -0,0 +1,98 @@
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "../src/d_array_sort.h"
+#include "../src/d_array_parallel.h"
+
+// compares ints behind pointers, as default compare of d_array does
+static int int_cmp(const void *const restrict data1, const void *const restrict data2)
+{
+    int a = *(const int *) data1, b = *(const int *) data2;
+    return (a > b) - (a < b);
+}
+
+// a bit of per element work, so that traversal isn't bound by memory only
+static int mix_cb(void *data)
+{
+    uint64_t x = (uint64_t) *(int *) data;
+    int i;
+    for (i = 0; i < 8; i++) x = x * 0x9E3779B97F4A7C15ULL + 1;
+    return x == 0 ? CERB_ERR : CERB_OK;
+}
+
+static void sum_cb(void *accumulator, void *data)
+{
+    *(int64_t *) accumulator += *(int *) data;
+}
+
+static void combine_cb(void *accumulator, const void *other)
+{
+    *(int64_t *) accumulator += *(const int64_t *) other;
+}
+
+// fill array with pointers to values in their original order
+static void reset(d_array *array, int *values, uint32_t count)
+{
+    uint32_t i;
+    for (i = 0; i < count; i++) array->data[i] = &values[i];
+    array->length = count;
+}
+
+// usage: d_array_parallel_bench [count] [max threads], threads double from 1 up to max threads
+int main(int argc, char *argv[])
+{
+    uint32_t count = (uint32_t) bench_count(argc, argv, 10000000), i, threads;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_threads = argc > 2 ? (uint32_t) strtoul(argv[2], NULL, 10) : (online > 0 ? (uint32_t) online : 1);
+    uint64_t state = 88172645463325252ULL;
+    char name[64];
+    double start, serial_sort;
+
+    int *values = malloc(sizeof(int) * count);
+    d_array *array = d_array_create(int_cmp, count);
+    if (!values || !array || max_threads == 0) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+    for (i = 0; i < count; i++) values[i] = (int) bench_random(&state);
+
+    printf("--- %u elements, %ld online processors\n", count, online);
+
+    reset(array, values, count);
+    start = bench_now();
+    d_array_stable_sort(array);
+    serial_sort = bench_now() - start;
+    bench_report("d_array_stable_sort (serial)", serial_sort, count);
+
+    for (threads = 1; threads <= max_threads; threads = threads < max_threads && threads * 2 > max_threads ? max_threads : threads * 2) {
+        cerb_executor *executor = cerb_executor_create(threads);
+        if (!executor) return 1;
+
+        reset(array, values, count);
+        start = bench_now();
+        d_array_parallel_traverse(array, executor, 0, mix_cb);
+        snprintf(name, sizeof(name), "parallel_traverse (%u threads)", threads);
+        bench_report(name, bench_now() - start, count);
+
+        int64_t sum = 0;
+        start = bench_now();
+        d_array_parallel_reduce(array, executor, 0, &sum, sizeof(sum), sum_cb, combine_cb);
+        snprintf(name, sizeof(name), "parallel_reduce (%u threads)", threads);
+        bench_report(name, bench_now() - start, count);
+
+        start = bench_now();
+        d_array_parallel_sort(array, executor);
+        double seconds = bench_now() - start;
+        snprintf(name, sizeof(name), "parallel_sort (%u threads)", threads);
+        bench_report(name, seconds, count);
+        printf("%-44s %10.2fx\n", "  speedup over serial stable sort", serial_sort / seconds);
+
+        cerb_executor_destroy(&executor);
+    }
+
+    free(array->data);
+    free(array);
+    free(values);
+
+    return 0;
+}
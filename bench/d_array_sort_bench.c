@@ -0,0 +1,102 @@
+#include <string.h>
+#include "bench.h"
+#include "../src/d_array_sort.h"
+
+// compares ints behind pointers, as default compare of d_array does
+static int int_cmp(const void *const restrict data1, const void *const restrict data2)
+{
+    int a = *(const int *) data1, b = *(const int *) data2;
+    return (a > b) - (a < b);
+}
+
+// qsort works on slots, so it gets pointers to pointers
+static int qsort_cmp(const void *slot1, const void *slot2)
+{
+    return int_cmp(*(void *const *) slot1, *(void *const *) slot2);
+}
+
+static uint64_t int_key(const void *data)
+{
+    return D_ARRAY_SIGNED_KEY(*(const int *) data);
+}
+
+// fill array with pointers to values in their original order
+static void reset(d_array *array, int *values, uint32_t count)
+{
+    uint32_t i;
+    for (i = 0; i < count; i++) array->data[i] = &values[i];
+    array->length = count;
+}
+
+// run every kernel on values laid out by pattern
+static void run(const char *pattern, d_array *array, int *values, uint32_t count)
+{
+    char name[64];
+    double start;
+
+    printf("--- %s, %u elements\n", pattern, count);
+
+    reset(array, values, count);
+    start = bench_now();
+    qsort(array->data, count, sizeof(void *), qsort_cmp);
+    bench_report("qsort", bench_now() - start, count);
+
+    reset(array, values, count);
+    start = bench_now();
+    d_array_sort(array);
+    bench_report("d_array_sort", bench_now() - start, count);
+
+    reset(array, values, count);
+    start = bench_now();
+    d_array_stable_sort(array);
+    bench_report("d_array_stable_sort", bench_now() - start, count);
+
+    reset(array, values, count);
+    start = bench_now();
+    d_array_radix_sort(array, int_key);
+    bench_report("d_array_radix_sort", bench_now() - start, count);
+
+    reset(array, values, count);
+    start = bench_now();
+    d_array_nth_element(array, count / 2);
+    bench_report("d_array_nth_element (median)", bench_now() - start, count);
+
+    reset(array, values, count);
+    start = bench_now();
+    d_array_partial_sort(array, 100);
+    snprintf(name, sizeof(name), "d_array_partial_sort (top %d)", 100);
+    bench_report(name, bench_now() - start, count);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t count = (uint32_t) bench_count(argc, argv, 10000000), i;
+    uint64_t state = 88172645463325252ULL;
+
+    int *values = malloc(sizeof(int) * count);
+    d_array *array = d_array_create(NULL, count);
+    if (!values || !array || count < 200) {
+        fprintf(stderr, "Failed to set up benchmark (count has to be at least 200).\n");
+        return 1;
+    }
+    array->compare = int_cmp;
+
+    for (i = 0; i < count; i++) values[i] = (int) bench_random(&state);
+    run("random", array, values, count);
+
+    for (i = 0; i < count; i++) values[i] = (int) (bench_random(&state) % 100);
+    run("random, 100 distinct keys", array, values, count);
+
+    for (i = 0; i < count; i++) values[i] = i;
+    run("sorted", array, values, count);
+
+    for (i = 0; i < count; i++) values[i] = count - i;
+    run("reversed", array, values, count);
+
+    array->length = 0;
+    free(array->data);
+    free(array);
+    free(values);
+
+    return 0;
+}
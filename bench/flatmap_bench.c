@@ -0,0 +1,72 @@
+#include "bench.h"
+#include "../src/flatmap.h"
+#include "../src/binary_search_tree.h"
+
+static void nodealloc(void *data)
+{
+    (void) data;
+}
+
+// ordered lookups: BS_tree (node per element) against cerb_flatmap (sorted array)
+int main(int argc, char *argv[])
+{
+    uint32_t count = (uint32_t) bench_count(argc, argv, 1000000), i;
+    uint32_t lookups = count * 4;
+    uint64_t state = 88172645463325252ULL;
+    uint64_t found = 0;
+    double start;
+
+    int *values = malloc(sizeof(int) * count);
+    int *keys = malloc(sizeof(int) * lookups);
+    void **pointers = malloc(sizeof(void *) * count);
+    BS_tree *tree = BS_tree_create(NULL);
+    cerb_flatmap *flat = cerb_flatmap_create(NULL, 0);
+    if (!values || !keys || !pointers || !tree || !flat) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+    // distinct keys in random order (BS_tree doesn't take duplicates)
+    for (i = 0; i < count; i++) values[i] = (int) i;
+    for (i = count - 1; i > 0; i--) {
+        uint32_t j = (uint32_t) (bench_random(&state) % (i + 1));
+        int temp = values[i];
+        values[i] = values[j];
+        values[j] = temp;
+    }
+    for (i = 0; i < count; i++) pointers[i] = &values[i];
+    for (i = 0; i < lookups; i++) keys[i] = values[bench_random(&state) % count];
+
+    printf("--- %u elements, %u lookups\n", count, lookups);
+
+    start = bench_now();
+    for (i = 0; i < count; i++) BS_tree_insert(tree, &values[i]);
+    bench_report("BS_tree_insert", bench_now() - start, count);
+
+    start = bench_now();
+    cerb_flatmap_insert_batch(flat, pointers, count);
+    bench_report("cerb_flatmap_insert_batch", bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < lookups; i++) found += BS_tree_search(tree, &keys[i]) != NULL;
+    bench_report("BS_tree_search", bench_now() - start, lookups);
+
+    start = bench_now();
+    for (i = 0; i < lookups; i++) found += cerb_flatmap_search(flat, &keys[i]) != NULL;
+    bench_report("cerb_flatmap_search", bench_now() - start, lookups);
+
+    start = bench_now();
+    for (i = 0; i < lookups; i++) found += cerb_flatmap_lower_bound(flat, &keys[i]);
+    bench_report("cerb_flatmap_lower_bound", bench_now() - start, lookups);
+
+    printf("memory: BS_tree %.1f MB, cerb_flatmap %.1f MB (found %llu)\n",
+           count * (double) sizeof(BS_tree_node) / 1e6, d_array_capacity(flat->items) * (double) sizeof(void *) / 1e6,
+           (unsigned long long) found);
+
+    BS_tree_destroy(&tree, nodealloc);
+    cerb_flatmap_destroy(&flat, nodealloc);
+    free(pointers);
+    free(keys);
+    free(values);
+
+    return 0;
+}
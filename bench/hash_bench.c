@@ -0,0 +1,63 @@
+#include <string.h>
+#include "bench.h"
+#include "../src/hashmap.h"
+
+// previous default hash of Hashmap (strlen and fnv1a byte at a time), kept here for comparison
+static uint32_t fnv1a(void *data)
+{
+    uint32_t hash = 2166136261u;
+
+    int i = 0, len = strlen((char *) data);
+    for (i = 0; i < len; i++) {
+        hash ^= i < len ? ((char *) data)[i] : 0;
+        hash *= 16777619;
+    }
+
+    return hash;
+}
+
+// usage: hash_bench [number of keys hashed per length]
+int main(int argc, char *argv[])
+{
+    uint32_t count = (uint32_t) bench_count(argc, argv, 1000000), i;
+    size_t lengths[] = {8, 16, 32, 64, 100, 256, 1024}, l;
+    uint64_t state = 88172645463325252ULL, sink = 0;
+    char name[64];
+
+    char *keys = malloc(16 * 1025); // 16 different keys of every length, so that it isn't one key over and over
+    if (!keys) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+
+    printf("--- %u keys per length, ns are per key\n", count);
+
+    for (l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t length = lengths[l], k;
+        for (k = 0; k < 16; k++) {
+            char *key = keys + k * 1025;
+            for (i = 0; i < length; i++) key[i] = 'a' + bench_random(&state) % 26;
+            key[length] = '\0';
+        }
+
+        double start = bench_now();
+        for (i = 0; i < count; i++) sink += fnv1a(keys + (i & 15) * 1025);
+        snprintf(name, sizeof(name), "fnv1a, strlen (%zu bytes)", length);
+        bench_report(name, bench_now() - start, count);
+
+        start = bench_now();
+        for (i = 0; i < count; i++) sink += Hashmap_hash_string(keys + (i & 15) * 1025, i);
+        snprintf(name, sizeof(name), "Hashmap_hash_string (%zu bytes)", length);
+        bench_report(name, bench_now() - start, count);
+
+        start = bench_now();
+        for (i = 0; i < count; i++) sink += Hashmap_hash_bytes(keys + (i & 15) * 1025, length, i);
+        snprintf(name, sizeof(name), "Hashmap_hash_bytes (%zu bytes)", length);
+        bench_report(name, bench_now() - start, count);
+    }
+
+    printf("sink: %llu\n", (unsigned long long) sink);
+    free(keys);
+
+    return 0;
+}
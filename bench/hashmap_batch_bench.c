@@ -0,0 +1,113 @@
+#include "bench.h"
+#include "../src/hashmap.h"
+
+#define KEYS_PER_CALL 256 // keys handed to every _batch call (join probing a few hundred keys at once)
+
+static uint32_t int_hash(void *data)
+{
+    // murmur3 finalizer
+    uint32_t hash = (uint32_t) *(int *) data;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static void nodealloc(void *data)
+{
+    (void) data;
+}
+
+// insert count values one by one and in batches, then look all of them up (in random order) both ways. returns hits
+static uint64_t run(const Hashmap_config *config, void **data, void **keys, void **found, uint32_t count,
+                    const char *engine)
+{
+    Hashmap *single = Hashmap_create_with_config(config);
+    Hashmap *batched = Hashmap_create_with_config(config);
+    uint64_t hits = 0;
+    uint32_t i;
+    char name[64];
+
+    if (!single || !batched) {
+        fprintf(stderr, "Failed to create maps.\n");
+        exit(1);
+    }
+
+    double start = bench_now();
+    for (i = 0; i < count; i++) Hashmap_insert(single, data[i]);
+    snprintf(name, sizeof(name), "%s insert", engine);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i += KEYS_PER_CALL) {
+        Hashmap_insert_batch(batched, data + i, count - i < KEYS_PER_CALL ? count - i : KEYS_PER_CALL);
+    }
+    snprintf(name, sizeof(name), "%s insert_batch", engine);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i++) hits += Hashmap_find(single, keys[i]) != NULL;
+    snprintf(name, sizeof(name), "%s find", engine);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i += KEYS_PER_CALL) {
+        uint32_t batch = count - i < KEYS_PER_CALL ? count - i : KEYS_PER_CALL, j;
+        Hashmap_find_batch(batched, keys + i, batch, found);
+        for (j = 0; j < batch; j++) hits += found[j] != NULL;
+    }
+    snprintf(name, sizeof(name), "%s find_batch", engine);
+    bench_report(name, bench_now() - start, count);
+
+    Hashmap_destroy(&single, nodealloc);
+    Hashmap_destroy(&batched, nodealloc);
+
+    return hits;
+}
+
+// usage: hashmap_batch_bench [number of keys], default map is a few hundred MB, far bigger than last level cache
+int main(int argc, char *argv[])
+{
+    uint32_t count = (uint32_t) bench_count(argc, argv, 1 << 22), i;
+    uint64_t state = 88172645463325252ULL, hits = 0;
+
+    int *values = malloc(sizeof(int) * count);
+    void **data = malloc(sizeof(void *) * count);
+    void **keys = malloc(sizeof(void *) * count);
+    void **found = malloc(sizeof(void *) * KEYS_PER_CALL);
+    if (!values || !data || !keys || !found) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        values[i] = (int) i;
+        data[i] = &values[i];
+        keys[i] = &values[i];
+    }
+    // lookups go in random order, so that they don't follow insertion order through memory
+    for (i = count - 1; i > 0; i--) {
+        uint32_t j = bench_random(&state) % (i + 1);
+        void *temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+
+    printf("--- %u keys, %u keys per _batch call\n", count, KEYS_PER_CALL);
+
+    // both maps are big enough from the start, growing isn't measured here
+    Hashmap_config chained = {NULL, int_hash, count, NULL, HASHMAP_CHAINED, 0, NULL, 0};
+    Hashmap_config robin_hood = {NULL, int_hash, count, NULL, HASHMAP_ROBIN_HOOD, 0, NULL, 0};
+    hits += run(&chained, data, keys, found, count, "chained");
+    hits += run(&robin_hood, data, keys, found, count, "robin hood");
+
+    printf("hits: %llu\n", (unsigned long long) hits);
+
+    free(values);
+    free(data);
+    free(keys);
+    free(found);
+
+    return 0;
+}
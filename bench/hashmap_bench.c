@@ -0,0 +1,185 @@
+#include "bench.h"
+#include "../src/hashmap.h"
+
+static uint32_t int_hash(void *data)
+{
+    // murmur3 finalizer, so that both engines get well spread hashes
+    uint32_t hash = (uint32_t) *(int *) data;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static void nodealloc(void *data)
+{
+    (void) data;
+}
+
+// insert count values, find all of them and as many missing keys, then remove half. returns hits
+static uint64_t run(Hashmap *map, int *values, int *order, uint32_t count, const char *engine, uint32_t load)
+{
+    uint64_t hits = 0;
+    uint32_t i;
+    char name[64];
+    int key;
+
+    double start = bench_now();
+    for (i = 0; i < count; i++) Hashmap_insert(map, &values[i]);
+    snprintf(name, sizeof(name), "%s insert (load %u%%)", engine, load);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i++) hits += Hashmap_find(map, &values[order[i]]) != NULL;
+    snprintf(name, sizeof(name), "%s find hit (load %u%%)", engine, load);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i++) {
+        key = values[order[i]] + 1; // values are odd, so even keys are never there
+        hits += Hashmap_find(map, &key) != NULL;
+    }
+    snprintf(name, sizeof(name), "%s find miss (load %u%%)", engine, load);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count / 2; i++) hits += Hashmap_remove(map, &values[order[i]]) != NULL;
+    snprintf(name, sizeof(name), "%s remove (load %u%%)", engine, load);
+    bench_report(name, bench_now() - start, count / 2);
+
+    return hits;
+}
+
+// random permutation of [0, count), lookups go in this order so that they don't follow insertion order through memory
+static void shuffle(int *order, uint32_t count, uint64_t *state)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) order[i] = (int) i;
+    for (i = count - 1; i > 0; i--) {
+        uint32_t j = bench_random(state) % (i + 1);
+        int temp = order[i];
+        order[i] = order[j];
+        order[j] = temp;
+    }
+}
+
+// usage: hashmap_bench [table capacity (rounded up to power of 2)]
+int main(int argc, char *argv[])
+{
+    uint64_t requested = bench_count(argc, argv, 1 << 20), state = 88172645463325252ULL, hits = 0;
+    uint32_t capacity = 8, loads[] = {50, 60, 70, 80, 90}, i, l;
+
+    while (capacity < requested) capacity *= 2;
+
+    int *values = malloc(sizeof(int) * capacity);
+    int *order = malloc(sizeof(int) * capacity);
+    if (!values || !order) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+    for (i = 0; i < capacity; i++) values[i] = (int) (bench_random(&state) >> 34) * 2 + 1;
+
+    printf("--- %u buckets / slots, load is elements per bucket / slot\n", capacity);
+
+    for (l = 0; l < sizeof(loads) / sizeof(loads[0]); l++) {
+        uint32_t count = (uint32_t) ((uint64_t) capacity * loads[l] / 100);
+        shuffle(order, count, &state);
+
+        Hashmap *chained = Hashmap_create(NULL, int_hash, capacity);
+        // table of exactly capacity slots, which doesn't grow at any of the loads
+        Hashmap_config config = {NULL, int_hash, (cerb_size_t) ((uint64_t) capacity * 95 / 100), NULL,
+                                 HASHMAP_ROBIN_HOOD, 95, NULL, 0};
+        Hashmap *robin_hood = Hashmap_create_with_config(&config);
+        if (!chained || !robin_hood) {
+            fprintf(stderr, "Failed to create maps.\n");
+            return 1;
+        }
+
+        hits += run(chained, values, order, count, "chained", loads[l]);
+        hits += run(robin_hood, values, order, count, "robin hood", loads[l]);
+
+        Hashmap_destroy(&chained, nodealloc);
+        Hashmap_destroy(&robin_hood, nodealloc);
+    }
+
+    // growing from a few buckets: chained map rehashes incrementally, robin hood table all at once
+    printf("--- growing to %u elements, worst single insert\n", capacity);
+    Hashmap_config configs[] = {{NULL, int_hash, 8, NULL, HASHMAP_CHAINED, 0, NULL, 0},
+                                {NULL, int_hash, 8, NULL, HASHMAP_ROBIN_HOOD, 0, NULL, 0}};
+    const char *engines[] = {"chained", "robin hood"};
+    for (l = 0; l < 2; l++) {
+        Hashmap *growing = Hashmap_create_with_config(&configs[l]);
+        double worst = 0, start = bench_now();
+        for (i = 0; i < capacity; i++) {
+            double before = bench_now();
+            Hashmap_insert(growing, &values[i]);
+            double took = bench_now() - before;
+            if (took > worst) worst = took;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "%s growing insert", engines[l]);
+        bench_report(name, bench_now() - start, capacity);
+        printf("%-44s %10.3f ms\n", "  worst insert", worst * 1e3);
+        Hashmap_destroy(&growing, nodealloc);
+    }
+
+    // dedup of keys which repeat: find then insert hashes and probes twice, get_or_insert once
+    printf("--- dedup of %u keys, half of them repeated\n", capacity);
+    for (l = 0; l < 2; l++) {
+        Hashmap *twice = Hashmap_create_with_config(&configs[l]);
+        Hashmap *once = Hashmap_create_with_config(&configs[l]);
+        char name[64];
+
+        double start = bench_now();
+        for (i = 0; i < capacity; i++) {
+            int *value = &values[(i & 1) ? i / 4 : i / 2]; // odd ones repeat earlier keys
+            if (!Hashmap_find(twice, value)) Hashmap_insert(twice, value);
+        }
+        snprintf(name, sizeof(name), "%s find + insert", engines[l]);
+        bench_report(name, bench_now() - start, capacity);
+
+        start = bench_now();
+        for (i = 0; i < capacity; i++) {
+            int *value = &values[(i & 1) ? i / 4 : i / 2]; // odd ones repeat earlier keys
+            Hashmap_get_or_insert(once, value, value);
+        }
+        snprintf(name, sizeof(name), "%s get_or_insert", engines[l]);
+        bench_report(name, bench_now() - start, capacity);
+
+        hits += Hashmap_length(twice) + Hashmap_length(once);
+        Hashmap_destroy(&twice, nodealloc);
+        Hashmap_destroy(&once, nodealloc);
+    }
+
+    // churn: remove random key and insert it back, map size stays the same (nodes are reused by chained map)
+    printf("--- churn of %u elements\n", capacity / 2);
+    for (l = 0; l < 2; l++) {
+        Hashmap *churned = Hashmap_create_with_config(&configs[l]);
+        char name[64];
+
+        for (i = 0; i < capacity / 2; i++) Hashmap_insert(churned, &values[i]);
+        double start = bench_now();
+        for (i = 0; i < capacity; i++) {
+            int *value = &values[bench_random(&state) % (capacity / 2)];
+            hits += Hashmap_remove(churned, value) != NULL;
+            Hashmap_insert(churned, value);
+        }
+        snprintf(name, sizeof(name), "%s remove + insert", engines[l]);
+        bench_report(name, bench_now() - start, capacity);
+
+        start = bench_now();
+        Hashmap_destroy(&churned, nodealloc);
+        snprintf(name, sizeof(name), "%s destroy", engines[l]);
+        bench_report(name, bench_now() - start, capacity / 2);
+    }
+
+    printf("hits: %llu\n", (unsigned long long) hits);
+
+    free(values);
+    free(order);
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "bench.h"
+#include "../src/hashmap.h"
+#include "../src/hashmap_frozen.h"
+
+static uint32_t int_hash(void *data)
+{
+    // murmur3 finalizer (one to one, so that different ints never get equal hashes)
+    uint32_t hash = (uint32_t) *(int *) data;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// freeze map of count keys, then look every key up (in random order) in map and in snapshot. returns hits
+static uint64_t run(int *values, int **keys, uint32_t count)
+{
+    Hashmap_config config = {NULL, int_hash, count, NULL, HASHMAP_ROBIN_HOOD, 0, NULL, 0};
+    Hashmap *map = Hashmap_create_with_config(&config);
+    uint64_t hits = 0;
+    uint32_t i;
+    char name[64];
+    int key;
+
+    if (!map) {
+        fprintf(stderr, "Failed to create map.\n");
+        exit(1);
+    }
+    for (i = 0; i < count; i++) Hashmap_insert(map, &values[i]);
+
+    double start = bench_now();
+    Hashmap_frozen *frozen = Hashmap_freeze(map);
+    snprintf(name, sizeof(name), "freeze (%u keys)", count);
+    bench_report(name, bench_now() - start, count);
+    if (!frozen) {
+        fprintf(stderr, "Failed to freeze map.\n");
+        exit(1);
+    }
+
+    start = bench_now();
+    for (i = 0; i < count; i++) hits += Hashmap_find(map, keys[i]) != NULL;
+    snprintf(name, sizeof(name), "robin hood find hit (%u keys)", count);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i++) hits += Hashmap_frozen_find(frozen, keys[i]) != NULL;
+    snprintf(name, sizeof(name), "frozen find hit (%u keys)", count);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i++) {
+        key = -*keys[i] - 1; // values aren't negative, so these are never there
+        hits += Hashmap_frozen_find(frozen, &key) != NULL;
+    }
+    snprintf(name, sizeof(name), "frozen find miss (%u keys)", count);
+    bench_report(name, bench_now() - start, count);
+
+    printf("%-44s %10.2f bytes/key\n", "  robin hood memory", (double) Hashmap_memory_usage(map) / count);
+    printf("%-44s %10.2f bytes/key\n", "  frozen memory", (double) Hashmap_frozen_memory_usage(frozen) / count);
+
+    Hashmap_frozen_destroy(&frozen);
+    Hashmap_destroy(&map, NULL);
+
+    return hits;
+}
+
+// usage: hashmap_frozen_bench [max number of keys], keys go from 1M up to max by factors of 10 (100M takes
+// about 8 GB of memory, so default stops at 10M)
+int main(int argc, char *argv[])
+{
+    uint32_t max_count = (uint32_t) bench_count(argc, argv, 10000000), count, i;
+    uint64_t state = 88172645463325252ULL, hits = 0;
+
+    int *values = malloc(sizeof(int) * max_count);
+    int **keys = malloc(sizeof(int *) * max_count);
+    if (!values || !keys) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+    for (i = 0; i < max_count; i++) values[i] = (int) i;
+
+    for (count = 1000000; count <= max_count; count *= 10) {
+        // lookups go in random order, so that they don't follow insertion order through memory
+        for (i = 0; i < count; i++) keys[i] = &values[i];
+        for (i = count - 1; i > 0; i--) {
+            uint32_t j = bench_random(&state) % (i + 1);
+            int *temp = keys[i];
+            keys[i] = keys[j];
+            keys[j] = temp;
+        }
+
+        printf("--- %u keys\n", count);
+        hits += run(values, keys, count);
+        if (count > UINT32_MAX / 10) break;
+    }
+
+    printf("hits: %llu\n", (unsigned long long) hits);
+
+    free(values);
+    free(keys);
+
+    return 0;
+}
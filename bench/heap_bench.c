@@ -0,0 +1,106 @@
+#include "bench.h"
+#include "../src/priority_queue.h"
+
+#define BATCH 4096 // elements handed to every heap_insert_batch and heap_pop_n call
+
+static void nodealloc(void *data)
+{
+    (void) data;
+}
+
+// fill queue of given arity with count values, then pop and insert back one at a time (scheduler taking its next
+// job and scheduling another one), then drain it. same again in batches of BATCH. returns sum of popped values
+static uint64_t run(int *values, uint32_t count, uint8_t arity, uint64_t *state)
+{
+    priority_queue_config config = {NULL, count, NULL, arity};
+    priority_queue *queue = priority_queue_create_with_config(&config);
+    uint64_t sum = 0;
+    uint32_t i;
+    char name[64];
+
+    if (!queue) {
+        fprintf(stderr, "Failed to create queue.\n");
+        exit(1);
+    }
+
+    double start = bench_now();
+    for (i = 0; i < count; i++) priority_queue_insert(queue, &values[i]);
+    snprintf(name, sizeof(name), "%u-ary insert", arity);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i++) {
+        int *top = priority_queue_shift(queue);
+        sum += (uint32_t) *top;
+        *top = (int) (bench_random(state) % count); // same slot comes back with new priority
+        priority_queue_insert(queue, top);
+    }
+    snprintf(name, sizeof(name), "%u-ary pop + insert", arity);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    for (i = 0; i < count; i++) sum += (uint32_t) *(int *) priority_queue_shift(queue);
+    snprintf(name, sizeof(name), "%u-ary pop", arity);
+    bench_report(name, bench_now() - start, count);
+
+    void **pointers = malloc(sizeof(void *) * count);
+    d_array *out = d_array_create(NULL, BATCH);
+    if (!pointers || !out) {
+        fprintf(stderr, "Failed to set up batches.\n");
+        exit(1);
+    }
+    for (i = 0; i < count; i++) pointers[i] = &values[i];
+
+    start = bench_now();
+    for (i = 0; i < count; i += BATCH) heap_insert_batch(queue, pointers + i, count - i < BATCH ? count - i : BATCH);
+    snprintf(name, sizeof(name), "%u-ary insert_batch", arity);
+    bench_report(name, bench_now() - start, count);
+
+    start = bench_now();
+    while (d_array_length(queue)) {
+        out->length = 0;
+        heap_pop_n(queue, BATCH, out);
+        for (i = 0; i < d_array_length(out); i++) sum += (uint32_t) *(int *) out->data[i];
+    }
+    snprintf(name, sizeof(name), "%u-ary pop_n", arity);
+    bench_report(name, bench_now() - start, count);
+
+    free(pointers);
+    d_array_destroy(&out, nodealloc);
+
+    priority_queue_destroy(&queue, nodealloc);
+
+    return sum;
+}
+
+// usage: heap_bench [max number of elements], queues go from 1M up to max by factors of 10 (default 10M)
+int main(int argc, char *argv[])
+{
+    uint32_t max_count = (uint32_t) bench_count(argc, argv, 10000000), count, i;
+    uint64_t state = 88172645463325252ULL, sum = 0;
+    uint8_t arities[] = {2, 4, 8};
+    int a;
+
+    int *values = malloc(sizeof(int) * max_count);
+    if (!values) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+
+    for (count = 1000000; count <= max_count; count *= 10) {
+        printf("--- %u elements\n", count);
+        for (a = 0; a < 3; a++) {
+            // every arity gets the same random priorities
+            uint64_t seed = state + count;
+            for (i = 0; i < count; i++) values[i] = (int) (bench_random(&seed) % count);
+            sum += run(values, count, arities[a], &seed);
+        }
+        if (count > UINT32_MAX / 10) break;
+    }
+
+    printf("sum: %llu\n", (unsigned long long) sum);
+
+    free(values);
+
+    return 0;
+}
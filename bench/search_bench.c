@@ -0,0 +1,94 @@
+#include "bench.h"
+#include "../src/d_array.h"
+#include "../src/hashmap.h"
+#include "../src/simd_search.h"
+
+static const char *level_names[] = {"scalar", "sse2", "avx2"};
+
+static uint32_t int_hash(void *data)
+{
+    return (uint32_t) *(int *) data;
+}
+
+static void nodealloc(void *data)
+{
+    (void) data;
+}
+
+// search every mode for keys spread over array, returns number of hits so that nothing is optimized out
+static uint64_t run_array(d_array *array, int *values, uint32_t count, uint32_t searches, uint8_t mode, const char *name)
+{
+    uint64_t state = 2463534242ULL, hits = 0;
+    uint32_t i;
+
+    d_array_set_search_mode(array, mode);
+
+    double start = bench_now();
+    for (i = 0; i < searches; i++) {
+        hits += d_array_index_of(array, &values[bench_random(&state) % count]) >= 0;
+    }
+    bench_report(name, bench_now() - start, (uint64_t) searches * count / 2); // ns per element scanned
+
+    return hits;
+}
+
+// usage: search_bench [elements scanned per search]
+int main(int argc, char *argv[])
+{
+    uint32_t count = (uint32_t) bench_count(argc, argv, 1024), i;
+    uint32_t searches = 20000000 / count + 1;
+    uint64_t state = 88172645463325252ULL, hits = 0;
+    char name[64];
+    int level;
+
+    int *values = malloc(sizeof(int) * count);
+    d_array *array = d_array_create(NULL, count);
+    // one bucket which never grows, so that Hashmap_find scans all of it
+    Hashmap_config config = {NULL, int_hash, 1, NULL, HASHMAP_CHAINED, HASHMAP_FIXED_SIZE, NULL, 0};
+    Hashmap *map = Hashmap_create_with_config(&config);
+    if (!values || !array || !map) {
+        fprintf(stderr, "Failed to set up benchmark.\n");
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        values[i] = (int) i;
+        d_array_push_back(array, &values[i]);
+        Hashmap_insert(map, &values[i]);
+    }
+
+    printf("--- %u elements, %u searches, ns are per element scanned\n", count, searches);
+
+    hits += run_array(array, values, count, searches, D_ARRAY_SEARCH_CALLBACK, "d_array_index_of (callback)");
+    for (level = cerb_simd_set_level(CERB_SIMD_AVX2); level >= CERB_SIMD_SCALAR; level--) {
+        cerb_simd_set_level(level);
+        snprintf(name, sizeof(name), "d_array_index_of (identity, %s)", level_names[level]);
+        hits += run_array(array, values, count, searches, D_ARRAY_SEARCH_IDENTITY, name);
+        snprintf(name, sizeof(name), "d_array_index_of (int, %s)", level_names[level]);
+        hits += run_array(array, values, count, searches, D_ARRAY_SEARCH_INT, name);
+    }
+
+    uint8_t modes[] = {HASHMAP_SEARCH_CALLBACK, HASHMAP_SEARCH_IDENTITY, HASHMAP_SEARCH_INT};
+    const char *mode_names[] = {"callback", "identity", "int"};
+    for (level = cerb_simd_set_level(CERB_SIMD_AVX2); level >= CERB_SIMD_SCALAR; level--) {
+        cerb_simd_set_level(level);
+        for (i = 0; i < 3; i++) {
+            if (modes[i] == HASHMAP_SEARCH_CALLBACK && level != CERB_SIMD_SCALAR) continue; // callback has no levels
+            Hashmap_set_search_mode(map, modes[i]);
+            double start = bench_now();
+            uint32_t j;
+            for (j = 0; j < searches; j++) {
+                hits += Hashmap_find(map, &values[bench_random(&state) % count]) != NULL;
+            }
+            snprintf(name, sizeof(name), "Hashmap_find (%s, %s)", mode_names[i], level_names[level]);
+            bench_report(name, bench_now() - start, (uint64_t) searches * count / 2);
+        }
+    }
+
+    printf("hits: %llu\n", (unsigned long long) hits);
+
+    Hashmap_destroy(&map, nodealloc);
+    d_array_destroy(&array, nodealloc);
+    free(values);
+
+    return 0;
+}
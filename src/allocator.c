@@ -0,0 +1,70 @@
+#include <stdlib.h>
+#include "allocator.h"
+
+static void *libc_alloc(void *context, size_t size)
+{
+    (void) context;
+    return malloc(size);
+}
+
+static void *libc_realloc(void *context, void *ptr, size_t old_size, size_t new_size)
+{
+    (void) context;
+    (void) old_size;
+    return realloc(ptr, new_size);
+}
+
+static void libc_free(void *context, void *ptr, size_t size)
+{
+    (void) context;
+    (void) size;
+    free(ptr);
+}
+
+const cerb_allocator cerb_libc_allocator = {libc_alloc, libc_realloc, libc_free, NULL};
+
+static void *counting_alloc(void *context, size_t size)
+{
+    cerb_counting_allocator *counter = context;
+    void *ptr = cerb_alloc(counter->parent, size);
+
+    if (ptr) {
+        __atomic_fetch_add(&counter->allocations, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&counter->bytes_allocated, size, __ATOMIC_RELAXED);
+    }
+    return ptr;
+}
+
+static void *counting_realloc(void *context, void *ptr, size_t old_size, size_t new_size)
+{
+    cerb_counting_allocator *counter = context;
+    void *new_ptr = cerb_realloc(counter->parent, ptr, old_size, new_size);
+
+    if (new_ptr) {
+        __atomic_fetch_add(&counter->reallocations, 1, __ATOMIC_RELAXED);
+        if (new_size > old_size) __atomic_fetch_add(&counter->bytes_allocated, new_size - old_size, __ATOMIC_RELAXED);
+        else __atomic_fetch_add(&counter->bytes_freed, old_size - new_size, __ATOMIC_RELAXED);
+    }
+    return new_ptr;
+}
+
+static void counting_free(void *context, void *ptr, size_t size)
+{
+    cerb_counting_allocator *counter = context;
+
+    cerb_free(counter->parent, ptr, size);
+    __atomic_fetch_add(&counter->frees, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counter->bytes_freed, size, __ATOMIC_RELAXED);
+}
+
+// set counter up on top of parent
+void cerb_counting_allocator_init(cerb_counting_allocator *counter, const cerb_allocator *parent)
+{
+    memset(counter, 0, sizeof(cerb_counting_allocator));
+
+    counter->parent = cerb_allocator_or_default(parent);
+    counter->allocator.alloc = counting_alloc;
+    counter->allocator.realloc = counting_realloc;
+    counter->allocator.free = counting_free;
+    counter->allocator.context = counter;
+}
@@ -0,0 +1,80 @@
+#ifndef C5F0A8D3_9B14_4E7A_B2C6_3A1E7D9F0C52
+#define C5F0A8D3_9B14_4E7A_B2C6_3A1E7D9F0C52
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// allocator every container allocates its internal memory (structs, nodes, data blocks, scratch buffers) with.
+// pass it to *_create_with_allocator functions, NULL means cerb_libc_allocator (plain malloc/realloc/free).
+// container keeps pointer to allocator, so allocator has to outlive it. data you store in containers is yours,
+// library never allocates or frees it with allocator (dealloc callbacks get it as before).
+// old size is passed to realloc and free, so that pools and bump allocators don't need headers
+
+// allocate size bytes (size can be 0, return NULL only on failure then)
+typedef void *(*cerb_alloc_fn) (void *context, size_t size);
+// resize block of old_size bytes (ptr can be NULL), return NULL on failure and leave block as it was
+typedef void *(*cerb_realloc_fn) (void *context, void *ptr, size_t old_size, size_t new_size);
+// free block of size bytes (ptr is never NULL)
+typedef void (*cerb_free_fn) (void *context, void *ptr, size_t size);
+
+typedef struct cerb_allocator {
+    cerb_alloc_fn alloc; // required
+    cerb_realloc_fn realloc; // optional, if NULL alloc + copy + free is used
+    cerb_free_fn free; // optional, if NULL memory is never freed (arenas and bump allocators)
+    void *context; // passed to every callback as first argument
+} cerb_allocator;
+
+// malloc, realloc and free from libc
+extern const cerb_allocator cerb_libc_allocator;
+
+// allocator_ptr or cerb_libc_allocator if it is NULL
+#define cerb_allocator_or_default(allocator_ptr) ((allocator_ptr) ? (allocator_ptr) : &cerb_libc_allocator)
+
+static inline void *cerb_alloc(const cerb_allocator *allocator, size_t size)
+{
+    return allocator->alloc(allocator->context, size);
+}
+
+static inline void *cerb_calloc(const cerb_allocator *allocator, size_t size)
+{
+    void *ptr = allocator->alloc(allocator->context, size);
+    if (ptr) memset(ptr, 0, size);
+    return ptr;
+}
+
+static inline void cerb_free(const cerb_allocator *allocator, void *ptr, size_t size)
+{
+    if (ptr && allocator->free) allocator->free(allocator->context, ptr, size);
+}
+
+static inline void *cerb_realloc(const cerb_allocator *allocator, void *ptr, size_t old_size, size_t new_size)
+{
+    if (allocator->realloc) return allocator->realloc(allocator->context, ptr, old_size, new_size);
+
+    void *new_ptr = allocator->alloc(allocator->context, new_size);
+    if (new_ptr && ptr) {
+        memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+        cerb_free(allocator, ptr, old_size);
+    }
+    return new_ptr;
+}
+
+// allocator which counts traffic of another one (measure what each container allocates by giving it its own counter)
+typedef struct cerb_counting_allocator {
+    cerb_allocator allocator; // pass &counter->allocator to containers
+    const cerb_allocator *parent; // allocator which really allocates
+    uint64_t allocations; // number of alloc calls
+    uint64_t reallocations; // number of realloc calls
+    uint64_t frees; // number of free calls
+    uint64_t bytes_allocated; // total bytes ever allocated (realloc counts growth only)
+    uint64_t bytes_freed; // total bytes ever freed (realloc counts shrinking only)
+} cerb_counting_allocator;
+
+// bytes counted allocator holds right now
+#define cerb_counting_allocator_in_use(counter_ptr) ((counter_ptr)->bytes_allocated - (counter_ptr)->bytes_freed)
+
+// set counter up on top of parent (NULL means cerb_libc_allocator), counters are updated atomically
+void cerb_counting_allocator_init(cerb_counting_allocator *counter, const cerb_allocator *parent);
+
+#endif /* C5F0A8D3_9B14_4E7A_B2C6_3A1E7D9F0C52 */
@@ -17,9 +17,19 @@ static int default_compare(const void *const restrict data1, const void *const r
 // create a binary search tree
 BS_tree *BS_tree_create(BS_tree_cmp compare)
 {
-    BS_tree *tree = malloc(sizeof(BS_tree));
+    return BS_tree_create_with_allocator(compare, NULL);
+}
+
+// create a binary search tree on top of allocator
+BS_tree *BS_tree_create_with_allocator(BS_tree_cmp compare, const cerb_allocator *allocator)
+{
+    allocator = cerb_allocator_or_default(allocator);
+
+    BS_tree *tree = cerb_alloc(allocator, sizeof(BS_tree));
     check_mem(tree); // allocate memory for tree
 
+    tree->allocator = allocator;
+
     tree->compare = compare == NULL ? default_compare : compare; // set default compare if one isn't provided
     tree->length = 0;
     tree->root = NULL;
@@ -31,9 +41,9 @@ error:
 }
 
 // internally used to create binary search tree nodes
-static inline BS_tree_node *BS_tree_node_create()
+static inline BS_tree_node *BS_tree_node_create(BS_tree *tree)
 {
-    BS_tree_node *node = calloc(1, sizeof(BS_tree_node));
+    BS_tree_node *node = cerb_calloc(tree->allocator, sizeof(BS_tree_node));
     check_mem(node); // allocate data to binary search tree node and check
 
     return node;
@@ -47,9 +57,9 @@ int BS_tree_insert(BS_tree *tree, void *data)
 {
     check(tree != NULL, "tree is NULL.");
     check(data != NULL, "data is NULL.");
-    check(BS_tree_length(tree) != UINT32_MAX, "tree has reached it's max length AKA UINT32_MAX.");
+    check(BS_tree_length(tree) != CERB_SIZE_MAX, "tree has reached it's max length AKA CERB_SIZE_MAX.");
 
-    BS_tree_node *node = BS_tree_node_create();
+    BS_tree_node *node = BS_tree_node_create(tree);
     check(node != NULL, "Failed to insert in tree.");
     node->data = data; // assign data to node we just created
 
@@ -83,7 +93,7 @@ int BS_tree_insert(BS_tree *tree, void *data)
                     break;
                 case BSTREE_EQUAL:
                     log_err("tree already contains data pointed by this ptr -> %p", data);
-                    free(node); // free node which was allocated for data (since we aren't inserting it)
+                    cerb_free(tree->allocator, node, sizeof(BS_tree_node)); // free node which was allocated for data (since we aren't inserting it)
                     return CERB_ERR; // we don't allow duplicate entries
                 default:
                     return CERB_ERR; // default won't run
@@ -217,7 +227,7 @@ void *BS_tree_change(BS_tree *tree, BS_tree_node *cur_node)
         }
     }
     void *data = cur_node->data; // save data before access becomes UB
-    free(cur_node); // deallocate node
+    cerb_free(tree->allocator, cur_node, sizeof(BS_tree_node)); // deallocate node
     tree->length--; // decrease length
     return data; // return data
 }
@@ -322,7 +332,7 @@ int BS_tree_traverse(BS_tree *tree, int order, BS_tree_traverse_cb traverse_cb)
 
     // if level order traversal is requested we do it in traverse_LOT function
     if (order == BSTREE_LEVELORDER) {
-        Queue *queue = Queue_create(tree->compare); // create queue to order the level of tree
+        Queue *queue = Queue_create_with_allocator(tree->compare, tree->allocator); // create queue to order the level of tree
         check(queue != NULL, "Out of memory on level order traversal."); // check to see if have queue
         rc = traverse_LOT(queue, start, traverse_cb); // do the traversal
         Queue_destroy(&queue, nofree_cb); // destroy the queue
@@ -339,13 +349,13 @@ error:
 }
 
 // internally used to recurse through tree and deallocate the data it holds
-static inline void postorder_free(BS_tree_node *node, BS_tree_dealloc dealloc_cb)
+static inline void postorder_free(BS_tree *tree, BS_tree_node *node, BS_tree_dealloc dealloc_cb)
 {
     // if left and right exist free in that case, otherwise do not
-    if (node->left) postorder_free(node->left, dealloc_cb);
-    if (node->right) postorder_free(node->right, dealloc_cb);
+    if (node->left) postorder_free(tree, node->left, dealloc_cb);
+    if (node->right) postorder_free(tree, node->right, dealloc_cb);
     dealloc_cb(node->data); // call callback to free data
-    free(node); // free node allocated internally
+    cerb_free(tree->allocator, node, sizeof(BS_tree_node)); // free node allocated internally
 }
 
 // deallocate a whole binary search tree and set it's reference to NULL on stack (you need to provide address of tree)
@@ -356,8 +366,8 @@ int BS_tree_destroy(BS_tree **tree, BS_tree_dealloc dealloc_cb)
     check(dealloc_cb != NULL, "dealloc_cb is NULL.");
 
     // if tree isn't empty deallocate it's elements
-    if (BS_tree_length(*tree)) postorder_free((*tree)->root, dealloc_cb);
-    free(*tree); // free tree structure itself
+    if (BS_tree_length(*tree)) postorder_free(*tree, (*tree)->root, dealloc_cb);
+    cerb_free((*tree)->allocator, *tree, sizeof(BS_tree)); // free tree structure itself
 
     *tree = NULL; // set stack reference to NULL
 
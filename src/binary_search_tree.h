@@ -2,6 +2,8 @@
 #define F43451C3_8F17_49D8_9CE6_1B898625E8FB
 
 #include <stdint.h>
+#include "cerb_size.h"
+#include "allocator.h"
 #include <stdio.h>
 
 #define CERB_OK  0
@@ -31,12 +33,15 @@ typedef int (*BS_tree_cmp) (const void *const restrict data1, const void *const
 typedef struct binary_search_tree {
     BS_tree_node *root; // root node of the tree
     BS_tree_cmp compare; // compare callback
-    uint32_t length; // count of elements currently present in a tree
+    const cerb_allocator *allocator; // allocator of struct and nodes (see allocator.h)
+    cerb_size_t length; // count of elements currently present in a tree
 } BS_tree;
 
 
 // create a binary search tree
 BS_tree *BS_tree_create(BS_tree_cmp compare);
+// create a binary search tree which allocates struct and nodes with allocator (NULL means cerb_libc_allocator)
+BS_tree *BS_tree_create_with_allocator(BS_tree_cmp compare, const cerb_allocator *allocator);
 
 // insert data in tree
 int BS_tree_insert(BS_tree *tree, void *data);
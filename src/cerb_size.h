@@ -0,0 +1,23 @@
+#ifndef B1D7F3A9_8E2C_4C65_9A4B_7E0D6F2C1B38
+#define B1D7F3A9_8E2C_4C65_9A4B_7E0D6F2C1B38
+
+#include <stdint.h>
+
+// type of every length, capacity, count and position in the library. it is 32-bit by default, which keeps
+// structs and growth math compact. build library (and your code which uses it) with -DCERB_SIZE_64
+// (make OPTFLAGS=-DCERB_SIZE_64) for containers of more than 4G elements. both have to agree on it,
+// because sizes of structs depend on it
+
+#ifdef CERB_SIZE_64
+typedef uint64_t cerb_size_t;
+#define CERB_SIZE_MAX UINT64_MAX
+// 64-bit sizes can't overflow on any real memory, so this check is compiled out
+#define CERB_SIZE_FITS(wide_size) 1
+#else
+typedef uint32_t cerb_size_t;
+#define CERB_SIZE_MAX UINT32_MAX
+// check that size calculated in 64 bits still fits cerb_size_t
+#define CERB_SIZE_FITS(wide_size) ((uint64_t) (wide_size) <= UINT32_MAX)
+#endif
+
+#endif /* B1D7F3A9_8E2C_4C65_9A4B_7E0D6F2C1B38 */
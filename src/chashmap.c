@@ -0,0 +1,407 @@
+#include <stdlib.h>
+#include <sched.h>
+#include "chashmap.h"
+
+// bytes of table with capacity buckets
+static inline size_t CHashmap_table_size(cerb_size_t capacity)
+{
+    return sizeof(CHashmap_table) + sizeof(CHashmap_node *) * capacity;
+}
+
+// internally used to allocate table of capacity empty buckets
+static CHashmap_table *CHashmap_table_create(CHashmap *map, cerb_size_t capacity)
+{
+    CHashmap_table *table = cerb_calloc(map->allocator, CHashmap_table_size(capacity));
+    check_mem(table);
+
+    table->capacity = capacity;
+
+    return table;
+
+error:
+    return NULL;
+}
+
+// internally used as dealloc_cb of retired array, retired nodes are freed with allocator of map before it's called
+static void CHashmap_node_kept(void *node)
+{
+    (void) node;
+}
+
+// internally used to free table with its nodes (data is left alone unless dealloc_cb is given)
+static void CHashmap_table_free(CHashmap *map, CHashmap_table *table, Hashmap_dealloc dealloc_cb)
+{
+    cerb_size_t i;
+    for (i = 0; i < table->capacity; i++) {
+        CHashmap_node *node = table->buckets[i];
+        while (node) {
+            CHashmap_node *next = node->next;
+            if (dealloc_cb) dealloc_cb(node->data);
+            cerb_free(map->allocator, node, sizeof(CHashmap_node));
+            node = next;
+        }
+    }
+    cerb_free(map->allocator, table, CHashmap_table_size(table->capacity));
+}
+
+CHashmap *CHashmap_create(Hashmap_cmp cmp, hash hash, cerb_size_t number_of_entries)
+{
+    return CHashmap_create_with_allocator(cmp, hash, number_of_entries, NULL);
+}
+
+CHashmap *CHashmap_create_with_allocator(Hashmap_cmp cmp, hash hash, cerb_size_t number_of_entries,
+                                         const cerb_allocator *allocator)
+{
+    CHashmap *map = NULL;
+    int i, locks = 0;
+
+    allocator = cerb_allocator_or_default(allocator);
+
+    map = cerb_calloc(allocator, sizeof(CHashmap));
+    check_mem(map);
+
+    map->allocator = allocator;
+    map->compare = cmp == NULL ? Hashmap_default_compare : cmp;
+    map->hash = hash;
+    map->seed = Hashmap_random_seed(map);
+
+    // capacity is power of 2 and multiple of stripes, so that all nodes of bucket belong to one stripe
+    cerb_size_t capacity = CHASHMAP_LOCK_STRIPES;
+    while (capacity < number_of_entries && capacity < CERB_SIZE_MAX / 2 + 1) capacity *= 2;
+
+    map->table = CHashmap_table_create(map, capacity);
+    check(map->table != NULL, "Failed to allocate table.");
+
+    for (locks = 0; locks < CHASHMAP_LOCK_STRIPES; locks++) {
+        check(pthread_mutex_init(&map->locks[locks], NULL) == 0, "Failed to initialize mutex.");
+    }
+    check(pthread_mutex_init(&map->reclaim_lock, NULL) == 0, "Failed to initialize mutex.");
+
+    map->retired = d_array_create_with_allocator(NULL, CHASHMAP_RECLAIM_BATCH, allocator);
+    check_mem(map->retired);
+
+    return map;
+
+error:
+    if (map) {
+        for (i = 0; i < locks && i < CHASHMAP_LOCK_STRIPES; i++) pthread_mutex_destroy(&map->locks[i]);
+        if (locks == CHASHMAP_LOCK_STRIPES) pthread_mutex_destroy(&map->reclaim_lock);
+        if (map->table) CHashmap_table_free(map, map->table, NULL);
+        cerb_free(allocator, map, sizeof(CHashmap));
+    }
+    return NULL;
+}
+
+// internally used to hash data with hash callback of map, or seeded string hash
+static inline uint32_t CHashmap_hash_of(CHashmap *map, void *data)
+{
+    if (map->hash) return map->hash(data);
+
+    uint64_t hash = Hashmap_hash_string(data, map->seed);
+    return (uint32_t) (hash ^ (hash >> 32));
+}
+
+// internally used to pick reader counter of calling thread (threads get stripes round robin on first use)
+static inline unsigned CHashmap_reader_stripe(void)
+{
+    static unsigned next_stripe = 0;
+    static __thread unsigned stripe = 0; // 0 means not picked yet, others are stripe + 1
+
+    if (!stripe) stripe = __atomic_fetch_add(&next_stripe, 1, __ATOMIC_RELAXED) % CHASHMAP_READER_STRIPES + 1;
+
+    return stripe - 1;
+}
+
+// enter read section: reader is counted under parity of current epoch
+unsigned CHashmap_read_lock(CHashmap *map)
+{
+    unsigned token = (unsigned) (__atomic_load_n(&map->epoch, __ATOMIC_RELAXED) & 1) * CHASHMAP_READER_STRIPES +
+                     CHashmap_reader_stripe();
+
+    __atomic_fetch_add(&map->readers[token / CHASHMAP_READER_STRIPES][token % CHASHMAP_READER_STRIPES].count, 1,
+                       __ATOMIC_RELAXED);
+    // pairs with fence of CHashmap_wait_readers: either writer sees us counted, or we see its unlinking
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return token;
+}
+
+// leave read section (release, so that our reads of nodes happen before writer frees them)
+void CHashmap_read_unlock(CHashmap *map, unsigned token)
+{
+    __atomic_fetch_sub(&map->readers[token / CHASHMAP_READER_STRIPES][token % CHASHMAP_READER_STRIPES].count, 1,
+                       __ATOMIC_RELEASE);
+}
+
+// internally used to wait for grace period (reclaim_lock has to be held). epoch is flipped twice, readers of
+// old parity are waited for each time, so every reader which entered before the call has left (as in urcu)
+static void CHashmap_wait_readers(CHashmap *map)
+{
+    int pass, i;
+
+    for (pass = 0; pass < 2; pass++) {
+        uint64_t old = __atomic_fetch_add(&map->epoch, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        CHashmap_counter *counters = map->readers[old & 1];
+        for (i = 0; i < CHASHMAP_READER_STRIPES; i++) {
+            while (__atomic_load_n(&counters[i].count, __ATOMIC_ACQUIRE) != 0) sched_yield();
+        }
+    }
+}
+
+// internally used to free everything retired before last grace period (reclaim_lock has to be held)
+static void CHashmap_free_retired(CHashmap *map)
+{
+    cerb_size_t i;
+    for (i = 0; i < d_array_length(map->retired); i++) {
+        cerb_free(map->allocator, d_array_get(map->retired, i), sizeof(CHashmap_node));
+    }
+    d_array_clear(map->retired, CHashmap_node_kept);
+
+    while (map->retired_tables) {
+        CHashmap_table *table = map->retired_tables;
+        map->retired_tables = table->retired_next;
+        CHashmap_table_free(map, table, NULL);
+    }
+}
+
+// internally used to wait for grace period and free everything retired (reclaim_lock has to be held)
+static void CHashmap_reclaim(CHashmap *map)
+{
+    if (d_array_length(map->retired) == 0 && !map->retired_tables) return;
+
+    CHashmap_wait_readers(map);
+    CHashmap_free_retired(map);
+}
+
+int CHashmap_synchronize(CHashmap *map)
+{
+    check(map != NULL, "map is NULL.");
+
+    pthread_mutex_lock(&map->reclaim_lock);
+    CHashmap_wait_readers(map); // waits even if nothing was retired, data user removed may be still in use
+    CHashmap_free_retired(map);
+    pthread_mutex_unlock(&map->reclaim_lock);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// internally used to hand unlinked node over to reclamation, it is freed after grace period
+static void CHashmap_retire(CHashmap *map, CHashmap_node *node)
+{
+    pthread_mutex_lock(&map->reclaim_lock);
+
+    if (d_array_push_back(map->retired, node) != CERB_OK) {
+        // no room to remember it, wait for readers right away
+        CHashmap_wait_readers(map);
+        CHashmap_free_retired(map);
+        cerb_free(map->allocator, node, sizeof(CHashmap_node));
+    } else if (d_array_length(map->retired) >= CHASHMAP_RECLAIM_BATCH) {
+        CHashmap_reclaim(map);
+    }
+
+    pthread_mutex_unlock(&map->reclaim_lock);
+}
+
+// internally used to find node of key in chain starting at head
+static inline CHashmap_node *CHashmap_chain_find(CHashmap *map, CHashmap_node *node, void *key, uint32_t hash)
+{
+    for (; node; node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) {
+        if (node->hash == hash && map->compare(node->data, key) == HASHMAP_EQUAL) return node;
+    }
+
+    return NULL;
+}
+
+void *CHashmap_find(CHashmap *map, void *key)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    uint32_t hash = CHashmap_hash_of(map, key);
+    unsigned token = CHashmap_read_lock(map);
+
+    CHashmap_table *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+    CHashmap_node *head = __atomic_load_n(&table->buckets[hash & (table->capacity - 1)], __ATOMIC_ACQUIRE);
+    CHashmap_node *node = CHashmap_chain_find(map, head, key, hash);
+    void *data = node ? node->data : NULL;
+
+    CHashmap_read_unlock(map, token);
+
+    return data;
+
+error:
+    return NULL;
+}
+
+// internally used to double table: every stripe is locked, nodes are copied into new table, which is published
+// at once. readers which got old table keep walking it until grace period is over
+static int CHashmap_grow(CHashmap *map, CHashmap_table *seen)
+{
+    CHashmap_table *bigger = NULL;
+    int i;
+
+    for (i = 0; i < CHASHMAP_LOCK_STRIPES; i++) pthread_mutex_lock(&map->locks[i]);
+
+    CHashmap_table *table = map->table;
+    // somebody else has grown it already
+    if (table != seen || CHashmap_length(map) <= table->capacity) goto done;
+
+    check(table->capacity <= CERB_SIZE_MAX / 2, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
+    bigger = CHashmap_table_create(map, table->capacity * 2);
+    check(bigger != NULL, "Failed to allocate table.");
+
+    cerb_size_t b, mask = bigger->capacity - 1;
+    for (b = 0; b < table->capacity; b++) {
+        CHashmap_node *node;
+        for (node = table->buckets[b]; node; node = node->next) {
+            CHashmap_node *copy = cerb_alloc(map->allocator, sizeof(CHashmap_node));
+            check_mem(copy);
+            copy->data = node->data;
+            copy->hash = node->hash;
+            copy->next = bigger->buckets[node->hash & mask];
+            bigger->buckets[node->hash & mask] = copy;
+        }
+    }
+
+    __atomic_store_n(&map->table, bigger, __ATOMIC_RELEASE);
+
+done:
+    for (i = CHASHMAP_LOCK_STRIPES - 1; i >= 0; i--) pthread_mutex_unlock(&map->locks[i]);
+
+    if (bigger) {
+        pthread_mutex_lock(&map->reclaim_lock);
+        table->retired_next = map->retired_tables;
+        map->retired_tables = table;
+        CHashmap_reclaim(map);
+        pthread_mutex_unlock(&map->reclaim_lock);
+    }
+
+    return CERB_OK;
+
+error:
+    for (i = CHASHMAP_LOCK_STRIPES - 1; i >= 0; i--) pthread_mutex_unlock(&map->locks[i]);
+    if (bigger) CHashmap_table_free(map, bigger, NULL);
+    return CERB_ERR;
+}
+
+int CHashmap_insert(CHashmap *map, void *data)
+{
+    CHashmap_node *node = NULL;
+
+    check(map != NULL, "map is NULL.");
+    check(data != NULL, "data is NULL.");
+
+    uint32_t hash = CHashmap_hash_of(map, data);
+    pthread_mutex_t *lock = &map->locks[hash & (CHASHMAP_LOCK_STRIPES - 1)];
+
+    pthread_mutex_lock(lock);
+
+    // table is read under lock, growing can't replace it while we hold stripe
+    CHashmap_table *table = map->table;
+    CHashmap_node **bucket = &table->buckets[hash & (table->capacity - 1)];
+
+    if (CHashmap_chain_find(map, *bucket, data, hash)) {
+        pthread_mutex_unlock(lock);
+        return CHASHMAP_EXISTS;
+    }
+
+    node = cerb_alloc(map->allocator, sizeof(CHashmap_node));
+    if (!node) {
+        pthread_mutex_unlock(lock);
+        sentinel("Out of memory.");
+    }
+    node->data = data;
+    node->hash = hash;
+    node->next = *bucket;
+    __atomic_store_n(bucket, node, __ATOMIC_RELEASE); // readers see node only when it is filled in
+
+    cerb_size_t length = __atomic_add_fetch(&map->length, 1, __ATOMIC_RELAXED), capacity = table->capacity;
+
+    pthread_mutex_unlock(lock);
+
+    // table may be retired by somebody else's growing from now on, only its address is used
+    if (length > capacity && CHashmap_grow(map, table) != CERB_OK) {
+        log_warn("Failed to grow map, it keeps its buckets.");
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+void *CHashmap_remove(CHashmap *map, void *key)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    uint32_t hash = CHashmap_hash_of(map, key);
+    pthread_mutex_t *lock = &map->locks[hash & (CHASHMAP_LOCK_STRIPES - 1)];
+
+    pthread_mutex_lock(lock);
+
+    CHashmap_table *table = map->table;
+    CHashmap_node **link = &table->buckets[hash & (table->capacity - 1)], *node;
+
+    for (node = *link; node; link = &node->next, node = node->next) {
+        if (node->hash == hash && map->compare(node->data, key) == HASHMAP_EQUAL) break;
+    }
+
+    if (node) {
+        // readers which are on node already still see its next
+        __atomic_store_n(link, node->next, __ATOMIC_RELEASE);
+        __atomic_sub_fetch(&map->length, 1, __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_unlock(lock);
+
+    if (!node) return NULL;
+
+    void *data = node->data;
+    CHashmap_retire(map, node);
+
+    return data;
+
+error:
+    return NULL;
+}
+
+int CHashmap_destroy(CHashmap **map, Hashmap_dealloc dealloc_cb)
+{
+    check(map != NULL, "Address of map is NULL.");
+    check(*map != NULL, "map is NULL.");
+
+    CHashmap *current = *map;
+    int i;
+
+    // nobody reads anymore, so retired things can go without waiting
+    cerb_size_t j;
+    for (j = 0; j < d_array_length(current->retired); j++) {
+        cerb_free(current->allocator, d_array_get(current->retired, j), sizeof(CHashmap_node));
+    }
+    d_array_destroy(&current->retired, CHashmap_node_kept);
+
+    while (current->retired_tables) {
+        CHashmap_table *table = current->retired_tables;
+        current->retired_tables = table->retired_next;
+        CHashmap_table_free(current, table, NULL);
+    }
+
+    CHashmap_table_free(current, current->table, dealloc_cb);
+
+    for (i = 0; i < CHASHMAP_LOCK_STRIPES; i++) pthread_mutex_destroy(&current->locks[i]);
+    pthread_mutex_destroy(&current->reclaim_lock);
+
+    cerb_free(current->allocator, current, sizeof(CHashmap));
+    *map = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -0,0 +1,83 @@
+#ifndef E2B7C4A9_6D15_4F38_9A0E_71C3D85F2B64
+#define E2B7C4A9_6D15_4F38_9A0E_71C3D85F2B64
+
+#include <pthread.h>
+#include "hashmap.h"
+
+// concurrent hashmap for read-mostly tables shared between threads. readers take no locks and never wait:
+// they walk chains which writers publish with release stores. writers lock one of CHASHMAP_LOCK_STRIPES
+// stripes (stripe of key is picked by low bits of its hash, so writers of different stripes don't contend).
+// removed nodes and old tables are freed only after grace period (RCU style): every reader is counted in
+// one of two epochs and reclaiming writer waits until readers of old epoch are gone. growing copies table
+// while holding every stripe, readers keep using old table until new one is published.
+// data itself is yours: don't free what CHashmap_remove returned until CHashmap_synchronize has returned,
+// and keep CHashmap_read_lock around CHashmap_find if other threads remove and free data. don't insert, remove
+// or synchronize from inside read section, writers may wait for readers (itself included)
+
+#define CHASHMAP_LOCK_STRIPES 64 // writer locks, capacity of table is never less than this
+#define CHASHMAP_READER_STRIPES 64 // reader counters per epoch, threads are spread over them
+#define CHASHMAP_RECLAIM_BATCH 64 // removed nodes are freed in batches of this many (one grace period each)
+#define CHASHMAP_EXISTS 1 // CHashmap_insert found key which is there already
+
+// get map length (changes as other threads insert and remove)
+#define CHashmap_length(map_ptr) __atomic_load_n(&(map_ptr)->length, __ATOMIC_RELAXED)
+
+typedef struct CHashmap_node {
+    void *data; // holds pointer to actual data
+    struct CHashmap_node *next; // next node of bucket (readers follow it without locks)
+    uint32_t hash; // whole hash of data
+} CHashmap_node;
+
+typedef struct CHashmap_table {
+    cerb_size_t capacity; // number of buckets (power of 2)
+    struct CHashmap_table *retired_next; // next table waiting for grace period
+    CHashmap_node *buckets[]; // bucket heads
+} CHashmap_table;
+
+// reader counter on its own cache line, so that readers of different stripes don't share lines
+typedef struct CHashmap_counter {
+    uint64_t count;
+    char padding[64 - sizeof(uint64_t)];
+} CHashmap_counter;
+
+typedef struct CHashmap {
+    CHashmap_table *table; // current table (read with acquire loads)
+    Hashmap_cmp compare; // compare callback
+    hash hash; // hash callback (NULL means Hashmap_hash_string with seed of map)
+    uint64_t seed; // seed of Hashmap_hash_string
+    const cerb_allocator *allocator; // allocator of tables and nodes (has to be thread safe)
+    cerb_size_t length; // number of elements (updated atomically)
+    uint64_t epoch; // grace period counter, its lowest bit picks counters readers enter
+    pthread_mutex_t locks[CHASHMAP_LOCK_STRIPES]; // writer locks
+    pthread_mutex_t reclaim_lock; // protects retired lists and serializes grace periods
+    d_array *retired; // removed nodes waiting for grace period
+    CHashmap_table *retired_tables; // old tables waiting for grace period
+    CHashmap_counter readers[2][CHASHMAP_READER_STRIPES]; // readers inside read section, per epoch parity
+} CHashmap;
+
+// create map with number_of_entries buckets (rounded up to power of 2, at least CHASHMAP_LOCK_STRIPES)
+// cmp and hash work as for Hashmap_create (NULL cmp compares ints, NULL hash hashes nul terminated strings)
+CHashmap *CHashmap_create(Hashmap_cmp cmp, hash hash, cerb_size_t number_of_entries);
+// same as CHashmap_create, but memory comes from allocator (NULL means cerb_libc_allocator), which has to be thread safe
+CHashmap *CHashmap_create_with_allocator(Hashmap_cmp cmp, hash hash, cerb_size_t number_of_entries,
+                                         const cerb_allocator *allocator);
+
+// enter read section: nodes and data reachable from map aren't freed until you leave it (sections can nest).
+// returned token has to be passed to CHashmap_read_unlock
+unsigned CHashmap_read_lock(CHashmap *map);
+void CHashmap_read_unlock(CHashmap *map, unsigned token);
+// wait until every reader which might have seen removed data has left its read section
+int CHashmap_synchronize(CHashmap *map);
+
+// find data with key (never blocks)
+void *CHashmap_find(CHashmap *map, void *key);
+// insert data unless data with equal key is there (CHASHMAP_EXISTS then), table doubles when it gets full
+int CHashmap_insert(CHashmap *map, void *data);
+// remove key from map and return its data (free it after CHashmap_synchronize), NULL if key isn't there
+void *CHashmap_remove(CHashmap *map, void *key);
+
+// destroy map and set it to NULL on stack (no other thread may use map anymore), dealloc_cb gets every data,
+// NULL dealloc_cb leaves data alone
+int CHashmap_destroy(CHashmap **map, Hashmap_dealloc dealloc_cb);
+
+#endif /* E2B7C4A9_6D15_4F38_9A0E_71C3D85F2B64 */
@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include "d_array.h"
+#include "simd_search.h"
 
 // default compare type is integer
 int default_compare(const void *const restrict data1, const void *const restrict data2)
@@ -13,12 +14,20 @@ int default_compare(const void *const restrict data1, const void *const restrict
     }
 }
 
-d_array *d_array_create(d_array_cmp compare, uint32_t initial_capacity)
+d_array *d_array_create(d_array_cmp compare, cerb_size_t initial_capacity)
 {
-    d_array *array = malloc(sizeof(struct d_array));
+    return d_array_create_with_allocator(compare, initial_capacity, NULL);
+}
+
+d_array *d_array_create_with_allocator(d_array_cmp compare, cerb_size_t initial_capacity, const cerb_allocator *allocator)
+{
+    allocator = cerb_allocator_or_default(allocator);
+
+    d_array *array = cerb_alloc(allocator, sizeof(struct d_array));
     check_mem(array); // allocate memory for d_array struct and check it
 
-    array->data = malloc(sizeof(void *) * initial_capacity);
+    array->allocator = allocator;
+    array->data = cerb_alloc(allocator, sizeof(void *) * initial_capacity);
     check_mem(array->data); // allocate memory for array->data and check it
 
     // if user doesn't define compare (otherwise it is NULL), then default one is set (see it above)
@@ -26,66 +35,309 @@ d_array *d_array_create(d_array_cmp compare, uint32_t initial_capacity)
 
     array->capacity = initial_capacity;
     array->length = 0;
+    array->head = 0;
+    array->mode = D_ARRAY_LINEAR;
+    array->search_mode = D_ARRAY_SEARCH_CALLBACK;
+    array->heap_arity = 0;
     array->expand_rate = D_ARRAY_DEFAULT_EXPAND_RATE; // expand rate is default unless user changes it
+    array->growth_factor = D_ARRAY_DEFAULT_GROWTH_FACTOR; // so is growth factor
+    array->growth_policy = D_ARRAY_GROWTH_GEOMETRIC; // geometric growth gives amortized O(1) pushes
+    array->shrink_threshold = D_ARRAY_DEFAULT_SHRINK_THRESHOLD;
+    array->growth_cb = NULL;
 
     return array;
 
 error:
-    if (array) free(array);
+    if (array) cerb_free(allocator, array, sizeof(struct d_array));
     return NULL;
 }
 
+// internally used to reverse data block from [from] to [to] (not including [to])
+static void d_array_reverse_slots(void **data, cerb_size_t from, cerb_size_t to)
+{
+    for (; from + 1 < to; from++, to--) {
+        void *temp = data[from];
+        data[from] = data[to - 1];
+        data[to - 1] = temp;
+    }
+}
+
+// rotate elements so that [0] is at data[0] and every element is contiguous (mode doesn't change)
+int d_array_linearize(d_array *array)
+{
+    check(array != NULL, "array is NULL.");
+
+    if (array->head == 0) return CERB_OK; // linear already
+
+    if ( (uint64_t) array->head + d_array_length(array) <= d_array_capacity(array) ) {
+        // doesn't wrap around, just move elements to the beginning
+        memmove(array->data, array->data + array->head, d_array_length(array) * sizeof(void *));
+    } else {
+        // block looks like [ second | free | first ] and we need [ first | second | free ]
+        cerb_size_t first_length = d_array_capacity(array) - array->head;
+        cerb_size_t second_length = d_array_length(array) - first_length;
+
+        // reversing whole block gives [ first' | free | second' ], then reverse both parts back in place
+        d_array_reverse_slots(array->data, 0, d_array_capacity(array));
+        d_array_reverse_slots(array->data, 0, first_length);
+        d_array_reverse_slots(array->data, d_array_capacity(array) - second_length, d_array_capacity(array));
+
+        // and close the free gap between them
+        memmove(array->data + first_length, array->data + d_array_capacity(array) - second_length,
+        second_length * sizeof(void *));
+    }
+    array->head = 0;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
 // internally used to manage growing and shrinking memory block
 static int d_array_resize(d_array *restrict array, size_t new_size)
 {
     // if space is not needed, deallocate and set data = NULL
     if (new_size == 0) {
-        free(array->data);
+        cerb_free(array->allocator, array->data, sizeof(void *) * d_array_capacity(array));
         array->data = NULL;
         array->length = 0;
         array->capacity = 0;
+        array->head = 0;
         return CERB_OK;
     }
 
-    void **new_data = (void **) realloc(array->data, sizeof(void *) * new_size);
+    // elements which would be cut off by shrinking are moved to the beginning first
+    if ( (uint64_t) array->head + d_array_length(array) > new_size ) d_array_linearize(array);
+
+    void **new_data = (void **) cerb_realloc(array->allocator, array->data,
+    sizeof(void *) * d_array_capacity(array), sizeof(void *) * new_size);
     check_mem(new_data); // allocate new space and check it
 
     array->data = new_data; // set to newly allocated block only if execution goes past check_mem()
 
+    // if ring array wraps around, elements from head to the old end of block are moved to the new end of block
+    if ( (uint64_t) array->head + d_array_length(array) > d_array_capacity(array) ) {
+        cerb_size_t first_length = d_array_capacity(array) - array->head;
+        memmove(array->data + new_size - first_length, array->data + array->head, first_length * sizeof(void *));
+        array->head = new_size - first_length;
+    }
+
     return CERB_OK;
 
 error:
     return CERB_ERR;
 }
 
-// internally used to manage inserting and removing
-static inline int d_array_grow(d_array *array)
+// internally used to calculate capacity for holding at least required elements, starting from capacity
+static uint64_t d_array_policy_capacity(d_array *array, uint64_t capacity, uint64_t required)
 {
-    int rc = d_array_resize(array, d_array_capacity(array) + d_array_expand_rate(array));
+    uint64_t new_capacity;
+
+    switch (d_array_growth_policy(array)) {
+        case D_ARRAY_GROWTH_FIXED: // add as many expand_rates as needed to reach required
+            new_capacity = capacity + d_array_expand_rate(array);
+            if (new_capacity < required) {
+                new_capacity += (required - new_capacity + d_array_expand_rate(array) - 1) /
+                d_array_expand_rate(array) * d_array_expand_rate(array);
+            }
+            break;
+        case D_ARRAY_GROWTH_CUSTOM:
+            new_capacity = array->growth_cb((cerb_size_t) capacity, (cerb_size_t) required);
+            break;
+        default: // D_ARRAY_GROWTH_GEOMETRIC
+            new_capacity = capacity * array->growth_factor / 100;
+            break;
+    }
+
+    if (new_capacity < required) new_capacity = required; // policy must never return less than required
+    if (!CERB_SIZE_FITS(new_capacity)) new_capacity = CERB_SIZE_MAX; // required itself always fits (callers check it)
+
+    return new_capacity;
+}
+
+// internally used to manage inserting (grows array so that it can hold at least required elements)
+static inline int d_array_grow(d_array *array, uint64_t required)
+{
+    check(CERB_SIZE_FITS(required), "Can't expand past max available size, AKA CERB_SIZE_MAX.");
+
+    uint64_t new_capacity = d_array_policy_capacity(array, d_array_capacity(array), required);
+
+    int rc = d_array_resize(array, new_capacity);
     check(rc != CERB_ERR, "Failed to grow array in size, new elements can't be added.");
 
-    array->capacity += d_array_expand_rate(array); // we are growing by expand_rate
+    array->capacity = new_capacity;
 
-error: // fall through
-    return rc;
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
 }
 
-// internally used to manage inserting and removing
+// internally used to manage removing (shrinks array only when length has dropped to shrink_threshold of capacity)
 static inline int d_array_shrink(d_array *array)
 {
-    // capacity - expand_rate doesn't cause underflow (caller functions handle that)
-    int rc = d_array_resize(array, d_array_capacity(array) - d_array_expand_rate(array));
+    // cast to unsigned 64-bit to prevent overflow
+    if (!array->shrink_threshold || d_array_capacity(array) <= D_ARRAY_MIN_CAPACITY ||
+    d_array_length(array) > (uint64_t) d_array_capacity(array) * array->shrink_threshold / 100) {
+        return CERB_OK;
+    }
+
+    // leave room for one growth step, which makes shrinking and growing hysteretic
+    uint64_t new_capacity = d_array_policy_capacity(array, d_array_length(array), d_array_length(array));
+    if (new_capacity < D_ARRAY_MIN_CAPACITY) new_capacity = D_ARRAY_MIN_CAPACITY;
+    if (new_capacity >= d_array_capacity(array)) return CERB_OK;
+
+    int rc = d_array_resize(array, new_capacity);
     check(rc != CERB_ERR, "Failed to contract.");
 
-    // if length has decreased to 0 we don't subtract anything, else we subtract expand_rate
-    array->capacity -= d_array_capacity(array) ? d_array_expand_rate(array) : 0;
+    array->capacity = new_capacity;
 
 error: // fall through
     return rc;
 }
 
+// switch array to D_ARRAY_RING or D_ARRAY_LINEAR mode (switching to D_ARRAY_LINEAR linearizes array)
+int d_array_set_mode(d_array *array, uint8_t mode)
+{
+    check(array != NULL, "array is NULL.");
+    check(mode == D_ARRAY_LINEAR || mode == D_ARRAY_RING, "Invalid mode.");
+
+    if (mode == D_ARRAY_LINEAR) d_array_linearize(array);
+    array->mode = mode;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// choose how d_array_index_of finds elements
+int d_array_set_search_mode(d_array *array, uint8_t search_mode)
+{
+    check(array != NULL, "array is NULL.");
+    check(search_mode <= D_ARRAY_SEARCH_INT, "Invalid search mode.");
+
+    array->search_mode = search_mode;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// vectorized d_array_index_of, ring arrays are searched slice by slice
+int64_t d_array_index_of_vectorized(d_array *restrict array, void *restrict data)
+{
+    void **first, **second;
+    cerb_size_t first_length, second_length;
+    int64_t index;
+
+    check(d_array_slices(array, &first, &first_length, &second, &second_length) == CERB_OK, "Failed to get slices.");
+
+    if (array->search_mode == D_ARRAY_SEARCH_IDENTITY) {
+        index = cerb_simd_find_pointer(first, first_length, data, 0);
+        if (index < 0 && second_length) {
+            index = cerb_simd_find_pointer(second, second_length, data, 0);
+            if (index >= 0) index += first_length;
+        }
+    } else {
+        index = cerb_simd_find_int(first, first_length, *(int *) data, 0);
+        if (index < 0 && second_length) {
+            index = cerb_simd_find_int(second, second_length, *(int *) data, 0);
+            if (index >= 0) index += first_length;
+        }
+    }
+
+    return index;
+
+error:
+    return CERB_ERR;
+}
+
+// get contiguous slices of array in order: [0] is first[0] and second slice continues where first ends
+int d_array_slices(d_array *restrict array, void ***first, cerb_size_t *first_length, void ***second, cerb_size_t *second_length)
+{
+    check(array != NULL, "array is NULL.");
+    check(first != NULL && first_length != NULL, "first slice is NULL.");
+    check(second != NULL && second_length != NULL, "second slice is NULL.");
+
+    // first slice goes from head to the end of block at most
+    *first = array->data + array->head;
+    *first_length = d_array_capacity(array) - array->head < d_array_length(array) ?
+    d_array_capacity(array) - array->head : d_array_length(array);
+
+    // and the rest of elements (if any) start from the beginning of block
+    *second_length = d_array_length(array) - *first_length;
+    *second = *second_length ? array->data : NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// grow capacity by multiplying it with growth_factor / 100 (growth_factor must be greater than 100)
+int d_array_set_growth_geometric(d_array *array, uint16_t growth_factor)
+{
+    check(array != NULL, "array is NULL.");
+    check(growth_factor > 100, "growth_factor must be greater than 100.");
+
+    array->growth_factor = growth_factor;
+    array->growth_policy = D_ARRAY_GROWTH_GEOMETRIC;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// grow capacity by adding expand_rate to it (same as d_array_set_expand_rate, but checks arguments)
+int d_array_set_growth_fixed(d_array *array, uint16_t expand_rate)
+{
+    check(array != NULL, "array is NULL.");
+    check(expand_rate != 0, "expand_rate is 0.");
+
+    array->expand_rate = expand_rate;
+    array->growth_policy = D_ARRAY_GROWTH_FIXED;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// grow capacity by calling growth_cb (see d_array_growth_cb)
+int d_array_set_growth_custom(d_array *array, d_array_growth_cb growth_cb)
+{
+    check(array != NULL, "array is NULL.");
+    check(growth_cb != NULL, "growth_cb is NULL.");
+
+    array->growth_cb = growth_cb;
+    array->growth_policy = D_ARRAY_GROWTH_CUSTOM;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// shrink when length drops to shrink_threshold percents of capacity (0 turns automatic shrinking off)
+int d_array_set_shrink_threshold(d_array *array, uint8_t shrink_threshold)
+{
+    check(array != NULL, "array is NULL.");
+    check(shrink_threshold < 100, "shrink_threshold must be less than 100.");
+
+    array->shrink_threshold = shrink_threshold;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
 // expand array to new_capacity
-int d_array_expand(d_array *array, uint32_t new_capacity)
+int d_array_expand(d_array *array, cerb_size_t new_capacity)
 {
     check(array != NULL, "array is NULL.");
     check(new_capacity > d_array_capacity(array), "new_capacity is less than or equal to the existing capacity.");
@@ -118,6 +370,209 @@ error:
     return CERB_ERR;
 }
 
+// internally used to make room at [position] (position <= length), array must have space for one more element
+static void d_array_open_gap(d_array *array, cerb_size_t position)
+{
+    if (d_array_mode(array) == D_ARRAY_LINEAR) {
+        // take each element after [position] up one location with a single move
+        memmove(array->data + position + 1, array->data + position, (d_array_length(array) - position) * sizeof(void *));
+    } else if (position < d_array_length(array) - position) {
+        // ring array moves the shorter side, here it is elements before [position] which go down one location
+        array->head = array->head ? array->head - 1 : d_array_capacity(array) - 1;
+        cerb_size_t i;
+        for (i = 0; i < position; i++) {
+            array->data[d_array_slot(array, i)] = array->data[d_array_slot(array, i + 1)];
+        }
+    } else {
+        cerb_size_t i; // and here it is elements after [position] which go up one location
+        for (i = d_array_length(array); i > position; i--) {
+            array->data[d_array_slot(array, i)] = array->data[d_array_slot(array, i - 1)];
+        }
+    }
+}
+
+// internally used to remove [position] (position < length), disappearing data at [position] and decreasing length
+static void d_array_close_gap(d_array *array, cerb_size_t position)
+{
+    if (d_array_mode(array) == D_ARRAY_LINEAR) {
+        // take each element after [position] to it's front location with a single move
+        memmove(array->data + position, array->data + position + 1,
+        (d_array_length(array) - position - 1) * sizeof(void *));
+    } else if (position < d_array_length(array) - 1 - position) {
+        cerb_size_t i; // ring array moves the shorter side, here it is elements before [position] which go up one location
+        for (i = position; i > 0; i--) {
+            array->data[d_array_slot(array, i)] = array->data[d_array_slot(array, i - 1)];
+        }
+        array->head = d_array_slot(array, 1);
+    } else {
+        cerb_size_t i; // and here it is elements after [position] which go down one location
+        for (i = position; i + 1 < d_array_length(array); i++) {
+            array->data[d_array_slot(array, i)] = array->data[d_array_slot(array, i + 1)];
+        }
+    }
+
+    array->length--; // decrease length
+    if (!d_array_length(array)) array->head = 0; // empty array starts from the beginning of block again
+}
+
+// make sure array can hold at least capacity elements (capacity is rounded up by growth policy)
+int d_array_reserve(d_array *array, cerb_size_t capacity)
+{
+    check(array != NULL, "array is NULL.");
+
+    if (capacity <= d_array_capacity(array)) return CERB_OK;
+
+    return d_array_grow(array, capacity);
+
+error:
+    return CERB_ERR;
+}
+
+// internally used to copy n pointers from data into slots starting at [position] (ring arrays wrap around)
+static void d_array_copy_in(d_array *array, cerb_size_t position, void *const *data, cerb_size_t n)
+{
+    cerb_size_t slot = d_array_slot(array, position);
+    cerb_size_t first = d_array_capacity(array) - slot < n ? d_array_capacity(array) - slot : n;
+
+    memcpy(array->data + slot, data, first * sizeof(void *));
+    memcpy(array->data, data + first, (n - first) * sizeof(void *)); // n - first is 0 if nothing wraps around
+}
+
+// push n elements from data at the back of d_array, growing it only once
+int d_array_push_back_n(d_array *array, void *const *data, cerb_size_t n)
+{
+    check(array != NULL, "array is NULL.");
+    check(data != NULL || n == 0, "data is NULL.");
+
+    if (!n) return CERB_OK;
+
+    int rc = d_array_reserve(array, !CERB_SIZE_FITS((uint64_t) d_array_length(array) + n) ?
+    CERB_SIZE_MAX : d_array_length(array) + n);
+    check(rc != CERB_ERR && (uint64_t) d_array_length(array) + n <= d_array_capacity(array),
+    "Failed to grow array in size, new elements can't be added.");
+
+    d_array_copy_in(array, d_array_length(array), data, n);
+    array->length += n;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// insert n elements from data at [position] (position can be length), moving tail of array only once
+int d_array_insert_range(d_array *array, cerb_size_t position, void *const *data, cerb_size_t n)
+{
+    check(array != NULL, "array is NULL.");
+    check(position <= d_array_length(array), "Invalid position.");
+    check(data != NULL || n == 0, "data is NULL.");
+
+    // inserting at the end doesn't move anything (and doesn't linearize ring arrays)
+    if (position == d_array_length(array)) return d_array_push_back_n(array, data, n);
+    if (!n) return CERB_OK;
+
+    int rc = d_array_reserve(array, !CERB_SIZE_FITS((uint64_t) d_array_length(array) + n) ?
+    CERB_SIZE_MAX : d_array_length(array) + n);
+    check(rc != CERB_ERR && (uint64_t) d_array_length(array) + n <= d_array_capacity(array),
+    "Failed to grow array in size, new elements can't be added.");
+
+    d_array_linearize(array); // tail is moved with a single memmove, so array needs to be contiguous
+
+    memmove(array->data + position + n, array->data + position, (d_array_length(array) - position) * sizeof(void *));
+    memcpy(array->data + position, data, n * sizeof(void *));
+    array->length += n;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// internally used by remove_range and delete_range to close the gap of [from_position, to_position)
+static void d_array_close_range(d_array *array, cerb_size_t from_position, cerb_size_t to_position)
+{
+    cerb_size_t n = to_position - from_position;
+
+    if (from_position == 0 && d_array_mode(array) == D_ARRAY_RING) {
+        array->head = d_array_slot(array, n); // ring arrays drop elements from the front by moving their head
+    } else if (to_position != d_array_length(array)) {
+        d_array_linearize(array); // tail is moved with a single memmove, so array needs to be contiguous
+        memmove(array->data + from_position, array->data + to_position,
+        (d_array_length(array) - to_position) * sizeof(void *));
+    }
+
+    array->length -= n;
+    if (!d_array_length(array)) array->head = 0; // empty array starts from the beginning of block again
+
+    d_array_shrink(array); // shrink if length has dropped to shrink_threshold of capacity
+}
+
+// remove elements from [from_position] to [to_position] (not including [to_position]) with a single move of tail
+// removed elements are copied to removed (if it isn't NULL), deallocating them is your responsibility
+int d_array_remove_range(d_array *array, cerb_size_t from_position, cerb_size_t to_position, void **removed)
+{
+    check(array != NULL, "array is NULL.");
+    check(from_position <= to_position && to_position <= d_array_length(array), "Invalid positions.");
+
+    if (removed) {
+        cerb_size_t i;
+        for (i = from_position; i < to_position; i++) {
+            removed[i - from_position] = array->data[d_array_slot(array, i)];
+        }
+    }
+    d_array_close_range(array, from_position, to_position);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// equivalent to d_array_remove_range, except that it deallocates removed elements
+int d_array_delete_range(d_array *array, cerb_size_t from_position, cerb_size_t to_position, d_array_dealloc dealloc_cb)
+{
+    check(array != NULL, "array is NULL.");
+    check(from_position <= to_position && to_position <= d_array_length(array), "Invalid positions.");
+    check(dealloc_cb != NULL, "dealloc_cb is NULL.");
+
+    cerb_size_t i;
+    for (i = from_position; i < to_position; i++) {
+        dealloc_cb(array->data[d_array_slot(array, i)]);
+    }
+    d_array_close_range(array, from_position, to_position);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// append copies of other's pointers at the back of array (other stays untouched, unlike in d_array_join)
+int d_array_append_array(d_array *restrict array, d_array *restrict other)
+{
+    check(array != NULL, "array is NULL.");
+    check(other != NULL, "other is NULL.");
+
+    // other can be a ring array, so it is appended slice by slice
+    void **first, **second;
+    cerb_size_t first_length, second_length;
+    d_array_slices(other, &first, &first_length, &second, &second_length);
+
+    int rc = d_array_push_back_n(array, first, first_length);
+    check(rc != CERB_ERR, "Failed to append array.");
+
+    rc = d_array_push_back_n(array, second, second_length);
+    if (rc == CERB_ERR) { // don't leave array half appended
+        array->length -= first_length;
+        sentinel("Failed to append array.");
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
 // push at the end ( at [array->length] )
 int d_array_push_back(d_array *array, void *data)
 {
@@ -127,17 +582,11 @@ int d_array_push_back(d_array *array, void *data)
     // if length and capacity are the same it is time to grow
     if (d_array_length(array) == d_array_capacity(array)) {
         // cast to unsigned 64-bit to prevent overflow
-        if ( (uint64_t) d_array_capacity(array) + d_array_expand_rate(array) > UINT32_MAX ) {
-            // check if max length has been reached
-            log_err("Can't expand past max available size, AKA UINT32_MAX.");
-            return CERB_ERR;
-        } else {
-            int rc = d_array_grow(array); // grow array
-            if (rc == CERB_ERR) return CERB_ERR; // if growing fails, don't insert anything and return error
-        }
+        int rc = d_array_grow(array, (uint64_t) d_array_length(array) + 1);
+        if (rc == CERB_ERR) return CERB_ERR; // if growing fails, don't insert anything and return error
     }
 
-    array->data[d_array_length(array)] = data; // add data at the end
+    array->data[d_array_slot(array, d_array_length(array))] = data; // add data at the end
     array->length++; // increment length
 
     return CERB_OK;
@@ -155,21 +604,12 @@ int d_array_push_front(d_array *array, void *data)
     // if length and capacity are the same it is time to grow
     if (d_array_length(array) == d_array_capacity(array)) {
         // cast to unsigned 64-bit to prevent overflow
-        if ( (uint64_t) d_array_capacity(array) + d_array_expand_rate(array) > UINT32_MAX ) {
-            // check if max length has been reached
-            log_err("Can't expand past max available size, AKA UINT32_MAX.");
-            return CERB_ERR;
-        } else {
-            int rc = d_array_grow(array); // grow array
-            if (rc == CERB_ERR) return CERB_ERR; // if growing fails, don't insert anything and return error
-        }
+        int rc = d_array_grow(array, (uint64_t) d_array_length(array) + 1);
+        if (rc == CERB_ERR) return CERB_ERR; // if growing fails, don't insert anything and return error
     }
 
-    uint32_t i; // take each element up one location making room at [0]
-    for (i = d_array_length(array); i > 0; i--) {
-        array->data[i] = array->data[i - 1];
-    }
-    array->data[0] = data; // insert new element at [0]
+    d_array_open_gap(array, 0); // making room at [0] (ring arrays just move their head)
+    array->data[d_array_slot(array, 0)] = data; // insert new element at [0]
     array->length++; // and increment length
 
     return CERB_OK;
@@ -185,15 +625,12 @@ void *d_array_pop_back(d_array *array)
     check(d_array_length(array), "array is empty.");
 
     /* not freeing or setting popped element to NULL, as it will be overwritten by another element */
-    void *data = array->data[d_array_length(array) - 1];
+    void *data = array->data[d_array_slot(array, d_array_length(array) - 1)];
     array->length--; // decrease length
     // d_array_print(array, data_cb, "%d");
     // debug("data = %d", *(int *)data);
 
-    // cast to signed 64-bit to prevent underflow. can be shrinked down to zero with >=
-    if ( (int64_t) d_array_capacity(array) - d_array_expand_rate(array) >= d_array_length(array) ) {
-        d_array_shrink(array);
-    }
+    d_array_shrink(array); // shrink if length has dropped to shrink_threshold of capacity
 // debug("data = %d", *(int *)data);
     return data; // return the data we took earlier
 
@@ -208,18 +645,10 @@ void *d_array_pop_front(d_array *array)
     check(d_array_length(array), "array is empty.");
 
     // not freeing or setting popped element to NULL, as it will be overwritten by another element
-    void *data = array->data[0];
-    array->length--; // decrease length
-
-    uint32_t i; // take each element to it's front location, disappearing data at [0]
-    for (i = 0; i < d_array_length(array); i++) {
-        array->data[i] = array->data[i + 1];
-    }
+    void *data = array->data[d_array_slot(array, 0)];
+    d_array_close_gap(array, 0); // disappearing data at [0] (ring arrays just move their head)
 
-    // cast to signed 64-bit to prevent underflow. can be shrinked down to zero with >=
-    if ( (int64_t) d_array_capacity(array) - d_array_expand_rate(array) >= d_array_length(array) ) {
-        d_array_shrink(array);
-    }
+    d_array_shrink(array); // shrink if length has dropped to shrink_threshold of capacity
 
     return data; // return the data we took earlier
 
@@ -228,7 +657,7 @@ error:
 }
 
 // insert at an already existing array position, making index of each element after [posittion] 1 higher
-int d_array_insert_at(d_array *array, uint32_t position, void *data)
+int d_array_insert_at(d_array *array, cerb_size_t position, void *data)
 {
     check(array != NULL, "array is NULL.");
     check(position < d_array_length(array), "Invalid position.");
@@ -237,21 +666,12 @@ int d_array_insert_at(d_array *array, uint32_t position, void *data)
     // if length and capacity are the same it is time to grow
     if (d_array_length(array) == d_array_capacity(array)) {
         // cast to unsigned 64-bit to prevent overflow
-        if ( (uint64_t) d_array_capacity(array) + d_array_expand_rate(array) > UINT32_MAX ) {
-            // check if max length has been reached
-            log_err("Can't expand past max available size, AKA UINT32_MAX.");
-            return CERB_ERR;
-        } else {
-            int rc = d_array_grow(array); // grow d_array
-            if (rc == CERB_ERR) return CERB_ERR; // if growing fails, don't insert anything and return error
-        }
+        int rc = d_array_grow(array, (uint64_t) d_array_length(array) + 1);
+        if (rc == CERB_ERR) return CERB_ERR; // if growing fails, don't insert anything and return error
     }
 
-    uint32_t i; // take each element up one position making room at [position]
-    for (i = d_array_length(array); i > position; i--) {
-        array->data[i] = array->data[i - 1];
-    }
-    array->data[i] = data; // insert new element at [position]
+    d_array_open_gap(array, position); // making room at [position]
+    array->data[d_array_slot(array, position)] = data; // insert new element at [position]
     array->length++; // increment length
 
     return CERB_OK;
@@ -261,24 +681,16 @@ error:
 }
 
 // don't forget deallocating returned memory
-void *d_array_remove_at(d_array *array, uint32_t position)
+void *d_array_remove_at(d_array *array, cerb_size_t position)
 {
     check(array != NULL, "array is NULL.");
     check(position < d_array_length(array), "Invalid position.");
 
     // not freeing or setting popped element to NULL, as it will be overwritten by another element
-    void *data = array->data[position];
-    array->length--; // decrease length
-
-    uint32_t i; // take each element after [position] to it's front location, disappearing data at [position]
-    for (i = position; i < d_array_length(array); i++) {
-        array->data[i] = array->data[i + 1];
-    }
+    void *data = array->data[d_array_slot(array, position)];
+    d_array_close_gap(array, position); // disappearing data at [position]
 
-    // cast to signed 64-bit to prevent underflow. can be shrinked down to zero with >=
-    if ( (int64_t) d_array_capacity(array) - d_array_expand_rate(array) >= d_array_length(array) ) {
-        d_array_shrink(array);
-    }
+    d_array_shrink(array); // shrink if length has dropped to shrink_threshold of capacity
 
     return data; // return the data we took earlier
 
@@ -287,24 +699,16 @@ error:
 }
 
 // equivalent to d_array_remove_at, except that it deallocates data at [position]
-int d_array_delete_at(d_array *array, uint32_t position, d_array_dealloc dealloc_cb)
+int d_array_delete_at(d_array *array, cerb_size_t position, d_array_dealloc dealloc_cb)
 {
     check(array != NULL, "array is NULL.");
     check(position < d_array_length(array), "Invalid position.");
     check(dealloc_cb != NULL, "dealloc_cb is NULL.");
 
-    dealloc_cb(array->data[position]); // deallocate data on [position]
-    array->length--; // decrease length
+    dealloc_cb(array->data[d_array_slot(array, position)]); // deallocate data on [position]
+    d_array_close_gap(array, position); // disappearing data at [position]
 
-    uint32_t i; // take each element after [position] to it's front location, disappearing data at [position]
-    for (i = position; i < d_array_length(array); i++) {
-        array->data[i] = array->data[i + 1];
-    }
-
-    // cast to signed 64-bit to prevent underflow. can be shrinked down to zero with >=
-    if ( (int64_t) d_array_capacity(array) - d_array_expand_rate(array) >= d_array_length(array) ) {
-        d_array_shrink(array);
-    }
+    d_array_shrink(array); // shrink if length has dropped to shrink_threshold of capacity
 
     return CERB_OK;
 
@@ -319,20 +723,13 @@ int d_array_delete(d_array *array, void *data, d_array_dealloc dealloc_cb)
     check(data != NULL, "data is NULL.");
     check(dealloc_cb != NULL, "dealloc_cb is NULL.");
 
-    uint32_t i; // loop through an array and find the element
+    cerb_size_t i; // loop through an array and find the element
     for (i = 0; i < d_array_length(array); i++) {
-        if (array->compare(array->data[i], data) == D_ARRAY_EQUAL) {
+        if (array->compare(array->data[d_array_slot(array, i)], data) == D_ARRAY_EQUAL) {
             dealloc_cb(data); // deallocate data found
-            array->length--; // decrease length of array
-            for (; i < d_array_length(array); i++) {
-                // take each element after [position] to it's front location, disappearing data at [position]
-                array->data[i] = array->data[i + 1];
-            }
+            d_array_close_gap(array, i); // disappearing data at [position]
 
-            // cast to signed 64-bit to prevent underflow. can be shrinked down to zero with >=
-            if ( (int64_t) d_array_capacity(array) - d_array_expand_rate(array) >= d_array_length(array) ) {
-                d_array_shrink(array);
-            }
+            d_array_shrink(array); // shrink if length has dropped to shrink_threshold of capacity
             return CERB_OK;
         }
     }
@@ -352,10 +749,14 @@ d_array *d_array_join(d_array **array1, d_array *restrict *restrict array2)
     check(*array2 != NULL, "array2 is NULL.");
     check(d_array_length(*array1) != 0, "array1 is empty.");
     check(d_array_length(*array2) != 0, "array2 is empty.");
-    check((uint64_t) d_array_length(*array1) + d_array_length(*array2) <= UINT32_MAX,
-    "Can't expand past max available size, AKA UINT32_MAX.");
+    check(CERB_SIZE_FITS((uint64_t) d_array_length(*array1) + d_array_length(*array2)),
+    "Can't expand past max available size, AKA CERB_SIZE_MAX.");
     check((*array1)->compare == (*array2)->compare, "array1 compare and array2 compare don't match.");
 
+    // memory is copied in bulk below, so both arrays need to be contiguous
+    d_array_linearize(*array1);
+    d_array_linearize(*array2);
+
     // make this signed 64-bit to prevent overflow or underflow
     int64_t diff = (int64_t) d_array_capacity(*array1) - d_array_length(*array1) - d_array_length(*array2);
 
@@ -371,8 +772,8 @@ d_array *d_array_join(d_array **array1, d_array *restrict *restrict array2)
     (*array1)->length += d_array_length(*array2);
 
     // deallocate array2's data and struct itself
-    free((*array2)->data);
-    free(*array2);
+    cerb_free((*array2)->allocator, (*array2)->data, sizeof(void *) * d_array_capacity(*array2));
+    cerb_free((*array2)->allocator, *array2, sizeof(struct d_array));
 
     d_array *new_array = *array1; // put array1 into this variable
 
@@ -387,7 +788,7 @@ error:
 }
 
 // split one array into 2, returning splitted portion
-d_array *d_array_split(d_array **array, uint32_t from_position, uint32_t to_position)
+d_array *d_array_split(d_array **array, cerb_size_t from_position, cerb_size_t to_position)
 {
     check(array != NULL, "Address of array1 is NULL.");
     check(*array != NULL, "array1 is NULL.");
@@ -398,37 +799,38 @@ d_array *d_array_split(d_array **array, uint32_t from_position, uint32_t to_posi
     check(to_position <= d_array_length(*array), "Invalid to_position.");
     check(from_position < to_position, "Invalid positions.");
 
-    uint32_t new_array_length = to_position - from_position; // calculate length of splitted part
+    d_array_linearize(*array); // memory is copied in bulk below, so array needs to be contiguous
+
+    cerb_size_t new_array_length = to_position - from_position; // calculate length of splitted part
 
     // create new array and assign length to it
-    d_array *new_array = d_array_create((*array)->compare, new_array_length);
+    d_array *new_array = d_array_create_with_allocator((*array)->compare, new_array_length, (*array)->allocator);
     check(new_array != NULL, "Couldn't split the array.");
     new_array->length = d_array_capacity(new_array);
+    new_array->search_mode = d_array_search_mode(*array); // split part is searched the same way
 
     // copy splitted part into new array
     memcpy(new_array->data, (*array)->data + from_position, d_array_length(new_array) * sizeof(void *));
 
-    uint32_t i = 0, j = 0; // move parts of d_array that were beyond the split position
-    for (i = from_position; j < d_array_length(*array) - to_position; i++, j++) {
-        (*array)->data[i] = (*array)->data[j + to_position];
-    }
+    // move parts of d_array that were beyond the split position with a single move
+    cerb_size_t tail_length = d_array_length(*array) - to_position;
+    memmove((*array)->data + from_position, (*array)->data + to_position, tail_length * sizeof(void *));
 
     // resize to fit the new length exactly
-    int rc = d_array_resize(*array, d_array_length(*array) - new_array_length);
+    cerb_size_t old_length = d_array_length(*array);
+    int rc = d_array_resize(*array, old_length - new_array_length);
     if (rc == CERB_ERR) { // if resize fails, don't split at all and deallocate all newly created blocks
         // give back old elements their indexes
-        for (i = from_position, j = 0; j < d_array_length(*array) - to_position; i++, j++) {
-            (*array)->data[j + to_position] = (*array)->data[i];
-        }
+        memmove((*array)->data + to_position, (*array)->data + from_position, tail_length * sizeof(void *));
         // memcopy back slpitted elements to their places
         memcpy((*array)->data + from_position, new_array->data, d_array_length(new_array) * sizeof(void *));
 
         log_err("Failed to resize the array, thus it hasn't been splitted.");
-        free(new_array->data);
-        free(new_array);
+        cerb_free(new_array->allocator, new_array->data, sizeof(void *) * d_array_capacity(new_array));
+        cerb_free(new_array->allocator, new_array, sizeof(struct d_array));
         return NULL;
     }
-    (*array)->length = d_array_length(*array) - new_array_length; // set array length to correct amount
+    (*array)->length = old_length - new_array_length; // set array length to correct amount
     (*array)->capacity = d_array_length(*array);
     
     return new_array;
@@ -443,11 +845,12 @@ int d_array_clear(d_array *restrict array, d_array_dealloc dealloc_cb)
     check(array != NULL, "array is NULL.");
     check(dealloc_cb != NULL, "dealloc_cb is NULL.");
 
-    uint32_t i; // deallocate every data entry at slots, set length = 0 ( note that capacity stays the same )
+    cerb_size_t i; // deallocate every data entry at slots, set length = 0 ( note that capacity stays the same )
     for (i = 0; i < d_array_length(array); i++) {
-        dealloc_cb(array->data[i]);
+        dealloc_cb(array->data[d_array_slot(array, i)]);
     }
     array->length = 0;
+    array->head = 0;
 
     return CERB_OK;
 
@@ -465,13 +868,13 @@ int d_array_destroy(d_array *restrict *restrict array, d_array_dealloc dealloc_c
     check(*array != NULL, "array is NULL.");
     check(dealloc_cb != NULL, "dealloc_cb is NULL.");
 
-    uint32_t i; // deallocate all data fields from callback
+    cerb_size_t i; // deallocate all data fields from callback
     for (i = 0; i < d_array_length(*array); i++) {
-        dealloc_cb((*array)->data[i]);
+        dealloc_cb((*array)->data[d_array_slot(*array, i)]);
     }
     // free data block and array struct itself
-    free((*array)->data);
-    free(*array);
+    cerb_free((*array)->allocator, (*array)->data, sizeof(void *) * d_array_capacity(*array));
+    cerb_free((*array)->allocator, *array, sizeof(struct d_array));
 
     // set array on stack to NULL
     *array = NULL;
@@ -488,9 +891,9 @@ int d_array_traverse(d_array *array, d_array_traverse_cb traverse_cb)
     check(array != NULL, "array is NULL.");
     check(traverse_cb != NULL, "traverse_cb is NULL.");
 
-    uint32_t i; // go through each element and apply traverse callback to data fields
+    cerb_size_t i; // go through each element and apply traverse callback to data fields
     for (i = 0; i < d_array_length(array); i++) {
-        if (traverse_cb(array->data[i]) != CERB_OK) {
+        if (traverse_cb(array->data[d_array_slot(array, i)]) != CERB_OK) {
             return CERB_ERR;
         }
     }
@@ -2,6 +2,8 @@
 #define E9987CBD_81B9_420E_931B_13867F04AC33
 
 #include <stdint.h>
+#include "cerb_size.h"
+#include "allocator.h"
 // for d_array_print
 #include <stdio.h>
 #include "dbg.h"
@@ -14,28 +16,54 @@
 #define D_ARRAY_EQUAL 0
 
 #define D_ARRAY_DEFAULT_EXPAND_RATE 100
+#define D_ARRAY_DEFAULT_GROWTH_FACTOR 200 // in percents of current capacity (200 doubles capacity)
+#define D_ARRAY_DEFAULT_SHRINK_THRESHOLD 25 // in percents of current capacity (0 turns automatic shrinking off)
+#define D_ARRAY_MIN_CAPACITY 8 // automatic shrinking never goes below this capacity
+
+// growth policies of d_array (see d_array_set_growth_* functions below)
+#define D_ARRAY_GROWTH_GEOMETRIC 0 // capacity is multiplied by growth_factor (default)
+#define D_ARRAY_GROWTH_FIXED 1 // capacity is increased by expand_rate
+#define D_ARRAY_GROWTH_CUSTOM 2 // capacity is calculated by user supplied d_array_growth_cb
+
+// storage modes of d_array (see d_array_set_mode)
+#define D_ARRAY_LINEAR 0 // [0] is always at data[0] (default)
+#define D_ARRAY_RING 1 // [0] is at data[head] and elements wrap around the end of data block (O(1) at both ends)
+
+// search modes of d_array (see d_array_set_search_mode)
+#define D_ARRAY_SEARCH_CALLBACK 0 // d_array_index_of calls compare for every element (default)
+#define D_ARRAY_SEARCH_IDENTITY 1 // d_array_index_of looks for the same pointer (vectorized, compare isn't called)
+#define D_ARRAY_SEARCH_INT 2 // elements are ints compared by value (vectorized, compare isn't called)
 
 // get the index of last element of array
 #define d_array_index_of_last(array_ptr) ((array_ptr)->length - 1)
 // get the data at [0] (NULL if length is 0)
-#define d_array_at_zero(array_ptr) ((array_ptr)->length ? (array_ptr)->data[0] : NULL)
+#define d_array_at_zero(array_ptr) ((array_ptr)->length ? (array_ptr)->data[d_array_slot(array_ptr, 0)] : NULL)
 // get the data at last position of array
-#define d_array_at_last(array_ptr) ((array_ptr)->length ? (array_ptr)->data[d_array_index_of_last(array_ptr)] : NULL)
+#define d_array_at_last(array_ptr)\
+        ((array_ptr)->length ? (array_ptr)->data[d_array_slot(array_ptr, d_array_index_of_last(array_ptr))] : NULL)
 // get array capacity
 #define d_array_capacity(array_ptr) ((array_ptr)->capacity)
 // get array length
 #define d_array_length(array_ptr) ((array_ptr)->length)
 // get array expand rate
 #define d_array_expand_rate(array_ptr) ((array_ptr)->expand_rate)
+// get array growth policy (D_ARRAY_GROWTH_GEOMETRIC, D_ARRAY_GROWTH_FIXED or D_ARRAY_GROWTH_CUSTOM)
+#define d_array_growth_policy(array_ptr) ((array_ptr)->growth_policy)
+// get array storage mode (D_ARRAY_LINEAR or D_ARRAY_RING)
+#define d_array_mode(array_ptr) ((array_ptr)->mode)
+// get array search mode (D_ARRAY_SEARCH_*)
+#define d_array_search_mode(array_ptr) ((array_ptr)->search_mode)
 
-// new_expand_rate should be in range of 1 to UINT16_MAX.
-#define d_array_set_expand_rate(array_ptr, new_expand_rate) ((array_ptr)->expand_rate = (new_expand_rate) ? (new_expand_rate) : 1)
+// new_expand_rate should be in range of 1 to UINT16_MAX. this also switches array to D_ARRAY_GROWTH_FIXED policy
+#define d_array_set_expand_rate(array_ptr, new_expand_rate) ((array_ptr)->growth_policy = D_ARRAY_GROWTH_FIXED,\
+        (array_ptr)->expand_rate = (new_expand_rate) ? (new_expand_rate) : 1)
 
 // format is "%s", "%c", "%d", "%f" etc...  data_cb (which is a function) returns data which matches format
 #define d_array_print(array_ptr, data_cb, format)\
         if(array_ptr){\
-        printf("[ ");uint32_t i=0;for(;i<(int64_t)(array_ptr)->length-1;i++){printf(format", ",data_cb((array_ptr)->data[i]));}\
-        if((array_ptr)->length){printf(format,data_cb((array_ptr)->data[i]));}printf(" ]\n");}\
+        printf("[ ");cerb_size_t i=0;for(;i+1<(array_ptr)->length;i++){\
+        printf(format", ",data_cb((array_ptr)->data[d_array_slot(array_ptr, i)]));}\
+        if((array_ptr)->length){printf(format,data_cb((array_ptr)->data[d_array_slot(array_ptr, i)]));}printf(" ]\n");}\
         else{log_err("array is NULL.");}
 
 // ==============================================================================================================================
@@ -43,22 +71,46 @@
 // compare function pointer for d_array (note consts and restrict. your function has to follow the rules imposed by those)
 typedef int (*d_array_cmp) (const void *const restrict data1, const void *const restrict data2);
 
+// custom growth policy. returns new capacity for an array of capacity which needs to hold at least required elements
+// (return value less than required is raised to required). it is also used for shrinking, then capacity == required
+typedef cerb_size_t (*d_array_growth_cb) (cerb_size_t capacity, cerb_size_t required);
+
 typedef struct d_array {
     d_array_cmp compare; // compare callback
+    d_array_growth_cb growth_cb; // growth callback (used with D_ARRAY_GROWTH_CUSTOM only)
+    const cerb_allocator *allocator; // allocator of data block and struct itself (see allocator.h)
     void **data; // array of pointers to data
-    uint32_t capacity; // capacity of d_array
-    uint32_t length; // length of d_array
-    uint16_t expand_rate; // expand rate of d_array
+    cerb_size_t capacity; // capacity of d_array
+    cerb_size_t length; // length of d_array
+    cerb_size_t head; // position of [0] in data block (always 0 in D_ARRAY_LINEAR mode)
+    uint16_t expand_rate; // expand rate of d_array (used with D_ARRAY_GROWTH_FIXED only)
+    uint16_t growth_factor; // growth factor of d_array in percents (used with D_ARRAY_GROWTH_GEOMETRIC only)
+    uint8_t growth_policy; // how d_array grows (D_ARRAY_GROWTH_*)
+    uint8_t shrink_threshold; // shrink when length drops to this percent of capacity (0 means never shrink)
+    uint8_t mode; // storage mode of d_array (D_ARRAY_LINEAR or D_ARRAY_RING)
+    uint8_t search_mode; // how d_array_index_of matches elements (D_ARRAY_SEARCH_*)
+    uint8_t heap_arity; // children per node when array is used as Heap (0 means binary heap, see heap.h)
 } d_array;
 
+// d_array_index_of for D_ARRAY_SEARCH_IDENTITY and D_ARRAY_SEARCH_INT modes (see simd_search.h)
+int64_t d_array_index_of_vectorized(d_array *restrict array, void *restrict data);
+
+// get the slot of data block where [position] is stored (ring arrays wrap around, linear ones have head == 0)
+static inline cerb_size_t d_array_slot(const d_array *array, cerb_size_t position)
+{
+    uint64_t slot = (uint64_t) array->head + position; // cast to unsigned 64-bit to prevent overflow
+
+    return slot < array->capacity ? slot : slot - array->capacity;
+}
+
 // set specific [position] to data in array
-static inline int d_array_set(d_array *restrict array, uint32_t position, void *restrict data)
+static inline int d_array_set(d_array *restrict array, cerb_size_t position, void *restrict data)
 {
     check(array != NULL, "array is NULL.");
     check(position < d_array_length(array), "Invalid position.");
     check(data != NULL, "data is NULL.");
 
-    array->data[position] = data; // set data
+    array->data[d_array_slot(array, position)] = data; // set data
 
     return CERB_OK;
 
@@ -67,12 +119,12 @@ error:
 }
 
 // get data at specific [position] from array
-static inline void *d_array_get(d_array *restrict array, uint32_t position)
+static inline void *d_array_get(d_array *restrict array, cerb_size_t position)
 {
     check(array != NULL, "array is NULL.");
     check(position < d_array_length(array), "Invalid position.");
     
-    return array->data[position]; // return data at [position]
+    return array->data[d_array_slot(array, position)]; // return data at [position]
 
 error:
     return NULL;
@@ -83,10 +135,12 @@ static inline int64_t d_array_index_of(d_array *restrict array, void *restrict d
 {
     check(array != NULL, "array is NULL.");
     check(data != NULL, "data is NULL.");
+
+    if (array->search_mode != D_ARRAY_SEARCH_CALLBACK) return d_array_index_of_vectorized(array, data);
     
-    uint32_t i;
+    cerb_size_t i;
     for (i = 0; i < d_array_length(array); i++) {
-        if (array->compare(array->data[i], data) == 0) return i;
+        if (array->compare(array->data[d_array_slot(array, i)], data) == 0) return i;
     }
 
 error: // fall through
@@ -94,7 +148,9 @@ error: // fall through
 }
 
 // create d_array
-d_array *d_array_create(d_array_cmp compare, uint32_t initial_capacity);
+d_array *d_array_create(d_array_cmp compare, cerb_size_t initial_capacity);
+// create d_array which allocates its memory with allocator (NULL means cerb_libc_allocator)
+d_array *d_array_create_with_allocator(d_array_cmp compare, cerb_size_t initial_capacity, const cerb_allocator *allocator);
 
 // push data at the back of d_array
 int d_array_push_back(d_array *array, void *data);
@@ -107,19 +163,56 @@ void *d_array_pop_back(d_array *array);
 void *d_array_pop_front(d_array *array);
 
 // insert data at a specific [position] of d_array
-int d_array_insert_at(d_array *array, uint32_t position, void *data);
+int d_array_insert_at(d_array *array, cerb_size_t position, void *data);
 // remove data from a specific [position] of d_array
-void *d_array_remove_at(d_array *array, uint32_t position);
+void *d_array_remove_at(d_array *array, cerb_size_t position);
+
+// grow capacity by multiplying it with growth_factor / 100 (growth_factor must be greater than 100)
+int d_array_set_growth_geometric(d_array *array, uint16_t growth_factor);
+// grow capacity by adding expand_rate to it (same as d_array_set_expand_rate, but checks arguments)
+int d_array_set_growth_fixed(d_array *array, uint16_t expand_rate);
+// grow capacity by calling growth_cb (see d_array_growth_cb)
+int d_array_set_growth_custom(d_array *array, d_array_growth_cb growth_cb);
+// shrink when length drops to shrink_threshold percents of capacity (should be lower than 100 / growth rate percents)
+// capacity left after shrinking has room for one more growth step, so push/pop near the boundary doesn't reallocate
+int d_array_set_shrink_threshold(d_array *array, uint8_t shrink_threshold);
+
+// switch array to D_ARRAY_RING or D_ARRAY_LINEAR mode (switching to D_ARRAY_LINEAR linearizes array)
+// ring arrays push and pop at both ends in O(1), but their data block can't be indexed directly, use d_array_get,
+// d_array_set or slices below. functions which need contiguous data (heap functions for example) linearize it first
+int d_array_set_mode(d_array *array, uint8_t mode);
+// choose how d_array_index_of finds elements (D_ARRAY_SEARCH_*). D_ARRAY_SEARCH_INT needs elements which are ints
+int d_array_set_search_mode(d_array *array, uint8_t search_mode);
+// rotate elements so that [0] is at data[0] and every element is contiguous (mode doesn't change)
+int d_array_linearize(d_array *array);
+// get contiguous slices of array in order: [0] is first[0] and second slice continues where first ends
+// (second_length is 0 and second is NULL if array doesn't wrap around)
+int d_array_slices(d_array *restrict array, void ***first, cerb_size_t *first_length, void ***second, cerb_size_t *second_length);
 
 // expand array to new_capacity
-int d_array_expand(d_array *array, uint32_t new_capacity);
+int d_array_expand(d_array *array, cerb_size_t new_capacity);
+// make sure array can hold at least capacity elements (capacity is rounded up by growth policy)
+int d_array_reserve(d_array *array, cerb_size_t capacity);
 // shrink array to exactly fit the current length
 int d_array_shrink_to_fit(d_array *array);
 
+/* bulk operations (each of them grows array at most once and moves elements after the range with a single memmove) */
+/* elements of data must not be NULL (same as in push and insert functions above) */
+
+// push n elements from data at the back of d_array
+int d_array_push_back_n(d_array *array, void *const *data, cerb_size_t n);
+// insert n elements from data at [position] (position can be length)
+int d_array_insert_range(d_array *array, cerb_size_t position, void *const *data, cerb_size_t n);
+// remove elements from [from_position] to [to_position] (not including [to_position])
+// removed elements are copied to removed (if it isn't NULL), deallocating them is your responsibility
+int d_array_remove_range(d_array *array, cerb_size_t from_position, cerb_size_t to_position, void **removed);
+// append copies of other's pointers at the back of array (other stays untouched, unlike in d_array_join)
+int d_array_append_array(d_array *restrict array, d_array *restrict other);
+
 // join 2 arrays, deallocating array2 and it's data block AKA array->data (you need to provide reference to those arrays)
 d_array *d_array_join(d_array **array1, d_array *restrict *restrict array2);
 // split one array into 2, returning splitted portion
-d_array *d_array_split(d_array **array1, uint32_t from_position, uint32_t to_position);
+d_array *d_array_split(d_array **array1, cerb_size_t from_position, cerb_size_t to_position);
 
 typedef int (*d_array_traverse_cb) (void *data); // traverse callback for d_array (see d_array_traverse for more info)
 
@@ -130,7 +223,9 @@ int d_array_traverse(d_array *array, d_array_traverse_cb traverse_cb);
 typedef void (*d_array_dealloc) (void *data);
 
 // equivalent to d_array_remove_at, except that it deallocates data at [position]
-int d_array_delete_at(d_array *array, uint32_t position, d_array_dealloc dealloc_cb);
+int d_array_delete_at(d_array *array, cerb_size_t position, d_array_dealloc dealloc_cb);
+// equivalent to d_array_remove_range, except that it deallocates removed elements
+int d_array_delete_range(d_array *array, cerb_size_t from_position, cerb_size_t to_position, d_array_dealloc dealloc_cb);
 // deletes first match of data in array and deallocates it too
 int d_array_delete(d_array *array, void *data, d_array_dealloc dealloc_cb);
 // destroys an entire d_array and sets it to NULL on stack (you need to provide reference to d_array)
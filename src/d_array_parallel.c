@@ -0,0 +1,236 @@
+#include <stdlib.h>
+#include <string.h>
+#include "d_array_parallel.h"
+#include "d_array_sort.h"
+
+#define PARALLEL_SORT_MIN 4096 // arrays shorter than this are sorted on calling thread
+#define PARALLEL_MERGE_BLOCK_MIN 4096 // merge passes hand out output blocks at least this long
+
+#define LESS(compare, a, b) ((compare)((a), (b)) < 0)
+
+// same grain executor would pick, reduce needs to know number of chunks in advance
+static size_t parallel_grain(cerb_executor *executor, size_t count, cerb_size_t grain)
+{
+    if (grain != 0) return grain;
+
+    size_t picked = count / ((size_t) cerb_executor_thread_count(executor) * 4);
+    return picked ? picked : 1;
+}
+
+typedef struct traverse_context {
+    void **data;
+    d_array_traverse_cb traverse_cb;
+    int failed;
+} traverse_context;
+
+static void traverse_task(void *arg, size_t begin, size_t end)
+{
+    traverse_context *context = arg;
+    size_t i;
+
+    if (__atomic_load_n(&context->failed, __ATOMIC_RELAXED)) return; // somebody failed already, skip the chunk
+
+    for (i = begin; i < end; i++) {
+        if (context->traverse_cb(context->data[i]) != CERB_OK) {
+            __atomic_store_n(&context->failed, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+}
+
+// apply traverse_cb to every element in parallel
+int d_array_parallel_traverse(d_array *array, cerb_executor *executor, cerb_size_t grain, d_array_traverse_cb traverse_cb)
+{
+    check(array != NULL, "array is NULL.");
+    check(executor != NULL, "executor is NULL.");
+    check(traverse_cb != NULL, "traverse_cb is NULL.");
+
+    d_array_linearize(array); // chunks are plain ranges of block then
+
+    traverse_context context = {array->data, traverse_cb, 0};
+    check(cerb_executor_parallel_for(executor, d_array_length(array), grain, traverse_task, &context) == CERB_OK,
+          "Failed to run parallel traversal.");
+    check(context.failed == 0, "traverse_cb failed.");
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+typedef struct reduce_context {
+    void **data;
+    char *partials; // one accumulator per chunk
+    size_t result_size;
+    size_t grain;
+    d_array_reduce_cb reduce_cb;
+} reduce_context;
+
+static void reduce_task(void *arg, size_t begin, size_t end)
+{
+    reduce_context *context = arg;
+    void *accumulator = context->partials + (begin / context->grain) * context->result_size;
+    size_t i;
+
+    for (i = begin; i < end; i++) context->reduce_cb(accumulator, context->data[i]);
+}
+
+// reduce array into result in parallel
+int d_array_parallel_reduce(d_array *array, cerb_executor *executor, cerb_size_t grain, void *result, size_t result_size,
+                            d_array_reduce_cb reduce_cb, d_array_combine_cb combine_cb)
+{
+    reduce_context context = {NULL, NULL, result_size, 0, reduce_cb};
+    size_t count, chunks = 0, i;
+
+    check(array != NULL, "array is NULL.");
+    check(executor != NULL, "executor is NULL.");
+    check(result != NULL, "result is NULL.");
+    check(result_size > 0, "result_size is 0.");
+    check(reduce_cb != NULL && combine_cb != NULL, "reduce_cb or combine_cb is NULL.");
+
+    if (d_array_length(array) == 0) return CERB_OK; // result is identity
+
+    d_array_linearize(array);
+
+    count = d_array_length(array);
+    context.data = array->data;
+    context.grain = parallel_grain(executor, count, grain);
+    chunks = (count + context.grain - 1) / context.grain;
+
+    // every chunk starts from identity
+    context.partials = cerb_alloc(array->allocator, chunks * result_size);
+    check_mem(context.partials);
+    for (i = 0; i < chunks; i++) memcpy(context.partials + i * result_size, result, result_size);
+
+    check(cerb_executor_parallel_for(executor, count, context.grain, reduce_task, &context) == CERB_OK,
+          "Failed to run parallel reduction.");
+
+    for (i = 0; i < chunks; i++) combine_cb(result, context.partials + i * result_size);
+
+    cerb_free(array->allocator, context.partials, chunks * result_size);
+
+    return CERB_OK;
+
+error:
+    if (context.partials) cerb_free(array->allocator, context.partials, chunks * result_size);
+    return CERB_ERR;
+}
+
+typedef struct sort_context {
+    d_array *array;
+    void **source; // runs being merged
+    void **target; // where merged runs go (runs are sorted with the same block as scratch before that)
+    size_t length;
+    size_t run_length; // length of runs sorted first
+    size_t width; // length of runs merged by current pass
+} sort_context;
+
+// sort runs on their own, every run gets its slice of target as scratch (allocator isn't called from threads)
+static void sort_run_task(void *arg, size_t begin, size_t end)
+{
+    sort_context *context = arg;
+    size_t run;
+
+    for (run = begin; run < end; run++) {
+        size_t from = run * context->run_length;
+        size_t to = context->length - from < context->run_length ? context->length : from + context->run_length;
+        d_array_stable_sort_block(context->source + from, to - from, context->target + from, context->array->compare);
+    }
+}
+
+// number of elements of left which come before first k elements of left and right merged (left wins ties)
+static size_t merge_split(void **left, size_t left_length, void **right, size_t right_length, size_t k,
+                          d_array_cmp compare)
+{
+    size_t low = k > right_length ? k - right_length : 0;
+    size_t high = k < left_length ? k : left_length;
+
+    while (low < high) {
+        size_t i = low + (high - low) / 2, j = k - i;
+        // right[j - 1] is not less than left[i], so left[i] belongs to first k too
+        if (!LESS(compare, right[j - 1], left[i])) low = i + 1;
+        else high = i;
+    }
+
+    return low;
+}
+
+// produce merged output [begin, end) of current pass, block may span several pairs of runs
+static void sort_merge_task(void *arg, size_t begin, size_t end)
+{
+    sort_context *context = arg;
+    d_array_cmp compare = context->array->compare;
+    size_t width = context->width, length = context->length;
+
+    while (begin < end) {
+        size_t pair = begin - begin % (2 * width);
+        size_t middle = pair + width < length ? pair + width : length;
+        size_t pair_end = middle + width < length ? middle + width : length;
+        size_t stop = end < pair_end ? end : pair_end;
+
+        void **left = context->source + pair, **right = context->source + middle;
+        size_t left_length = middle - pair, right_length = pair_end - middle;
+
+        size_t i = merge_split(left, left_length, right, right_length, begin - pair, compare);
+        size_t i_end = merge_split(left, left_length, right, right_length, stop - pair, compare);
+        size_t j = begin - pair - i, j_end = stop - pair - i_end;
+
+        void **out = context->target + begin;
+        while (i < i_end && j < j_end) {
+            *out++ = LESS(compare, right[j], left[i]) ? right[j++] : left[i++];
+        }
+        memcpy(out, left + i, (i_end - i) * sizeof(void *));
+        out += i_end - i;
+        memcpy(out, right + j, (j_end - j) * sizeof(void *));
+
+        begin = stop;
+    }
+}
+
+// stable parallel merge sort
+int d_array_parallel_sort(d_array *array, cerb_executor *executor)
+{
+    void **buffer = NULL;
+
+    check(array != NULL, "array is NULL.");
+    check(executor != NULL, "executor is NULL.");
+
+    size_t length = d_array_length(array), threads = cerb_executor_thread_count(executor);
+
+    if (threads == 1 || length < PARALLEL_SORT_MIN) return d_array_stable_sort(array);
+
+    d_array_linearize(array);
+
+    // the only allocation, made on calling thread (allocators don't have to be thread-safe)
+    buffer = cerb_alloc(array->allocator, sizeof(void *) * length);
+    check_mem(buffer);
+
+    sort_context context = {array, array->data, buffer, length, (length + threads - 1) / threads, 0};
+    size_t runs = (length + context.run_length - 1) / context.run_length;
+
+    // one run per thread, each sorted on its own
+    check(cerb_executor_parallel_for(executor, runs, 1, sort_run_task, &context) == CERB_OK,
+          "Failed to sort runs.");
+
+    // merge pairs of runs until there is only one, every pass is split into equal output blocks
+    size_t block = length / (threads * 4);
+    if (block < PARALLEL_MERGE_BLOCK_MIN) block = PARALLEL_MERGE_BLOCK_MIN;
+
+    for (context.width = context.run_length; context.width < length; context.width *= 2) {
+        check(cerb_executor_parallel_for(executor, length, block, sort_merge_task, &context) == CERB_OK,
+              "Failed to merge runs.");
+        void **temp = context.source;
+        context.source = context.target;
+        context.target = temp;
+    }
+
+    if (context.source != array->data) memcpy(array->data, context.source, length * sizeof(void *));
+
+    cerb_free(array->allocator, buffer, sizeof(void *) * length);
+
+    return CERB_OK;
+
+error:
+    if (buffer) cerb_free(array->allocator, buffer, sizeof(void *) * d_array_length(array));
+    return CERB_ERR;
+}
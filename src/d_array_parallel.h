@@ -0,0 +1,33 @@
+#ifndef A7B2C9E4_5D1F_4E3A_8C60_2F9B7D4E1A85
+#define A7B2C9E4_5D1F_4E3A_8C60_2F9B7D4E1A85
+
+#include <stddef.h>
+#include "d_array.h"
+#include "executor.h"
+
+// data parallel operations for large d_arrays, run on threads of given executor (see executor.h).
+// ring arrays are linearized first, array must not be modified by anybody else until operation returns.
+// grain is number of elements handled by one task (0 lets executor pick it), don't make it too small
+// because every chunk costs some synchronization. allocator of array is called on calling thread only, so it
+// doesn't have to be thread-safe
+
+// folds data into accumulator (accumulator is chunk private, no locking needed)
+typedef void (*d_array_reduce_cb) (void *accumulator, void *data);
+// merges other accumulator into accumulator
+typedef void (*d_array_combine_cb) (void *accumulator, const void *other);
+
+// apply traverse_cb to every element in parallel, elements are visited in no particular order.
+// returns CERB_ERR if traverse_cb failed for any element (chunks which haven't started yet are skipped then)
+int d_array_parallel_traverse(d_array *array, cerb_executor *executor, cerb_size_t grain, d_array_traverse_cb traverse_cb);
+
+// reduce array into result, which is accumulator of result_size bytes and holds identity value on call.
+// every chunk starts with copy of identity, chunk results are combined into result in order of chunks
+// so combine_cb doesn't have to be commutative, only associative
+int d_array_parallel_reduce(d_array *array, cerb_executor *executor, cerb_size_t grain, void *result, size_t result_size,
+                            d_array_reduce_cb reduce_cb, d_array_combine_cb combine_cb);
+
+// stable parallel merge sort (chunks are sorted in parallel and then merged pairwise, every merge pass is split
+// evenly among threads). allocates buffer of length pointers, chunks are sorted with its slices as scratch
+int d_array_parallel_sort(d_array *array, cerb_executor *executor);
+
+#endif /* A7B2C9E4_5D1F_4E3A_8C60_2F9B7D4E1A85 */
@@ -0,0 +1,535 @@
+#include <stdlib.h>
+#include "d_array_sort.h"
+
+#define INSERTION_SORT_THRESHOLD 24 // ranges shorter than this are insertion sorted
+#define NINTHER_THRESHOLD 128 // ranges longer than this choose pivot as median of 3 medians
+#define PARTIAL_INSERTION_SORT_LIMIT 8 // max moves partial insertion sort does before it gives up
+#define MERGE_SORT_RUN 32 // stable sort insertion sorts runs of this length before merging them
+
+// a is less than b according to compare
+#define LESS(compare, a, b) ((compare)((a), (b)) < 0)
+
+// swap two slots (internally used by sorting functions)
+#define SORT_SWAP(slot1, slot2)\
+            do { void *_temp = *(slot1); *(slot1) = *(slot2); *(slot2) = _temp; } while (0)
+
+// insertion sort [begin, end)
+static void insertion_sort(void **begin, void **end, d_array_cmp compare)
+{
+    if (begin == end) return;
+
+    void **cur;
+    for (cur = begin + 1; cur != end; cur++) {
+        void **sift = cur;
+        if (LESS(compare, *sift, *(sift - 1))) {
+            void *temp = *sift;
+            do { // move greater elements one slot up, until place of temp is found
+                *sift = *(sift - 1);
+                sift--;
+            } while (sift != begin && LESS(compare, temp, *(sift - 1)));
+            *sift = temp;
+        }
+    }
+}
+
+// insertion sort [begin, end), assuming that *(begin - 1) is less or equal to every element of range
+static void unguarded_insertion_sort(void **begin, void **end, d_array_cmp compare)
+{
+    if (begin == end) return;
+
+    void **cur;
+    for (cur = begin + 1; cur != end; cur++) {
+        void **sift = cur;
+        if (LESS(compare, *sift, *(sift - 1))) {
+            void *temp = *sift;
+            do { // *(begin - 1) stops the loop, so no bound check is needed
+                *sift = *(sift - 1);
+                sift--;
+            } while (LESS(compare, temp, *(sift - 1)));
+            *sift = temp;
+        }
+    }
+}
+
+// insertion sort [begin, end) but give up after PARTIAL_INSERTION_SORT_LIMIT moves (returns 1 if range got sorted)
+static int partial_insertion_sort(void **begin, void **end, d_array_cmp compare)
+{
+    if (begin == end) return 1;
+
+    size_t limit = 0;
+    void **cur;
+    for (cur = begin + 1; cur != end; cur++) {
+        void **sift = cur;
+        if (LESS(compare, *sift, *(sift - 1))) {
+            void *temp = *sift;
+            do {
+                *sift = *(sift - 1);
+                sift--;
+            } while (sift != begin && LESS(compare, temp, *(sift - 1)));
+            *sift = temp;
+            limit += cur - sift;
+        }
+        if (limit > PARTIAL_INSERTION_SORT_LIMIT) return 0;
+    }
+
+    return 1;
+}
+
+// sort 2 slots
+static inline void sort2(void **a, void **b, d_array_cmp compare)
+{
+    if (LESS(compare, *b, *a)) SORT_SWAP(a, b);
+}
+
+// sort 3 slots
+static inline void sort3(void **a, void **b, void **c, d_array_cmp compare)
+{
+    sort2(a, b, compare);
+    sort2(b, c, compare);
+    sort2(a, b, compare);
+}
+
+// internally used by heap_sort, sinks [position] of max heap [begin, begin + length)
+static void sift_down(void **begin, size_t position, size_t length, d_array_cmp compare)
+{
+    void *temp = begin[position];
+    size_t child;
+    while ((child = 2 * position + 1) < length) {
+        if (child + 1 < length && LESS(compare, begin[child], begin[child + 1])) child++;
+        if (!LESS(compare, temp, begin[child])) break;
+        begin[position] = begin[child];
+        position = child;
+    }
+    begin[position] = temp;
+}
+
+// heap sort [begin, end), used when quicksort keeps choosing bad pivots
+static void heap_sort(void **begin, void **end, d_array_cmp compare)
+{
+    size_t length = end - begin, i;
+
+    for (i = length / 2; i > 0; i--) {
+        sift_down(begin, i - 1, length, compare);
+    }
+    for (i = length; i > 1; i--) {
+        SORT_SWAP(begin, begin + i - 1);
+        sift_down(begin, 0, i - 1, compare);
+    }
+}
+
+// choose pivot of [begin, end) and move it to *begin (ninther for long ranges, median of 3 for short ones)
+static void choose_pivot(void **begin, void **end, d_array_cmp compare)
+{
+    size_t size = end - begin, half = size / 2;
+
+    if (size > NINTHER_THRESHOLD) {
+        sort3(begin, begin + half, end - 1, compare);
+        sort3(begin + 1, begin + (half - 1), end - 2, compare);
+        sort3(begin + 2, begin + (half + 1), end - 3, compare);
+        sort3(begin + (half - 1), begin + half, begin + (half + 1), compare);
+        SORT_SWAP(begin, begin + half);
+    } else {
+        sort3(begin + half, begin, end - 1, compare);
+    }
+}
+
+// partition [begin, end) around pivot *begin, elements equal to pivot go to the right side.
+// returns pivot's final position and sets already_partitioned if no elements had to be swapped
+static void **partition_right(void **begin, void **end, d_array_cmp compare, int *already_partitioned)
+{
+    void *pivot = *begin;
+    void **first = begin, **last = end;
+
+    // find the first element greater or equal to pivot (median of 3 guarantees that it exists)
+    while (LESS(compare, *++first, pivot));
+
+    // find the first element strictly less than pivot from the end (guarded only if there was nothing less before)
+    if (first - 1 == begin) {
+        while (first < last && !LESS(compare, *--last, pivot));
+    } else {
+        while (!LESS(compare, *--last, pivot));
+    }
+
+    *already_partitioned = first >= last;
+
+    // keep swapping misplaced pairs, there is no need for bound checks as they are guarding each other
+    while (first < last) {
+        SORT_SWAP(first, last);
+        while (LESS(compare, *++first, pivot));
+        while (!LESS(compare, *--last, pivot));
+    }
+
+    // put pivot in its place
+    void **pivot_position = first - 1;
+    *begin = *pivot_position;
+    *pivot_position = pivot;
+
+    return pivot_position;
+}
+
+// partition [begin, end) around pivot *begin, elements equal to pivot go to the left side.
+// used when pivot is equal to *(begin - 1), so that runs of equal elements are skipped in linear time
+static void **partition_left(void **begin, void **end, d_array_cmp compare)
+{
+    void *pivot = *begin;
+    void **first = begin, **last = end;
+
+    while (LESS(compare, pivot, *--last));
+
+    if (last + 1 == end) {
+        while (first < last && !LESS(compare, pivot, *++first));
+    } else {
+        while (!LESS(compare, pivot, *++first));
+    }
+
+    while (first < last) {
+        SORT_SWAP(first, last);
+        while (LESS(compare, pivot, *--last));
+        while (!LESS(compare, pivot, *++first));
+    }
+
+    void **pivot_position = last;
+    *begin = *pivot_position;
+    *pivot_position = pivot;
+
+    return pivot_position;
+}
+
+// swap some elements of unbalanced partition around to break patterns which made it unbalanced
+static void break_patterns(void **begin, void **pivot_position, void **end)
+{
+    size_t left_size = pivot_position - begin, right_size = end - (pivot_position + 1);
+
+    if (left_size >= INSERTION_SORT_THRESHOLD) {
+        SORT_SWAP(begin, begin + left_size / 4);
+        SORT_SWAP(pivot_position - 1, pivot_position - left_size / 4);
+        if (left_size > NINTHER_THRESHOLD) {
+            SORT_SWAP(begin + 1, begin + (left_size / 4 + 1));
+            SORT_SWAP(begin + 2, begin + (left_size / 4 + 2));
+            SORT_SWAP(pivot_position - 2, pivot_position - (left_size / 4 + 1));
+            SORT_SWAP(pivot_position - 3, pivot_position - (left_size / 4 + 2));
+        }
+    }
+
+    if (right_size >= INSERTION_SORT_THRESHOLD) {
+        SORT_SWAP(pivot_position + 1, pivot_position + (1 + right_size / 4));
+        SORT_SWAP(end - 1, end - right_size / 4);
+        if (right_size > NINTHER_THRESHOLD) {
+            SORT_SWAP(pivot_position + 2, pivot_position + (2 + right_size / 4));
+            SORT_SWAP(pivot_position + 3, pivot_position + (3 + right_size / 4));
+            SORT_SWAP(end - 2, end - (1 + right_size / 4));
+            SORT_SWAP(end - 3, end - (2 + right_size / 4));
+        }
+    }
+}
+
+// pattern-defeating quicksort of [begin, end) (leftmost is 0 if *(begin - 1) is less or equal to every element)
+static void pdq_sort(void **begin, void **end, d_array_cmp compare, int bad_allowed, int leftmost)
+{
+    while (1) {
+        size_t size = end - begin;
+
+        if (size < INSERTION_SORT_THRESHOLD) {
+            if (leftmost) insertion_sort(begin, end, compare);
+            else unguarded_insertion_sort(begin, end, compare);
+            return;
+        }
+
+        choose_pivot(begin, end, compare);
+
+        // if pivot is equal to the element before range, every element equal to it can be skipped at once
+        if (!leftmost && !LESS(compare, *(begin - 1), *begin)) {
+            begin = partition_left(begin, end, compare) + 1;
+            continue;
+        }
+
+        int already_partitioned = 0;
+        void **pivot_position = partition_right(begin, end, compare, &already_partitioned);
+
+        size_t left_size = pivot_position - begin, right_size = end - (pivot_position + 1);
+        if (left_size < size / 8 || right_size < size / 8) {
+            // too many bad partitions mean that input is adversarial, fall back to O(n log n) heap sort
+            if (--bad_allowed == 0) {
+                heap_sort(begin, end, compare);
+                return;
+            }
+            break_patterns(begin, pivot_position, end);
+        } else if (already_partitioned && partial_insertion_sort(begin, pivot_position, compare) &&
+        partial_insertion_sort(pivot_position + 1, end, compare)) {
+            return; // range was (almost) sorted already
+        }
+
+        // recurse into the left part and loop on the right one
+        pdq_sort(begin, pivot_position, compare, bad_allowed, leftmost);
+        begin = pivot_position + 1;
+        leftmost = 0;
+    }
+}
+
+// floor of log2(n) (number of bad partitions pdq_sort tolerates)
+static int log2_floor(size_t n)
+{
+    int log = 0;
+    while (n >>= 1) log++;
+    return log;
+}
+
+// sort array with pattern-defeating quicksort
+int d_array_sort(d_array *array)
+{
+    check(array != NULL, "array is NULL.");
+
+    d_array_linearize(array); // sorting works on contiguous block
+
+    if (d_array_length(array) > 1) {
+        pdq_sort(array->data, array->data + d_array_length(array), array->compare,
+        log2_floor(d_array_length(array)), 1);
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// merge sort [begin, begin + length) using buffer of at least length / 2 slots
+static void merge_sort(void **begin, size_t length, void **buffer, d_array_cmp compare)
+{
+    if (length <= MERGE_SORT_RUN) {
+        insertion_sort(begin, begin + length, compare); // insertion sort is stable too
+        return;
+    }
+
+    size_t half = length / 2;
+    merge_sort(begin, half, buffer, compare);
+    merge_sort(begin + half, length - half, buffer, compare);
+
+    // halves are in order already (common for presorted input), no need to merge
+    if (!LESS(compare, begin[half], begin[half - 1])) return;
+
+    // move left half out of the way and merge it with right half back into place
+    memcpy(buffer, begin, half * sizeof(void *));
+
+    void **left = buffer, **left_end = buffer + half;
+    void **right = begin + half, **right_end = begin + length;
+    void **out = begin;
+
+    while (left < left_end && right < right_end) {
+        // take from right only if it is strictly less, which keeps equal elements in order
+        *out++ = LESS(compare, *right, *left) ? *right++ : *left++;
+    }
+    // whatever is left of right half is in place already
+    memcpy(out, left, (left_end - left) * sizeof(void *));
+}
+
+// stable sort of length pointers at begin with buffer of at least length / 2 slots
+void d_array_stable_sort_block(void **begin, size_t length, void **buffer, d_array_cmp compare)
+{
+    merge_sort(begin, length, buffer, compare);
+}
+
+// sort array keeping relative order of equal elements
+int d_array_stable_sort(d_array *array)
+{
+    check(array != NULL, "array is NULL.");
+
+    return d_array_stable_sort_range(array, 0, d_array_length(array));
+
+error:
+    return CERB_ERR;
+}
+
+// stable sort of elements [from, to) only
+int d_array_stable_sort_range(d_array *array, cerb_size_t from, cerb_size_t to)
+{
+    void **buffer = NULL;
+
+    check(array != NULL, "array is NULL.");
+    check(from <= to && to <= d_array_length(array), "invalid range.");
+
+    d_array_linearize(array); // sorting works on contiguous block
+
+    if (to - from <= MERGE_SORT_RUN) {
+        insertion_sort(array->data + from, array->data + to, array->compare);
+        return CERB_OK;
+    }
+
+    buffer = cerb_alloc(array->allocator, sizeof(void *) * ((to - from) / 2));
+    check_mem(buffer);
+
+    merge_sort(array->data + from, to - from, buffer, array->compare);
+
+    cerb_free(array->allocator, buffer, sizeof(void *) * ((to - from) / 2));
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// (key, data) pairs radix sort works with, so that key_cb is called only once per element
+typedef struct radix_item {
+    uint64_t key;
+    void *data;
+} radix_item;
+
+// sort array by keys key_cb extracts (stable LSD radix sort, 8 bits per pass)
+int d_array_radix_sort(d_array *array, d_array_key_cb key_cb)
+{
+    radix_item *items = NULL, *temp = NULL;
+
+    check(array != NULL, "array is NULL.");
+    check(key_cb != NULL, "key_cb is NULL.");
+
+    d_array_linearize(array); // sorting works on contiguous block
+
+    cerb_size_t length = d_array_length(array), i;
+    if (length < 2) return CERB_OK;
+
+    items = cerb_alloc(array->allocator, sizeof(radix_item) * length);
+    check_mem(items);
+    temp = cerb_alloc(array->allocator, sizeof(radix_item) * length);
+    check_mem(temp);
+
+    // extract keys and count every byte of them in one pass
+    static const int passes = sizeof(uint64_t);
+    cerb_size_t (*counts)[256] = cerb_calloc(array->allocator, passes * sizeof(*counts));
+    check_mem(counts);
+
+    for (i = 0; i < length; i++) {
+        items[i].data = array->data[i];
+        items[i].key = key_cb(array->data[i]);
+
+        int pass;
+        for (pass = 0; pass < passes; pass++) {
+            counts[pass][(items[i].key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    int pass;
+    for (pass = 0; pass < passes; pass++) {
+        cerb_size_t *count = counts[pass];
+        unsigned shift = pass * 8;
+
+        // if every key has the same byte here, pass wouldn't change anything
+        if (count[(items[0].key >> shift) & 0xFF] == length) continue;
+
+        // turn counts into starting offsets
+        cerb_size_t offset = 0, bucket;
+        for (bucket = 0; bucket < 256; bucket++) {
+            cerb_size_t bucket_count = count[bucket];
+            count[bucket] = offset;
+            offset += bucket_count;
+        }
+
+        // scatter items in order, which makes every pass stable
+        for (i = 0; i < length; i++) {
+            temp[count[(items[i].key >> shift) & 0xFF]++] = items[i];
+        }
+
+        radix_item *swap = items;
+        items = temp;
+        temp = swap;
+    }
+
+    for (i = 0; i < length; i++) {
+        array->data[i] = items[i].data;
+    }
+
+    cerb_free(array->allocator, counts, passes * sizeof(*counts));
+    cerb_free(array->allocator, items, sizeof(radix_item) * length);
+    cerb_free(array->allocator, temp, sizeof(radix_item) * length);
+
+    return CERB_OK;
+
+error:
+    if (items) cerb_free(array->allocator, items, sizeof(radix_item) * d_array_length(array));
+    if (temp) cerb_free(array->allocator, temp, sizeof(radix_item) * d_array_length(array));
+    return CERB_ERR;
+}
+
+// quickselect [begin, end) so that *nth is in its sorted place (introselect, falls back to heap sort)
+static void select_nth(void **begin, void **nth, void **end, d_array_cmp compare, int bad_allowed)
+{
+    int leftmost = 1;
+
+    while (1) {
+        size_t size = end - begin;
+
+        if (size < INSERTION_SORT_THRESHOLD) {
+            insertion_sort(begin, end, compare);
+            return;
+        }
+
+        choose_pivot(begin, end, compare);
+
+        // pivot is equal to the element before range, so every element equal to it goes to the left at once
+        if (!leftmost && !LESS(compare, *(begin - 1), *begin)) {
+            void **pivot_position = partition_left(begin, end, compare);
+            if (nth <= pivot_position) return; // [begin, pivot_position] are all equal to pivot
+            begin = pivot_position + 1;
+            continue;
+        }
+
+        int already_partitioned = 0;
+        void **pivot_position = partition_right(begin, end, compare, &already_partitioned);
+        if (pivot_position == nth) return;
+
+        size_t left_size = pivot_position - begin, right_size = end - (pivot_position + 1);
+        if (left_size < size / 8 || right_size < size / 8) {
+            if (--bad_allowed == 0) {
+                heap_sort(begin, end, compare);
+                return;
+            }
+            break_patterns(begin, pivot_position, end);
+        }
+
+        // continue only in the part which contains nth
+        if (nth < pivot_position) {
+            end = pivot_position;
+        } else {
+            begin = pivot_position + 1;
+            leftmost = 0;
+        }
+    }
+}
+
+// rearrange array so that [position] holds the element which would be there if array was sorted
+int d_array_nth_element(d_array *array, cerb_size_t position)
+{
+    check(array != NULL, "array is NULL.");
+    check(position < d_array_length(array), "Invalid position.");
+
+    d_array_linearize(array); // selection works on contiguous block
+
+    select_nth(array->data, array->data + position, array->data + d_array_length(array), array->compare,
+    log2_floor(d_array_length(array)));
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// sort only the smallest count elements into [0] .. [count - 1]
+int d_array_partial_sort(d_array *array, cerb_size_t count)
+{
+    check(array != NULL, "array is NULL.");
+    check(count <= d_array_length(array), "count is greater than length.");
+
+    if (count == d_array_length(array)) return d_array_sort(array);
+    if (count == 0) return CERB_OK;
+
+    // select [count - 1] first, so that everything before it is the rest of the smallest elements, then sort them
+    int rc = d_array_nth_element(array, count - 1);
+    check(rc != CERB_ERR, "Failed to select elements.");
+
+    if (count > 2) {
+        pdq_sort(array->data, array->data + count - 1, array->compare, log2_floor(count), 1);
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -0,0 +1,36 @@
+#ifndef C3A8F1D2_6E4B_4F0A_9D27_5B1E8C0F3A64
+#define C3A8F1D2_6E4B_4F0A_9D27_5B1E8C0F3A64
+
+#include "d_array.h"
+
+// sorting and selection for d_array. every function orders elements ascending according to array->compare
+// (D_ARRAY_LESS first), use compare which returns opposite values for descending order.
+// ring arrays are linearized before sorting (see d_array_linearize)
+
+// extracts fixed-width unsigned key from data for radix sort (keys are ordered as unsigned 64-bit integers)
+typedef uint64_t (*d_array_key_cb) (const void *data);
+
+// turn signed key into unsigned one which keeps the order (use it in your d_array_key_cb for signed types)
+#define D_ARRAY_SIGNED_KEY(key) ((uint64_t) (int64_t) (key) ^ ((uint64_t) 1 << 63))
+
+// sort array with pattern-defeating quicksort (O(n log n) worst case, O(n) on sorted, reversed and equal runs)
+// sort is not stable, see d_array_stable_sort
+int d_array_sort(d_array *array);
+// sort array keeping relative order of equal elements (merge sort, allocates buffer of length / 2 pointers)
+int d_array_stable_sort(d_array *array);
+// stable sort of elements [from, to) only, the rest of array is left as it is
+int d_array_stable_sort_range(d_array *array, cerb_size_t from, cerb_size_t to);
+// stable sort of length pointers at begin with scratch buffer of at least length / 2 slots you provide (never
+// allocates, so threads can sort slices of one array with slices of one buffer, see d_array_parallel_sort)
+void d_array_stable_sort_block(void **begin, size_t length, void **buffer, d_array_cmp compare);
+// sort array by keys key_cb extracts (stable LSD radix sort, calls key_cb once per element and doesn't call compare)
+// allocates 2 buffers of length (key, pointer) pairs
+int d_array_radix_sort(d_array *array, d_array_key_cb key_cb);
+
+// rearrange array so that [position] holds the element which would be there if array was sorted, elements before it
+// are less or equal to it and elements after it are greater or equal to it (O(n) on average, for percentiles etc.)
+int d_array_nth_element(d_array *array, cerb_size_t position);
+// sort only the smallest count elements into [0] .. [count - 1], order of the rest is unspecified (for top-k)
+int d_array_partial_sort(d_array *array, cerb_size_t count);
+
+#endif /* C3A8F1D2_6E4B_4F0A_9D27_5B1E8C0F3A64 */
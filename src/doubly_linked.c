@@ -15,9 +15,17 @@ static inline int default_compare(const void *restrict data1, const void *restri
 
 doubly_linked *doubly_linked_create(doubly_linked_cmp cmp)
 {
-    doubly_linked *list = calloc(1, sizeof(doubly_linked));
+    return doubly_linked_create_with_allocator(cmp, NULL);
+}
+
+doubly_linked *doubly_linked_create_with_allocator(doubly_linked_cmp cmp, const cerb_allocator *allocator)
+{
+    allocator = cerb_allocator_or_default(allocator);
+
+    doubly_linked *list = cerb_calloc(allocator, sizeof(doubly_linked));
     check_mem(list);
 
+    list->allocator = allocator;
     list->compare = cmp == NULL ? default_compare : cmp;
     list->count = 0;
 
@@ -27,9 +35,9 @@ error:
     return NULL;
 }
 
-static inline doubly_linked_node *doubly_linkedNode_create()
+static inline doubly_linked_node *doubly_linkedNode_create(doubly_linked *list)
 {
-    doubly_linked_node *node = calloc(1, sizeof(doubly_linked_node));
+    doubly_linked_node *node = cerb_calloc(list->allocator, sizeof(doubly_linked_node));
     check_mem(node);
 
     return node;
@@ -45,9 +53,9 @@ int doubly_linked_push(doubly_linked *restrict list, void *restrict data)
 {
     check(list != NULL, "list is NULL.");
     check(data != NULL, "data is NULL.");
-    check(list->count < UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(list->count < CERB_SIZE_MAX, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
 
-    doubly_linked_node *new_node = doubly_linkedNode_create();
+    doubly_linked_node *new_node = doubly_linkedNode_create(list);
     check(new_node != NULL, "Failed to push in list.");
     new_node->data = data;
 
@@ -73,9 +81,9 @@ int doubly_linked_unshift(doubly_linked *restrict list, void *restrict data)
 {
     check(list != NULL, "list is NULL.");
     check(data != NULL, "data is NULL.");
-    check(list->count < UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(list->count < CERB_SIZE_MAX, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
 
-    doubly_linked_node *new_node = doubly_linkedNode_create();
+    doubly_linked_node *new_node = doubly_linkedNode_create(list);
     check(new_node != NULL, "Failed to push in list.");
     new_node->data = data;
 
@@ -114,7 +122,7 @@ int doubly_linked_insert_after(doubly_linked *restrict list, void *restrict entr
     check(list != NULL, "list is NULL.");
     check(entry != NULL, "entry is NULL.");
     check(data != NULL, "data is NULL.");
-    check(list->count < UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(list->count < CERB_SIZE_MAX, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
 
     doubly_linked_node *node; // initialized in else if block
 
@@ -123,7 +131,7 @@ int doubly_linked_insert_after(doubly_linked *restrict list, void *restrict entr
         check(rc != CERB_ERR, "Failed insert after %p", entry);
         return rc;
     } else if ((node = in_list(list, entry)) != NULL) {
-        doubly_linked_node *new_node = doubly_linkedNode_create();
+        doubly_linked_node *new_node = doubly_linkedNode_create(list);
         check(new_node != NULL, "Failed to insert after %p.", entry);
         new_node->data = data;
 
@@ -148,7 +156,7 @@ int doubly_linked_insert_before(doubly_linked *restrict list, void *restrict ent
     check(list != NULL, "list is NULL.");
     check(entry != NULL, "entry is NULL.");
     check(data != NULL, "data is NULL.");
-    check(list->count < UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(list->count < CERB_SIZE_MAX, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
 
     doubly_linked_node *node; // initialized in else if block
 
@@ -157,7 +165,7 @@ int doubly_linked_insert_before(doubly_linked *restrict list, void *restrict ent
         check(rc != CERB_ERR, "Failed to insert before %p", entry);
         return rc;
     } else if ((node = in_list(list, entry)) != NULL) {
-        doubly_linked_node *new_node = doubly_linkedNode_create();
+        doubly_linked_node *new_node = doubly_linkedNode_create(list);
         check(new_node != NULL, "Failed to insert before %p", entry);
         new_node->data = data;
 
@@ -189,13 +197,13 @@ void *doubly_linked_pop(doubly_linked *restrict list)
     data = list->last->data;
 
     if (list->count == 1) {
-        free(list->last);
+        cerb_free(list->allocator, list->last, sizeof(doubly_linked_node));
         list->first = NULL;
         list->last = NULL;
         list->count = 0; // or --; as count gets 0
     } else {
         doubly_linked_node *new_last = list->last->prev;
-        free(list->last);
+        cerb_free(list->allocator, list->last, sizeof(doubly_linked_node));
         list->last = new_last;
         new_last->next = NULL;
         list->count--;
@@ -216,13 +224,13 @@ void *doubly_linked_shift(doubly_linked *restrict list)
     data = list->first->data;
 
     if (list->count == 1) {
-        free(list->first);
+        cerb_free(list->allocator, list->first, sizeof(doubly_linked_node));
         list->first = NULL;
         list->last = NULL;
         list->count = 0;
     } else {
         doubly_linked_node *new_first = list->first->next;
-        free(list->first);
+        cerb_free(list->allocator, list->first, sizeof(doubly_linked_node));
         list->first = new_first;
         new_first->prev = NULL;
         list->count--;
@@ -250,7 +258,7 @@ void *doubly_linked_remove(doubly_linked *restrict list, void *restrict entry)
         data = node->data;
         node->prev->next = node->next;
         node->next->prev = node->prev;
-        free(node);
+        cerb_free(list->allocator, node, sizeof(doubly_linked_node));
         list->count--;
     } else {
         log_err("entry %p doesn't belong to this list.", entry);
@@ -279,7 +287,7 @@ void *doubly_linked_remove_after(doubly_linked *restrict list, void *restrict en
         node->next->prev = node;
 
         data = delete_node->data;
-        free(delete_node);
+        cerb_free(list->allocator, delete_node, sizeof(doubly_linked_node));
         list->count--;
     } else {
         log_err("entry %p doesn't belong to this list.", entry);
@@ -308,7 +316,7 @@ void *doubly_linked_remove_before(doubly_linked *restrict list, void *restrict e
         node->prev->next = node;
 
         data = delete_node->data;
-        free(delete_node);
+        cerb_free(list->allocator, delete_node, sizeof(doubly_linked_node));
         list->count--;
     } else {
         log_err("entry %p doesn't belong to this list.", entry);
@@ -346,15 +354,17 @@ int doubly_linked_join(doubly_linked *restrict *restrict list1, doubly_linked *r
     check(*list2 != NULL, "list2 is NULL.");
     check((*list1)->count != 0, "Doesn't make sense to join to an empty list.");
     check((*list2)->count != 0, "Doesn't make sense to join an empty list.");
-    check((*list1)->count + (*list2)->count <= UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(CERB_SIZE_FITS((uint64_t) (*list1)->count + (*list2)->count),
+    "Can't expand past max available size, AKA CERB_SIZE_MAX.");
     check((*list1)->compare == (*list2)->compare, "Couldn't join lists of different cmp_templates");
+    check((*list1)->allocator == (*list2)->allocator, "Couldn't join lists of different allocators");
 
     (*list1)->last->next = (*list2)->first;
     (*list2)->first->prev = (*list1)->last;
     (*list1)->last = (*list2)->last;
     (*list1)->count += (*list2)->count;
 
-    free(*list2);
+    cerb_free((*list2)->allocator, *list2, sizeof(doubly_linked));
     *list2 = NULL;
 
     return CERB_OK;
@@ -392,12 +402,12 @@ doubly_linked_node *restrict to_node)
     }
 
     doubly_linked *new_list = NULL;
-    uint32_t count = 0;
+    cerb_size_t count = 0;
 
     if (from_node == NULL) {
         check(to_node->next, "Doesn't make sense to split from first including last.");
 
-        new_list = doubly_linked_create((*list)->compare);
+        new_list = doubly_linked_create_with_allocator((*list)->compare, (*list)->allocator);
         check(new_list != NULL, "Couldn't create new list.");
 
         new_list->first = (*list)->first;
@@ -409,7 +419,7 @@ doubly_linked_node *restrict to_node)
     } else if (to_node == NULL) {
         check(from_node != (*list)->first, "Doesn't make sense to split from first including last.");
 
-        new_list = doubly_linked_create((*list)->compare);
+        new_list = doubly_linked_create_with_allocator((*list)->compare, (*list)->allocator);
         check(new_list != NULL, "Couldn't create new list.");
 
         new_list->first = from_node;
@@ -427,7 +437,7 @@ doubly_linked_node *restrict to_node)
             return new_list;
         }
 
-        new_list = doubly_linked_create((*list)->compare);
+        new_list = doubly_linked_create_with_allocator((*list)->compare, (*list)->allocator);
         check(new_list != NULL, "Couldn't create new list.");
 
         from_node->prev->next = to_node->next;
@@ -483,9 +493,9 @@ int doubly_linked_destroy(doubly_linked *restrict *restrict list, doubly_linked_
         freeable = first;
         first = first->next;
         dealloc_cb(freeable->data);
-        free(freeable);
+        cerb_free((*list)->allocator, freeable, sizeof(doubly_linked_node));
     }
-    free(*list);
+    cerb_free((*list)->allocator, *list, sizeof(doubly_linked));
     *(list) = NULL;
 
     return CERB_OK;
@@ -508,14 +518,14 @@ int doubly_linked_clear_destroy(doubly_linked **list)
     for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next)
     {
         free(cur_node->data);
-        free(cur_node);
+        cerb_free((*list)->allocator, cur_node, sizeof(doubly_linked_node));
         cur_node = next_node;
     }
     free(cur_node->data);
-    free(cur_node); // free the last one and we are done
+    cerb_free((*list)->allocator, cur_node, sizeof(doubly_linked_node)); // free the last one and we are done
 
 empty_list: // fall through
-    free(*list);
+    cerb_free((*list)->allocator, *list, sizeof(doubly_linked));
     *list = NULL;
 
     return CERB_OK;
@@ -536,9 +546,9 @@ int doubly_linked_free_complex_data(doubly_linked **list, doubly_linked_dealloc
         freeable = first;
         first = first->next;
         handler_func(freeable->data);
-        free(freeable);
+        cerb_free((*list)->allocator, freeable, sizeof(doubly_linked_node));
     }
-    free(*(list));
+    cerb_free((*list)->allocator, *list, sizeof(doubly_linked));
     *(list) = NULL;
 
     return CERB_OK;
@@ -554,10 +564,10 @@ int doubly_linked_free_list(doubly_linked **list)
 
     doubly_linked_iter(*list, first, next, cur)
     {
-        free(cur);
+        cerb_free((*list)->allocator, cur, sizeof(doubly_linked_node));
     }
 
-    free(*list);
+    cerb_free((*list)->allocator, *list, sizeof(doubly_linked));
 
     *list = NULL;
 
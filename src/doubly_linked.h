@@ -2,6 +2,8 @@
 #define A7E33D4E_E4E9_4637_8A99_8C8A1F279553
 
 #include <stdint.h>
+#include "cerb_size.h"
+#include "allocator.h"
 #include "dbg.h"
 
 #define CERB_OK 0
@@ -26,11 +28,14 @@ typedef struct doubly_linked {
     doubly_linked_node *first; // first node
     doubly_linked_node *last; // last node
     doubly_linked_cmp compare; // compare callback
-    uint32_t count;
+    const cerb_allocator *allocator; // allocator of struct and nodes (see allocator.h)
+    cerb_size_t count;
 } doubly_linked;
 
 // create doubly_linked *list ( specify cmp if you need to sorted insert )
 doubly_linked *doubly_linked_create(doubly_linked_cmp cmp); //
+// create list which allocates struct and nodes with allocator (NULL means cerb_libc_allocator)
+doubly_linked *doubly_linked_create_with_allocator(doubly_linked_cmp cmp, const cerb_allocator *allocator);
 // push data in list
 int doubly_linked_push(doubly_linked *restrict list, void *restrict data); //
 // pop data and return
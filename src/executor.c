@@ -0,0 +1,178 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include "executor.h"
+
+// take chunks of current loop until there are none left
+static void executor_run_chunks(cerb_executor *executor, cerb_task task, void *context, size_t count, size_t grain)
+{
+    size_t chunks = (count + grain - 1) / grain;
+
+    for (;;) {
+        size_t chunk = __atomic_fetch_add(&executor->next_chunk, 1, __ATOMIC_RELAXED);
+        if (chunk >= chunks) break;
+
+        size_t begin = chunk * grain;
+        size_t end = count - begin < grain ? count : begin + grain;
+        task(context, begin, end);
+    }
+}
+
+// worker thread waits for new loop, helps with it and reports back when no chunks are left
+static void *executor_worker(void *arg)
+{
+    cerb_executor *executor = arg;
+    uint64_t seen_generation = 0;
+
+    pthread_mutex_lock(&executor->lock);
+    for (;;) {
+        while (!executor->shutdown && executor->generation == seen_generation) {
+            pthread_cond_wait(&executor->work_ready, &executor->lock);
+        }
+        if (executor->shutdown) break;
+
+        seen_generation = executor->generation;
+        cerb_task task = executor->task;
+        void *context = executor->context;
+        size_t count = executor->count, grain = executor->grain;
+        pthread_mutex_unlock(&executor->lock);
+
+        executor_run_chunks(executor, task, context, count, grain);
+
+        pthread_mutex_lock(&executor->lock);
+        if (--executor->busy_workers == 0) pthread_cond_signal(&executor->work_done);
+    }
+    pthread_mutex_unlock(&executor->lock);
+
+    return NULL;
+}
+
+// create executor with thread_count threads (0 means number of online processors)
+cerb_executor *cerb_executor_create(uint32_t thread_count)
+{
+    cerb_executor *executor = NULL;
+    uint32_t started = 0;
+
+    if (thread_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (uint32_t) online : 1;
+    }
+
+    executor = calloc(1, sizeof(cerb_executor));
+    check_mem(executor);
+
+    executor->thread_count = thread_count;
+
+    check(pthread_mutex_init(&executor->lock, NULL) == 0, "Failed to initialize mutex.");
+    check(pthread_mutex_init(&executor->run_lock, NULL) == 0, "Failed to initialize mutex.");
+    check(pthread_cond_init(&executor->work_ready, NULL) == 0, "Failed to initialize condition variable.");
+    check(pthread_cond_init(&executor->work_done, NULL) == 0, "Failed to initialize condition variable.");
+
+    if (thread_count > 1) {
+        executor->threads = malloc(sizeof(pthread_t) * (thread_count - 1));
+        check_mem(executor->threads);
+
+        for (started = 0; started < thread_count - 1; started++) {
+            check(pthread_create(&executor->threads[started], NULL, executor_worker, executor) == 0,
+                  "Failed to start worker thread.");
+        }
+    }
+
+    return executor;
+
+error:
+    if (executor) {
+        // stop whatever has been started, primitives are only used by running workers
+        pthread_mutex_lock(&executor->lock);
+        executor->shutdown = 1;
+        pthread_cond_broadcast(&executor->work_ready);
+        pthread_mutex_unlock(&executor->lock);
+        while (started > 0) pthread_join(executor->threads[--started], NULL);
+        free(executor->threads);
+        free(executor);
+    }
+    return NULL;
+}
+
+// run task over [0, count) in chunks of grain iterations and wait for all of them
+int cerb_executor_parallel_for(cerb_executor *executor, size_t count, size_t grain, cerb_task task, void *context)
+{
+    check(executor != NULL, "executor is NULL.");
+    check(task != NULL, "task is NULL.");
+
+    if (count == 0) return CERB_OK;
+
+    if (grain == 0) {
+        // few chunks per thread so that threads which finish early can pick up the rest
+        grain = count / ((size_t) executor->thread_count * 4);
+        if (grain == 0) grain = 1;
+    }
+
+    // single thread or single chunk, no need to wake anybody up
+    if (executor->thread_count == 1 || count <= grain) {
+        size_t begin;
+        for (begin = 0; begin < count; begin += grain) {
+            task(context, begin, count - begin < grain ? count : begin + grain);
+        }
+        return CERB_OK;
+    }
+
+    pthread_mutex_lock(&executor->run_lock);
+
+    pthread_mutex_lock(&executor->lock);
+    executor->task = task;
+    executor->context = context;
+    executor->count = count;
+    executor->grain = grain;
+    executor->next_chunk = 0;
+    executor->busy_workers = executor->thread_count - 1;
+    executor->generation++;
+    pthread_cond_broadcast(&executor->work_ready);
+    pthread_mutex_unlock(&executor->lock);
+
+    executor_run_chunks(executor, task, context, count, grain); // calling thread does its share
+
+    // wait until every worker leaves the loop, then nothing refers to task and context anymore
+    pthread_mutex_lock(&executor->lock);
+    while (executor->busy_workers > 0) pthread_cond_wait(&executor->work_done, &executor->lock);
+    pthread_mutex_unlock(&executor->lock);
+
+    pthread_mutex_unlock(&executor->run_lock);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// stop threads and deallocate executor
+int cerb_executor_destroy(cerb_executor **executor)
+{
+    check(executor != NULL, "executor is NULL.");
+    check(*executor != NULL, "*executor is NULL.");
+
+    cerb_executor *target = *executor;
+    uint32_t i;
+
+    pthread_mutex_lock(&target->lock);
+    target->shutdown = 1;
+    pthread_cond_broadcast(&target->work_ready);
+    pthread_mutex_unlock(&target->lock);
+
+    for (i = 0; target->threads && i < target->thread_count - 1; i++) {
+        pthread_join(target->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&target->work_ready);
+    pthread_cond_destroy(&target->work_done);
+    pthread_mutex_destroy(&target->run_lock);
+    pthread_mutex_destroy(&target->lock);
+    free(target->threads);
+    free(target);
+
+    *executor = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
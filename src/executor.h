@@ -0,0 +1,49 @@
+#ifndef D4E9A2B7_1F3C_4B8E_A6D0_8C5F2E7B9A13
+#define D4E9A2B7_1F3C_4B8E_A6D0_8C5F2E7B9A13
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "dbg.h"
+
+#define CERB_OK  0
+#define CERB_ERR -1
+
+// small fork-join executor: a fixed set of pthreads which run chunks of one parallel loop at a time.
+// thread calling cerb_executor_parallel_for works on chunks too and returns only after every chunk is done.
+// parallel loops of the same executor are serialized, don't start one from inside a task (it would deadlock)
+
+// get number of threads executor runs loops on (including the calling one)
+#define cerb_executor_thread_count(executor_ptr) ((executor_ptr)->thread_count)
+
+// task runs one chunk [begin, end) of a parallel loop with context passed to cerb_executor_parallel_for
+typedef void (*cerb_task) (void *context, size_t begin, size_t end);
+
+typedef struct cerb_executor {
+    pthread_t *threads; // worker threads (thread_count - 1 of them, calling thread is the last worker)
+    pthread_mutex_t lock; // protects everything below
+    pthread_cond_t work_ready; // signaled when new loop starts or executor shuts down
+    pthread_cond_t work_done; // signaled when last worker leaves a loop
+    pthread_mutex_t run_lock; // serializes parallel loops started from different threads
+    cerb_task task; // task of current loop
+    void *context; // context of current loop
+    size_t count; // number of iterations of current loop
+    size_t grain; // number of iterations per chunk
+    size_t next_chunk; // next chunk to be taken (accessed atomically)
+    uint64_t generation; // incremented by every loop, so that workers notice new work
+    uint32_t busy_workers; // number of workers still inside current loop
+    uint32_t thread_count; // number of threads (including calling one)
+    int shutdown; // set when executor is being destroyed
+} cerb_executor;
+
+// create executor with thread_count threads (0 means number of online processors)
+cerb_executor *cerb_executor_create(uint32_t thread_count);
+
+// run task over [0, count) in chunks of grain iterations (0 picks grain giving each thread several chunks)
+// returns after every chunk has been run
+int cerb_executor_parallel_for(cerb_executor *executor, size_t count, size_t grain, cerb_task task, void *context);
+
+// stop threads, deallocate executor and set it to NULL on stack (you need to provide reference to executor)
+int cerb_executor_destroy(cerb_executor **executor);
+
+#endif /* D4E9A2B7_1F3C_4B8E_A6D0_8C5F2E7B9A13 */
@@ -0,0 +1,236 @@
+#include <stdlib.h>
+#include <string.h>
+#include "flatmap.h"
+#include "d_array_sort.h"
+
+// create flatmap on top of sorted d_array
+cerb_flatmap *cerb_flatmap_create(d_array_cmp compare, cerb_size_t initial_capacity)
+{
+    return cerb_flatmap_create_with_allocator(compare, initial_capacity, NULL);
+}
+
+// create flatmap whose struct, items and merge buffers come from allocator
+cerb_flatmap *cerb_flatmap_create_with_allocator(d_array_cmp compare, cerb_size_t initial_capacity,
+                                                 const cerb_allocator *allocator)
+{
+    allocator = cerb_allocator_or_default(allocator);
+
+    cerb_flatmap *map = cerb_alloc(allocator, sizeof(cerb_flatmap));
+    check_mem(map);
+
+    map->items = d_array_create_with_allocator(compare, initial_capacity, allocator);
+    check(map->items != NULL, "Failed to create items array.");
+
+    return map;
+
+error:
+    cerb_free(allocator, map, sizeof(cerb_flatmap));
+    return NULL;
+}
+
+// branchless binary search: range only shrinks from the top, base moves forward with conditional move instead of jump,
+// so there are no mispredictions and loop runs exactly log2(length) times. upper selects first element greater than key
+static inline cerb_size_t flatmap_bound(const d_array *items, const void *key, int upper)
+{
+    void **base = items->data;
+    cerb_size_t length = items->length;
+    d_array_cmp compare = items->compare;
+
+    if (length == 0) return 0;
+
+    while (length > 1) {
+        cerb_size_t half = length / 2;
+        int result = compare(base[half], key);
+        base = (upper ? result <= 0 : result < 0) ? base + half : base;
+        length -= half;
+    }
+
+    int result = compare(*base, key);
+    return (cerb_size_t) (base - items->data) + (upper ? result <= 0 : result < 0);
+}
+
+// position of first element which is not less than key
+cerb_size_t cerb_flatmap_lower_bound(cerb_flatmap *map, const void *key)
+{
+    check(map != NULL, "map is NULL.");
+
+    return flatmap_bound(map->items, key, 0);
+
+error:
+    return 0;
+}
+
+// position of first element which is greater than key
+cerb_size_t cerb_flatmap_upper_bound(cerb_flatmap *map, const void *key)
+{
+    check(map != NULL, "map is NULL.");
+
+    return flatmap_bound(map->items, key, 1);
+
+error:
+    return 0;
+}
+
+// positions [from, to) of elements equal to key
+int cerb_flatmap_equal_range(cerb_flatmap *map, const void *key, cerb_size_t *from, cerb_size_t *to)
+{
+    check(map != NULL, "map is NULL.");
+    check(from != NULL && to != NULL, "from or to is NULL.");
+
+    *from = flatmap_bound(map->items, key, 0);
+
+    // upper bound can't be before lower bound, search only the rest if there is an equal element at all
+    if (*from < map->items->length && map->items->compare(map->items->data[*from], key) == 0) {
+        d_array rest = *map->items;
+        rest.data += *from;
+        rest.length -= *from;
+        *to = *from + flatmap_bound(&rest, key, 1);
+    } else {
+        *to = *from;
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// first element equal to key or NULL
+void *cerb_flatmap_search(cerb_flatmap *map, const void *key)
+{
+    check(map != NULL, "map is NULL.");
+
+    cerb_size_t position = flatmap_bound(map->items, key, 0);
+    if (position < map->items->length && map->items->compare(map->items->data[position], key) == 0) {
+        return map->items->data[position];
+    }
+
+error: // fallthrough
+    return NULL;
+}
+
+// insert data after elements equal to it
+int cerb_flatmap_insert(cerb_flatmap *map, void *data)
+{
+    check(map != NULL, "map is NULL.");
+
+    cerb_size_t position = flatmap_bound(map->items, data, 1);
+
+    if (position == map->items->length) return d_array_push_back(map->items, data);
+    return d_array_insert_at(map->items, position, data);
+
+error:
+    return CERB_ERR;
+}
+
+// append, sort new elements and merge them with existing ones from the back (no element is moved twice)
+int cerb_flatmap_insert_batch(cerb_flatmap *map, void *const *data, cerb_size_t n)
+{
+    void **batch = NULL;
+    cerb_size_t old_length = 0;
+    int appended = 0;
+
+    check(map != NULL, "map is NULL.");
+    check(data != NULL || n == 0, "data is NULL.");
+
+    if (n == 0) return CERB_OK;
+
+    d_array *items = map->items;
+    old_length = items->length;
+
+    // merge buffer is allocated before anything is appended, so that failing to get it leaves map untouched
+    if (old_length) {
+        batch = cerb_alloc(items->allocator, sizeof(void *) * n);
+        check_mem(batch);
+    }
+
+    check(d_array_push_back_n(items, data, n) == CERB_OK, "Failed to append batch.");
+    appended = 1;
+    check(d_array_stable_sort_range(items, old_length, old_length + n) == CERB_OK, "Failed to sort batch.");
+
+    // whole batch goes after existing elements (appending in order), nothing to merge
+    if (old_length == 0 || items->compare(items->data[old_length], items->data[old_length - 1]) >= 0) {
+        if (batch) cerb_free(items->allocator, batch, sizeof(void *) * n);
+        return CERB_OK;
+    }
+
+    memcpy(batch, items->data + old_length, sizeof(void *) * n);
+
+    // fill from the back, on ties batch element goes first (it is later in order) so equal elements keep insertion order
+    void **old = items->data + old_length, **out = items->data + old_length + n, **next = batch + n;
+    while (next > batch && old > items->data) {
+        *--out = items->compare(*(next - 1), *(old - 1)) >= 0 ? *--next : *--old;
+    }
+    // rest of old elements is in place already
+    memcpy(items->data, batch, sizeof(void *) * (next - batch));
+
+    cerb_free(items->allocator, batch, sizeof(void *) * n);
+
+    return CERB_OK;
+
+error:
+    // unsorted batch would break every binary search, so it is taken back out
+    if (appended) map->items->length = old_length;
+    if (batch) cerb_free(map->items->allocator, batch, sizeof(void *) * n);
+    return CERB_ERR;
+}
+
+// delete first element equal to key and return it
+void *cerb_flatmap_delete(cerb_flatmap *map, const void *key)
+{
+    check(map != NULL, "map is NULL.");
+
+    cerb_size_t position = flatmap_bound(map->items, key, 0);
+    if (position < map->items->length && map->items->compare(map->items->data[position], key) == 0) {
+        return d_array_remove_at(map->items, position);
+    }
+
+error: // fallthrough
+    return NULL;
+}
+
+// apply traverse_cb to every element in ascending order
+int cerb_flatmap_traverse(cerb_flatmap *map, d_array_traverse_cb traverse_cb)
+{
+    check(map != NULL, "map is NULL.");
+
+    return d_array_traverse(map->items, traverse_cb);
+
+error:
+    return CERB_ERR;
+}
+
+// apply traverse_cb to elements in [from_key, to_key) in ascending order
+int cerb_flatmap_traverse_range(cerb_flatmap *map, const void *from_key, const void *to_key, d_array_traverse_cb traverse_cb)
+{
+    check(map != NULL, "map is NULL.");
+    check(traverse_cb != NULL, "traverse_cb is NULL.");
+
+    cerb_size_t i = flatmap_bound(map->items, from_key, 0), to = flatmap_bound(map->items, to_key, 0);
+    for (; i < to; i++) {
+        check(traverse_cb(map->items->data[i]) == CERB_OK, "traverse_cb failed.");
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// deallocate flatmap and its elements
+int cerb_flatmap_destroy(cerb_flatmap **map, d_array_dealloc dealloc_cb)
+{
+    check(map != NULL, "map is NULL.");
+    check(*map != NULL, "*map is NULL.");
+
+    const cerb_allocator *allocator = (*map)->items->allocator;
+
+    check(d_array_destroy(&(*map)->items, dealloc_cb) == CERB_OK, "Failed to destroy items.");
+    cerb_free(allocator, *map, sizeof(cerb_flatmap));
+    *map = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
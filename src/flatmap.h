@@ -0,0 +1,52 @@
+#ifndef B8E3D1A6_4C7F_4A92_9E05_6D2A8F1C3B47
+#define B8E3D1A6_4C7F_4A92_9E05_6D2A8F1C3B47
+
+#include <stdint.h>
+#include "d_array.h"
+
+// sorted vector: ordered container which keeps elements in one sorted d_array instead of tree nodes.
+// lookups are binary searches over contiguous memory, single inserts and deletes shift elements (O(n)),
+// so insert many elements at once with cerb_flatmap_insert_batch. equal elements are allowed and keep insertion order.
+// keys you search with are passed to compare as second argument, so they have to look like elements (as in BS_tree)
+
+// get count of elements in flatmap
+#define cerb_flatmap_length(map_ptr) ((map_ptr)->items->length)
+// get element at position (elements are in ascending order, so this is in-order iteration with a plain loop)
+#define cerb_flatmap_at(map_ptr, position) ((map_ptr)->items->data[position])
+
+typedef struct cerb_flatmap {
+    d_array *items; // sorted elements (always in D_ARRAY_LINEAR mode)
+} cerb_flatmap;
+
+// create flatmap, compare orders elements (if NULL, default one from d_array compares ints)
+cerb_flatmap *cerb_flatmap_create(d_array_cmp compare, cerb_size_t initial_capacity);
+// same as cerb_flatmap_create, but memory comes from allocator (NULL means cerb_libc_allocator)
+cerb_flatmap *cerb_flatmap_create_with_allocator(d_array_cmp compare, cerb_size_t initial_capacity,
+                                                 const cerb_allocator *allocator);
+
+// position of first element which is not less than key (length if there is no such element)
+cerb_size_t cerb_flatmap_lower_bound(cerb_flatmap *map, const void *key);
+// position of first element which is greater than key (length if there is no such element)
+cerb_size_t cerb_flatmap_upper_bound(cerb_flatmap *map, const void *key);
+// positions [from, to) of elements equal to key (from == to if there are none)
+int cerb_flatmap_equal_range(cerb_flatmap *map, const void *key, cerb_size_t *from, cerb_size_t *to);
+// first element equal to key or NULL
+void *cerb_flatmap_search(cerb_flatmap *map, const void *key);
+
+// insert data after elements equal to it
+int cerb_flatmap_insert(cerb_flatmap *map, void *data);
+// insert n elements at once: they are appended, sorted and merged with existing ones in one pass (O(n log n + length))
+int cerb_flatmap_insert_batch(cerb_flatmap *map, void *const *data, cerb_size_t n);
+
+// delete first element equal to key and return it (deallocating returned data is your responsibility), NULL if not found
+void *cerb_flatmap_delete(cerb_flatmap *map, const void *key);
+
+// apply traverse_cb to every element in ascending order (stops and returns CERB_ERR if traverse_cb fails)
+int cerb_flatmap_traverse(cerb_flatmap *map, d_array_traverse_cb traverse_cb);
+// same as cerb_flatmap_traverse, but only for elements in [from_key, to_key)
+int cerb_flatmap_traverse_range(cerb_flatmap *map, const void *from_key, const void *to_key, d_array_traverse_cb traverse_cb);
+
+// deallocate flatmap and set it to NULL on stack (you need to provide reference to flatmap), see d_array_destroy
+int cerb_flatmap_destroy(cerb_flatmap **map, d_array_dealloc dealloc_cb);
+
+#endif /* B8E3D1A6_4C7F_4A92_9E05_6D2A8F1C3B47 */
@@ -1,21 +1,154 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include "hashmap.h"
+#include "simd_search.h"
 
-const uint32_t FNV_PRIME = 16777619;
-const uint32_t FNV_OFFSET_BASIS = 2166136261;
+// bump counter of map when it is built with CERB_HASHMAP_COUNTERS (does nothing otherwise)
+#ifdef CERB_HASHMAP_COUNTERS
+#define HASHMAP_COUNT(map, counter) ((map)->counters.counter++)
+#else
+#define HASHMAP_COUNT(map, counter) ((void) 0)
+#endif
 
-// fnv1a hash (default)
-static uint32_t default_hash(void *data)
+// hint cpu to start loading address into cache (read, keep it), does nothing where builtin isn't there
+#if defined(__GNUC__)
+#define HASHMAP_PREFETCH(address) __builtin_prefetch((address), 0, 3)
+#else
+#define HASHMAP_PREFETCH(address) ((void) (address))
+#endif
+
+// secret of wyhash (public domain), every word is mixed with one of these
+static const uint64_t HASH_SECRET[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+// multiply a and b into 128 bits and fold the halves (one mul instruction on 64-bit CPUs)
+static inline void hash_mul128(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t) *a * *b;
+    *a = (uint64_t) product;
+    *b = (uint64_t) (product >> 64);
+#else
+    uint64_t a_high = *a >> 32, a_low = (uint32_t) *a, b_high = *b >> 32, b_low = (uint32_t) *b;
+    uint64_t high_high = a_high * b_high, high_low = a_high * b_low, low_high = a_low * b_high, low_low = a_low * b_low;
+    uint64_t middle = (low_low >> 32) + (uint32_t) high_low + (uint32_t) low_high;
+    *a = (middle << 32) | (uint32_t) low_low;
+    *b = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+#endif
+}
+
+static inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+    hash_mul128(&a, &b);
+    return a ^ b;
+}
+
+// unaligned little loads (memcpy compiles to plain mov)
+static inline uint64_t hash_read64(const uint8_t *p)
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t hash_read32(const uint8_t *p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// wyhash: reads 8 bytes at a time (48 per round for long keys, in three independent lanes), short keys are
+// read with overlapping loads, so there is no loop and no branch per byte
+uint64_t Hashmap_hash_bytes(const void *data, size_t length, uint64_t seed)
+{
+    const uint8_t *p = data;
+    uint64_t a, b;
+
+    seed ^= hash_mix(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+
+    if (length <= 16) {
+        if (length >= 4) {
+            size_t quarter = (length >> 3) << 2;
+            a = (hash_read32(p) << 32) | hash_read32(p + quarter);
+            b = (hash_read32(p + length - 4) << 32) | hash_read32(p + length - 4 - quarter);
+        } else if (length > 0) {
+            a = ((uint64_t) p[0] << 16) | ((uint64_t) p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t left = length;
+        if (left > 48) {
+            uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = hash_mix(hash_read64(p) ^ HASH_SECRET[1], hash_read64(p + 8) ^ seed);
+                lane1 = hash_mix(hash_read64(p + 16) ^ HASH_SECRET[2], hash_read64(p + 24) ^ lane1);
+                lane2 = hash_mix(hash_read64(p + 32) ^ HASH_SECRET[3], hash_read64(p + 40) ^ lane2);
+                p += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (left > 16) {
+            seed = hash_mix(hash_read64(p) ^ HASH_SECRET[1], hash_read64(p + 8) ^ seed);
+            p += 16;
+            left -= 16;
+        }
+        // last 16 bytes (overlapping with ones already read if needed)
+        a = hash_read64(p + left - 16);
+        b = hash_read64(p + left - 8);
+    }
+
+    a ^= HASH_SECRET[1];
+    b ^= seed;
+    hash_mul128(&a, &b);
+
+    return hash_mix(a ^ HASH_SECRET[0] ^ length, b ^ HASH_SECRET[1]);
+}
+
+// seeded hash of nul terminated string (default)
+uint64_t Hashmap_hash_string(const void *data, uint64_t seed)
+{
+    return Hashmap_hash_bytes(data, strlen((const char *) data), seed);
+}
+
+// random seed for map, so that colliding keys can't be chosen in advance
+uint64_t Hashmap_random_seed(const void *map)
 {
-    uint32_t hash = FNV_OFFSET_BASIS;
+    static uint64_t process_secret = 0, counter = 0;
 
-    int i = 0, len = strlen((char *) data);
-    for (i = 0; i < len; i++) {
-        hash ^= i < len ? ((char *) data)[i] : 0;
-        hash *= FNV_PRIME;
+    uint64_t secret = __atomic_load_n(&process_secret, __ATOMIC_RELAXED);
+    if (!secret) {
+        FILE *random = fopen("/dev/urandom", "rb");
+        if (!random || fread(&secret, sizeof(secret), 1, random) != 1) secret = (uint64_t) time(NULL);
+        if (random) fclose(random);
+        secret |= 1; // never 0, so that it is read only once
+        __atomic_store_n(&process_secret, secret, __ATOMIC_RELAXED);
     }
 
-    return hash;
+    // every map gets its own seed even if they are created at the same time
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t input[4] = {
+        (uint64_t) now.tv_sec, (uint64_t) now.tv_nsec, (uint64_t) (uintptr_t) map,
+        __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED)
+    };
+
+    return Hashmap_hash_bytes(input, sizeof(input), secret);
+}
+
+// internally used to hash data with hash callback of map, or seeded one (whose 64-bit hash is folded)
+static inline uint32_t Hashmap_hash_of(Hashmap *map, void *data)
+{
+    if (map->hash) return map->hash(data);
+
+    uint64_t hash = map->seeded_hash(data, map->seed);
+    return (uint32_t) (hash ^ (hash >> 32));
 }
 
 // default compare type is integer
@@ -30,56 +163,216 @@ int Hashmap_default_compare(const void *restrict data1, const void *restrict dat
     }
 }
 
-Hashmap *Hashmap_create(Hashmap_cmp cmp, hash hash, uint32_t number_of_entries)
+Hashmap *Hashmap_create(Hashmap_cmp cmp, hash hash, cerb_size_t number_of_entries)
+{
+    return Hashmap_create_with_allocator(cmp, hash, number_of_entries, NULL);
+}
+
+Hashmap *Hashmap_create_with_allocator(Hashmap_cmp cmp, hash hash, cerb_size_t number_of_entries,
+const cerb_allocator *allocator)
+{
+    Hashmap_config config = {cmp, hash, number_of_entries, allocator, HASHMAP_CHAINED, 0, NULL, 0};
+    return Hashmap_create_with_config(&config);
+}
+
+// internally used to allocate robin hood table of capacity (power of 2) empty slots
+static int robin_hood_alloc(Hashmap *map, cerb_size_t capacity)
+{
+    map->slots = cerb_calloc(map->allocator, sizeof(Hashmap_slot) * capacity);
+    check_mem(map->slots);
+
+    map->capacity = capacity;
+    map->shift = 64;
+    while (capacity > 1) {
+        map->shift--;
+        capacity >>= 1;
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+Hashmap *Hashmap_create_with_config(const Hashmap_config *config)
 {
+    Hashmap *map = NULL;
+
+    check(config != NULL, "config is NULL.");
+    check(config->engine <= HASHMAP_ROBIN_HOOD, "Invalid engine.");
+    check(config->engine != HASHMAP_ROBIN_HOOD || config->max_load < 100, "max_load has to be less than 100.");
+
+    const cerb_allocator *allocator = cerb_allocator_or_default(config->allocator);
+
     // allocate memory for struct
-    Hashmap *map = malloc(sizeof(Hashmap));
+    map = cerb_calloc(allocator, sizeof(Hashmap));
     check_mem(map);
 
-    uint32_t amount = number_of_entries == 0 ? DEFAULT_NUMBER_OF_ENTRIES : number_of_entries;
+    map->allocator = allocator;
+    map->engine = config->engine;
+    map->max_load = config->max_load != 0 ? config->max_load :
+                    map->engine == HASHMAP_ROBIN_HOOD ? HASHMAP_DEFAULT_MAX_LOAD : HASHMAP_DEFAULT_CHAINED_MAX_LOAD;
+
+    cerb_size_t amount = config->number_of_entries == 0 ? DEFAULT_NUMBER_OF_ENTRIES : config->number_of_entries;
+
+    if (map->engine == HASHMAP_ROBIN_HOOD) {
+        // smallest power of 2 which holds amount elements under max_load
+        cerb_size_t capacity = 8;
+        while (capacity < CERB_SIZE_MAX / 2 + 1 && (uint64_t) capacity * map->max_load < (uint64_t) amount * 100) {
+            capacity *= 2;
+        }
+        check(robin_hood_alloc(map, capacity) == CERB_OK, "Failed to allocate table.");
+    } else {
+        // allocate some number of blocks to hold pointers to buckets
+        map->entries = (Hashmap_bucket **) cerb_calloc(allocator, amount * sizeof(Hashmap_bucket *));
+        check_mem(map->entries);
 
-    // allocate some number of blocks to hold pointers to d_array
-    map->entries = (d_array **) calloc(amount, sizeof(d_array *));
-    check_mem(map->entries);
+        // set capacity to number of entries (default or specified)
+        map->capacity = amount;
+    }
 
-    // if hash is NULL, then default hash is set
-    map->hash = hash == NULL ? default_hash : hash;
+    // hash callback wins, otherwise seeded one is used (Hashmap_hash_string if it isn't given either)
+    map->hash = config->hash;
+    map->seeded_hash = config->seeded_hash == NULL ? Hashmap_hash_string : config->seeded_hash;
+    map->seed = config->seed == 0 ? Hashmap_random_seed(map) : config->seed;
 
     // if cmp is present set it, else set default
-    map->compare = cmp == NULL ? Hashmap_default_compare : cmp;
-    
-    // set capacity to number of entries (default or specified)
-    map->capacity = amount;
+    map->compare = config->compare == NULL ? Hashmap_default_compare : config->compare;
+
+    map->length = 0;
+    map->search_mode = HASHMAP_SEARCH_CALLBACK;
 
     return map;
 
 error:
-    if (map) free(map);
+    if (map) cerb_free(map->allocator, map, sizeof(Hashmap));
     return NULL;
 }
 
-// internally used to find entry or create it
-static inline d_array *find_or_create(Hashmap *map, uint32_t hash, int create)
+// bytes of bucket with room for capacity nodes
+static inline size_t Hashmap_bucket_size(cerb_size_t capacity)
+{
+    return sizeof(Hashmap_bucket) + sizeof(Hashmap_node *) * capacity;
+}
+
+// internally used to make room for one more index in active list of entries
+static int Hashmap_active_reserve(Hashmap *map)
+{
+    if (map->active_length < map->active_capacity) return CERB_OK;
+
+    cerb_size_t capacity = map->active_capacity ? map->active_capacity * 2 : HASHMAP_ACTIVE_CAPACITY;
+    cerb_size_t *active = cerb_realloc(map->allocator, map->active, sizeof(cerb_size_t) * map->active_capacity,
+                                       sizeof(cerb_size_t) * capacity);
+    check_mem(active);
+
+    map->active = active;
+    map->active_capacity = capacity;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// internally used to drop bucket from active list of its table (last index takes its place)
+static inline void Hashmap_active_remove(Hashmap *map, Hashmap_bucket *bucket, int old)
 {
-    if (create && !map->entries[hash]) {
-        // create entry (number of elements each entry will hold is gonna be the same as capacity of map)
-        map->entries[hash] = d_array_create(map->compare, DEFAULT_NUMBER_OF_ENTRIES);
-        check_mem(map->entries[hash]);
+    Hashmap_bucket **entries = old ? map->old_entries : map->entries;
+    cerb_size_t *active = old ? map->old_active : map->active;
+    cerb_size_t last = active[--*(old ? &map->old_active_length : &map->active_length)];
+
+    active[bucket->active] = last;
+    entries[last]->active = bucket->active;
+}
+
+// internally used to append node to bucket in table slot entry (of entries), bucket is created or doubled when
+// it is full. new buckets go to active list
+static int Hashmap_bucket_push(Hashmap *map, Hashmap_bucket **entry, Hashmap_node *node)
+{
+    Hashmap_bucket *bucket = *entry;
+
+    if (!bucket) check(Hashmap_active_reserve(map) == CERB_OK, "Failed to grow active list.");
+
+    if (!bucket || bucket->length == bucket->capacity) {
+        // buckets stay short as map grows, so they start with room for one node
+        cerb_size_t capacity = bucket ? bucket->capacity * 2 : HASHMAP_BUCKET_CAPACITY;
+        size_t old_size = bucket ? Hashmap_bucket_size(bucket->capacity) : 0;
+
+        bucket = cerb_realloc(map->allocator, bucket, old_size, Hashmap_bucket_size(capacity));
+        check_mem(bucket);
+
+        if (!*entry) {
+            bucket->length = 0;
+            bucket->active = map->active_length;
+            map->active[map->active_length++] = (cerb_size_t) (entry - map->entries);
+        }
+        bucket->capacity = capacity;
+        *entry = bucket;
     }
+    bucket->nodes[bucket->length++] = node;
 
-    return map->entries[hash];
+    return CERB_OK;
 
 error:
-    return NULL;
+    return CERB_ERR;
+}
+
+// internally used to take node at position out of bucket in table slot entry (last node takes its place), empty
+// bucket is freed and one which dropped to quarter of its capacity is halved. old tells which table entry is in
+static void Hashmap_bucket_cut(Hashmap *map, Hashmap_bucket **entry, cerb_size_t position, int old)
+{
+    Hashmap_bucket *bucket = *entry;
+
+    bucket->nodes[position] = bucket->nodes[--bucket->length];
+
+    if (bucket->length == 0) {
+        Hashmap_active_remove(map, bucket, old);
+        cerb_free(map->allocator, bucket, Hashmap_bucket_size(bucket->capacity));
+        *entry = NULL;
+    } else if (bucket->length <= bucket->capacity / 4) {
+        // if it fails bucket just stays bigger
+        Hashmap_bucket *smaller = cerb_realloc(map->allocator, bucket, Hashmap_bucket_size(bucket->capacity),
+                                               Hashmap_bucket_size(bucket->capacity / 2));
+        if (smaller) {
+            smaller->capacity /= 2;
+            *entry = smaller;
+        }
+    }
+}
+
+// bytes of slab of capacity nodes
+static inline size_t Hashmap_slab_size(cerb_size_t capacity)
+{
+    return sizeof(Hashmap_slab) + sizeof(Hashmap_node) * capacity;
 }
 
-// internally used to create hashmap nodes
-static inline Hashmap_node *Hashmap_node_create(void *data, uint32_t hash)
+// internally used to create hashmap nodes: removed node is reused if there is one, otherwise node is taken from
+// newest slab (new one, twice as big as the previous one, is allocated when it runs out). nodes of map share
+// cache lines and insert/remove churn never goes to allocator
+static inline Hashmap_node *Hashmap_node_create(Hashmap *map, void *data, void *value, uint32_t hash)
 {
-    Hashmap_node *node = malloc(sizeof(Hashmap_node)); // allocate memory for hashmapnode
-    check_mem(node);
+    Hashmap_node *node = map->free_nodes;
+
+    if (node) {
+        map->free_nodes = node->data;
+    } else {
+        if (!map->slabs || map->slab_used == map->slabs->capacity) {
+            cerb_size_t capacity = map->slabs ? map->slabs->capacity * 2 : HASHMAP_SLAB_NODES;
+            if (capacity > HASHMAP_SLAB_MAX_NODES) capacity = HASHMAP_SLAB_MAX_NODES;
+
+            Hashmap_slab *slab = cerb_alloc(map->allocator, Hashmap_slab_size(capacity));
+            check_mem(slab);
+
+            slab->next = map->slabs;
+            slab->capacity = capacity;
+            map->slabs = slab;
+            map->slab_used = 0;
+        }
+        node = &map->slabs->nodes[map->slab_used++];
+    }
 
     node->data = data;
+    node->value = value;
     node->hash = hash;
 
     return node;
@@ -88,51 +381,130 @@ error:
     return NULL;
 }
 
-// internally used for rehashing items if needed
-static void Hashmap_rehash(Hashmap *map)
+// internally used to give node back, it goes to free list of map
+static inline void Hashmap_node_free(Hashmap *map, Hashmap_node *node)
 {
-    // reallocate map->entries so that it has |capacity + capacity / 2| capacity
+    node->data = map->free_nodes;
+    map->free_nodes = node;
+}
 
-    // loop through each bucket, rehash and add items to their new entries
-    // (min Heap could be used to start rehashing smallest lengthed entries first)
-    // (which could decrease total time took by rehash)
+// internally used to free every slab, nodes of map are gone with them
+static void Hashmap_slabs_free(Hashmap *map)
+{
+    while (map->slabs) {
+        Hashmap_slab *next = map->slabs->next;
+        cerb_free(map->allocator, map->slabs, Hashmap_slab_size(map->slabs->capacity));
+        map->slabs = next;
+    }
+    map->free_nodes = NULL;
+    map->slab_used = 0;
+}
 
-    /*
-        typedef struct Heap_property_for_Hashmap_handling {
-            uint32_t length;
-            uint32_t active_position;
-        } Property;
-    */
+// internally used to find position of key with given hash in bucket (-1 if it isn't there)
+static inline int64_t Hashmap_bucket_find(Hashmap *map, Hashmap_bucket *bucket, void *key, uint32_t hash)
+{
+    switch (map->search_mode) {
+        // nodes start with data pointer, so kernels look through them (indirect)
+        case HASHMAP_SEARCH_IDENTITY: return cerb_simd_find_pointer((void *const *) bucket->nodes, bucket->length, key, 1);
+        case HASHMAP_SEARCH_INT: return cerb_simd_find_int((void *const *) bucket->nodes, bucket->length, *(int *) key, 1);
+    }
 
-   // above structure is an example of how heap could be used for maintaining active entries list (active_position)
-   // and their lengths for efficient rehashing (starting from min lengths and going forward) (length)
-   // this heap should be sorted by length (length) for efficient rehashing
-   // active_positions don't need sort because we need their list just for deallocating memory
-   // loop through heap as d_array and deallocate active positions
+    // nodes keep whole hash, compare is called only when it matches (bucket index alone matches for every node)
+    cerb_size_t i;
+    for (i = 0; i < bucket->length; i++) {
+        Hashmap_node *node = bucket->nodes[i];
+        if (node->hash == hash) {
+            HASHMAP_COUNT(map, compares);
+            if (map->compare(node->data, key) == HASHMAP_EQUAL) return i;
+        }
+    }
 
-   // it would be better to wrap Heap in priority_queue and work with that
+    return -1;
 }
 
-// insetr data in hashmap
-int Hashmap_insert(Hashmap *restrict map, void *data)
+// choose how buckets are scanned
+int Hashmap_set_search_mode(Hashmap *map, uint8_t search_mode)
 {
     check(map != NULL, "map is NULL.");
-    check(data != NULL, "data is NULL.");
+    check(search_mode <= HASHMAP_SEARCH_INT, "Invalid search mode.");
+
+    map->search_mode = search_mode;
 
-    // obtain hash value
-    uint32_t hash = map->hash(data) % Hashmap_capacity(map);
+    return CERB_OK;
 
-    // find or create entry
-    d_array *entry = find_or_create(map, hash, 1);
-    check(entry != NULL, "Failed to insert in map.");
+error:
+    return CERB_ERR;
+}
 
-    // create hashmap node
-    Hashmap_node *node = Hashmap_node_create(data, hash);
-    check(node != NULL, "Failed to insert in map."); // in case of error here, entry above stays allocated anyways
+/* robin hood engine */
 
-    // add value to it
-    d_array_push_back(entry, node);
-    map->length++; // increase length after inserting
+// internally used to check whether data is what key looks for (search modes apply to robin hood table too)
+static inline int Hashmap_matches(Hashmap *map, void *data, void *key)
+{
+    switch (map->search_mode) {
+        case HASHMAP_SEARCH_IDENTITY: return data == key;
+        case HASHMAP_SEARCH_INT: return *(int *) data == *(int *) key;
+    }
+
+    HASHMAP_COUNT(map, compares);
+    return map->compare(data, key) == HASHMAP_EQUAL;
+}
+
+// home slot of hash (fibonacci hashing, so that weak hashes like identity of ints spread over the whole table)
+static inline cerb_size_t robin_hood_home(Hashmap *map, uint32_t hash)
+{
+    return (cerb_size_t) (((uint64_t) hash * 0x9E3779B97F4A7C15ULL) >> map->shift);
+}
+
+// internally used to put entry in table from slot i on, elements which are closer to their home give their slots
+// away. returns slot entry itself ended up in
+static cerb_size_t robin_hood_place_at(Hashmap *map, Hashmap_slot entry, cerb_size_t i)
+{
+    cerb_size_t mask = map->capacity - 1, placed = CERB_SIZE_MAX; // table is never that big, so it means not yet
+
+    while (map->slots[i].distance) {
+        if (map->slots[i].distance < entry.distance) {
+            Hashmap_slot richer = map->slots[i];
+            map->slots[i] = entry;
+            entry = richer;
+            if (placed == CERB_SIZE_MAX) placed = i;
+        }
+        i = (i + 1) & mask;
+        entry.distance++;
+    }
+    map->slots[i] = entry;
+
+    return placed == CERB_SIZE_MAX ? i : placed;
+}
+
+// internally used to put entry in table, probing from its home slot
+static inline void robin_hood_place(Hashmap *map, Hashmap_slot entry)
+{
+    entry.distance = 1;
+    robin_hood_place_at(map, entry, robin_hood_home(map, entry.hash));
+}
+
+// internally used to double capacity of table
+static int robin_hood_grow(Hashmap *map)
+{
+    Hashmap_slot *old_slots = map->slots;
+    cerb_size_t old_capacity = map->capacity, i;
+    uint8_t old_shift = map->shift;
+
+    check(old_capacity < CERB_SIZE_MAX / 2 + 1, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
+    if (robin_hood_alloc(map, old_capacity * 2) != CERB_OK) {
+        map->slots = old_slots;
+        map->capacity = old_capacity;
+        map->shift = old_shift;
+        return CERB_ERR;
+    }
+
+    // stored hashes are reused, hash function isn't called again
+    for (i = 0; i < old_capacity; i++) {
+        if (old_slots[i].distance) robin_hood_place(map, old_slots[i]);
+    }
+    cerb_free(map->allocator, old_slots, sizeof(Hashmap_slot) * old_capacity);
+    HASHMAP_COUNT(map, resizes);
 
     return CERB_OK;
 
@@ -140,94 +512,908 @@ error:
     return CERB_ERR;
 }
 
-// find data with key associated with it (in most cases key is data itself)
-void *Hashmap_find(Hashmap *restrict map, void *restrict key)
+// internally used to find slot of key (-1 if it isn't there). probing stops at first element which is closer
+// to its home than key would be, because key would have taken its slot on insert
+static inline int64_t robin_hood_slot_of(Hashmap *map, void *key, uint32_t hash)
 {
-    check(map != NULL, "map is NULL.");
-    check(key != NULL, "key is NULL.");
+    cerb_size_t mask = map->capacity - 1, i = robin_hood_home(map, hash);
+    uint32_t distance = 1;
+
+    for (;; i = (i + 1) & mask, distance++) {
+        Hashmap_slot *slot = &map->slots[i];
+        if (slot->distance < distance) {
+            HASHMAP_COUNT(map, misses);
+            return -1;
+        }
+        if (slot->hash == hash && Hashmap_matches(map, slot->data, key)) {
+            HASHMAP_COUNT(map, hits);
+            return i;
+        }
+    }
+}
+
+static int robin_hood_insert(Hashmap *map, void *data, uint32_t hash)
+{
+    if ((uint64_t) (map->length + 1) * 100 > (uint64_t) map->capacity * map->max_load) {
+        check(robin_hood_grow(map) == CERB_OK, "Failed to grow table.");
+    }
+
+    Hashmap_slot entry = {data, data, hash, 1};
+    robin_hood_place(map, entry);
+    map->length++;
+    HASHMAP_COUNT(map, inserts);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
 
-    // obtain hash value
-    uint32_t hash = map->hash(key) % Hashmap_capacity(map);
+// internally used to find value of key and insert key (with NULL value) if it isn't there and inserted isn't NULL.
+// probing for key stops right at the slot key belongs to, so insert continues from there instead of probing again
+static void **robin_hood_probe(Hashmap *map, void *key, uint32_t hash, int *inserted)
+{
+    // grow first, so that slot probing stops at is still the right one (key which is there already may cost us
+    // growing a bit earlier, just like Hashmap_insert of it would)
+    if (inserted && (uint64_t) (map->length + 1) * 100 > (uint64_t) map->capacity * map->max_load) {
+        check(robin_hood_grow(map) == CERB_OK, "Failed to grow table.");
+    }
 
-    d_array *entry = find_or_create(map, hash, 0);
-    if (!entry) return NULL; // if entry doesn't exist at all then data doesn't exist at all too
+    cerb_size_t mask = map->capacity - 1, i = robin_hood_home(map, hash);
+    uint32_t distance = 1;
 
-    uint32_t i; // if entry exists find data within it
-    for (i = 0; i < d_array_length(entry); i++) {
-        if (entry->compare(((Hashmap_node *)entry->data[i])->data, key) == HASHMAP_EQUAL) {
-            return ((Hashmap_node *)entry->data[i])->data;
+    for (;; i = (i + 1) & mask, distance++) {
+        Hashmap_slot *slot = &map->slots[i];
+        if (slot->distance < distance) break;
+        if (slot->hash == hash && Hashmap_matches(map, slot->data, key)) {
+            HASHMAP_COUNT(map, hits);
+            return &slot->value;
         }
     }
+    HASHMAP_COUNT(map, misses);
 
-error: // fall through
+    if (!inserted) return NULL;
+
+    Hashmap_slot entry = {key, NULL, hash, distance};
+    i = robin_hood_place_at(map, entry, i);
+    map->length++;
+    HASHMAP_COUNT(map, inserts);
+    *inserted = 1;
+
+    return &map->slots[i].value;
+
+error:
     return NULL;
 }
 
-// remove data with key from map (deallocating returned data is your responsibility)
-void *Hashmap_remove(Hashmap *restrict map, void *restrict key)
+// backward shift deletion: following elements move one slot closer to home, so that there are no tombstones
+static void *robin_hood_remove(Hashmap *map, void *key, void **value)
+{
+    int64_t slot = robin_hood_slot_of(map, key, Hashmap_hash_of(map, key));
+    if (slot < 0) return NULL;
+
+    cerb_size_t mask = map->capacity - 1, i = (cerb_size_t) slot, next = (i + 1) & mask;
+    void *data = map->slots[i].data;
+    *value = map->slots[i].value;
+
+    while (map->slots[next].distance > 1) {
+        map->slots[i] = map->slots[next];
+        map->slots[i].distance--;
+        i = next;
+        next = (next + 1) & mask;
+    }
+    map->slots[i].data = NULL;
+    map->slots[i].distance = 0;
+    map->length--;
+
+    return data;
+}
+
+/* chained engine */
+
+// internally used to free bucket (nodes have to be gone already)
+static inline void Hashmap_bucket_free(Hashmap *map, Hashmap_bucket *bucket)
+{
+    cerb_free(map->allocator, bucket, Hashmap_bucket_size(bucket->capacity));
+}
+
+// internally used to start growing chained map: new table of twice the buckets becomes entries and old one
+// is emptied bucket by bucket as map is used (see Hashmap_rehash)
+static int Hashmap_rehash_start(Hashmap *map)
+{
+    check(map->capacity <= CERB_SIZE_MAX / 2, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
+
+    Hashmap_bucket **entries = (Hashmap_bucket **) cerb_calloc(map->allocator, sizeof(Hashmap_bucket *) * map->capacity * 2);
+    check_mem(entries);
+
+    map->old_entries = map->entries;
+    map->old_capacity = map->capacity;
+    map->old_active = map->active;
+    map->old_active_length = map->active_length;
+    map->old_active_capacity = map->active_capacity;
+    map->rehash_position = 0;
+    map->entries = entries;
+    map->capacity *= 2;
+    map->active = NULL; // new table gets its own active list as buckets are created
+    map->active_length = 0;
+    map->active_capacity = 0;
+    HASHMAP_COUNT(map, resizes);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// internally used to free old table of growing map once nothing is left in it
+static void Hashmap_rehash_finish(Hashmap *map)
+{
+    cerb_free(map->allocator, map->old_entries, sizeof(Hashmap_bucket *) * map->old_capacity);
+    cerb_free(map->allocator, map->old_active, sizeof(cerb_size_t) * map->old_active_capacity);
+    map->old_entries = NULL;
+    map->old_active = NULL;
+    map->old_capacity = 0;
+    map->old_active_length = 0;
+    map->old_active_capacity = 0;
+    map->rehash_position = 0;
+}
+
+// internally used for rehashing: move nodes of up to buckets old buckets into new table. buckets are taken
+// from the end of active list of old table, so empty ones are never visited
+static int Hashmap_rehash(Hashmap *map, cerb_size_t buckets)
+{
+    while (buckets && map->old_active_length) {
+        cerb_size_t index = map->old_active[map->old_active_length - 1];
+        Hashmap_bucket *old_entry = map->old_entries[index];
+
+        // move from the back, so that nodes which are left are still in place if we run out of memory
+        while (old_entry->length) {
+            Hashmap_node *node = old_entry->nodes[old_entry->length - 1];
+            check(Hashmap_bucket_push(map, &map->entries[node->hash % map->capacity], node) == CERB_OK,
+                  "Failed to move node.");
+            old_entry->length--;
+        }
+        Hashmap_bucket_free(map, old_entry);
+        map->old_entries[index] = NULL;
+        map->old_active_length--;
+        map->rehash_position++;
+        buckets--;
+    }
+
+    if (map->old_active_length == 0) Hashmap_rehash_finish(map); // everything has been moved
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// move nodes of buckets old buckets (0 means all of them) into new table of growing map
+int Hashmap_rehash_step(Hashmap *map, cerb_size_t buckets)
 {
     check(map != NULL, "map is NULL.");
-    check(key != NULL, "key is NULL.");
 
-    // obtain hash value
-    uint32_t hash = map->hash(key) % Hashmap_capacity(map);
+    if (!Hashmap_is_rehashing(map)) return CERB_OK;
+
+    return Hashmap_rehash(map, buckets ? buckets : CERB_SIZE_MAX);
 
-    d_array *entry = find_or_create(map, hash, 0);
-    if (!entry) return NULL; // if entry doesn't exist at all then data doesn't exist at all too
+error:
+    return CERB_ERR;
+}
+
+// part of old buckets already moved (1.0 when map isn't growing)
+double Hashmap_rehash_progress(Hashmap *map)
+{
+    check(map != NULL, "map is NULL.");
+
+    if (!Hashmap_is_rehashing(map)) return 1.0;
+
+    return (double) map->rehash_position / (map->rehash_position + map->old_active_length);
 
-    Hashmap_node *found_node = NULL;
+error:
+    return 0.0;
+}
+
+// internally used to find bucket and position of key in chained map, old table is checked first while growing
+// (its nodes were inserted earlier, moved buckets are NULL there). returns table slot of bucket, old tells which
+// table it is in (can be NULL)
+static inline Hashmap_bucket **Hashmap_lookup(Hashmap *map, void *key, uint32_t hash, int64_t *position, int *old)
+{
+    Hashmap_bucket **entry;
 
-    uint32_t i; // if entry exists find data within it
-    for (i = 0; i < d_array_length(entry); i++) {
-        if (entry->compare(((Hashmap_node *)entry->data[i])->data, key) == HASHMAP_EQUAL) {
-            found_node = (Hashmap_node *) entry->data[i];
-            break;
+    if (old) *old = 0;
+
+    if (Hashmap_is_rehashing(map)) {
+        entry = &map->old_entries[hash % map->old_capacity];
+        if (*entry != NULL && (*position = Hashmap_bucket_find(map, *entry, key, hash)) >= 0) {
+            if (old) *old = 1;
+            HASHMAP_COUNT(map, hits);
+            return entry;
         }
     }
-    if (!found_node) return NULL;
 
-    Hashmap_node *last_node = d_array_pop_back(entry);
-    void *data = found_node->data; // keep the data
+    entry = &map->entries[hash % map->capacity];
+    if (*entry && (*position = Hashmap_bucket_find(map, *entry, key, hash)) >= 0) {
+        HASHMAP_COUNT(map, hits);
+        return entry;
+    }
+    HASHMAP_COUNT(map, misses);
 
-    if (found_node == last_node) {
-        free(last_node); // if last one was the one we were looking for just free it's node and return data
-    } else {
-        free(found_node); // deallocate found node
-        entry->data[i] = last_node; // and set last node at it's place
+    return NULL;
+}
+
+// internally used to add node of data to chained map (node keeps whole hash, so that rehashing doesn't call hash
+// function again). nodes aren't moved by growing, so returned node stays valid until it is removed
+static Hashmap_node *Hashmap_bucket_add(Hashmap *map, void *data, void *value, uint32_t hash)
+{
+    // create hashmap node
+    Hashmap_node *node = Hashmap_node_create(map, data, value, hash);
+    check(node != NULL, "Failed to insert in map.");
+
+    // add it to bucket (which is created if it doesn't exist yet)
+    if (Hashmap_bucket_push(map, &map->entries[hash % Hashmap_capacity(map)], node) != CERB_OK) {
+        Hashmap_node_free(map, node);
+        sentinel("Failed to insert in map.");
     }
-    map->length--; // decrease length after removing
+    map->length++; // increase length after inserting
+    HASHMAP_COUNT(map, inserts);
 
-    return data;
+    // start growing when map gets too full (growing once more has to wait until previous one finishes)
+    if (map->max_load != HASHMAP_FIXED_SIZE && !Hashmap_is_rehashing(map) &&
+        (uint64_t) map->length * 100 > (uint64_t) map->capacity * map->max_load) {
+        if (Hashmap_rehash_start(map) != CERB_OK) log_warn("Failed to grow map, it keeps its buckets.");
+    }
+
+    return node;
 
 error:
     return NULL;
 }
 
-// deallocate entire hashmap
-int Hashmap_destroy(Hashmap **restrict map, Hashmap_dealloc dealloc_cb)
+// insetr data in hashmap
+int Hashmap_insert(Hashmap *restrict map, void *data)
 {
-    check(map != NULL, "Address of map is NULL.");
-    check(*map != NULL, "map is NULL.");
+    check(map != NULL, "map is NULL.");
+    check(data != NULL, "data is NULL.");
 
-    uint32_t i;
-    for (i = 0; i < Hashmap_capacity(*map); i++) {
-        d_array *cur_array = (*map)->entries[i];
-        if (cur_array) {
-            uint32_t j;
-            for (j = 0; j < d_array_length(cur_array); j++) {
-                dealloc_cb(((Hashmap_node *)cur_array->data[j])->data); // free actual data
-                free(cur_array->data[j]); // free Hashmap_node
-            }
-            free(cur_array->data); // free cur_array->data
-            free(cur_array); // and cur_array itself and move to the next one
-        }
-    }
-    free((*map)->entries);
-    free(*map);
-    *map = NULL;
+    if (map->engine == HASHMAP_ROBIN_HOOD) return robin_hood_insert(map, data, Hashmap_hash_of(map, data));
+
+    // do a bit of pending rehashing first, if it fails node stays where it was (map is still consistent)
+    if (Hashmap_is_rehashing(map)) Hashmap_rehash(map, HASHMAP_REHASH_STEP);
+
+    check(Hashmap_bucket_add(map, data, data, Hashmap_hash_of(map, data)) != NULL, "Failed to insert in map.");
 
     return CERB_OK;
 
 error:
-    return CERB_ERR; // maintain a list of active (allocated) entries for efficiency
-}
\ No newline at end of file
+    return CERB_ERR;
+}
+
+// find data with key associated with it (in most cases key is data itself)
+void *Hashmap_find(Hashmap *restrict map, void *restrict key)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    if (map->engine == HASHMAP_ROBIN_HOOD) {
+        int64_t slot = robin_hood_slot_of(map, key, Hashmap_hash_of(map, key));
+        return slot < 0 ? NULL : map->slots[slot].data;
+    }
+
+    if (Hashmap_is_rehashing(map)) Hashmap_rehash(map, HASHMAP_REHASH_STEP);
+
+    int64_t i;
+    Hashmap_bucket **entry = Hashmap_lookup(map, key, Hashmap_hash_of(map, key), &i, NULL);
+    if (entry) return (*entry)->nodes[i]->data;
+
+error: // fall through
+    return NULL;
+}
+
+// internally used to remove key from map, returns stored data and puts its value in value
+static void *Hashmap_extract(Hashmap *map, void *key, void **value)
+{
+    if (map->engine == HASHMAP_ROBIN_HOOD) return robin_hood_remove(map, key, value);
+
+    if (Hashmap_is_rehashing(map)) Hashmap_rehash(map, HASHMAP_REHASH_STEP);
+
+    int64_t i;
+    int old;
+    Hashmap_bucket **entry = Hashmap_lookup(map, key, Hashmap_hash_of(map, key), &i, &old);
+    if (!entry) return NULL; // if key isn't in any entry it doesn't exist at all
+
+    Hashmap_node *found_node = (*entry)->nodes[i];
+    void *data = found_node->data; // keep the data
+    *value = found_node->value;
+
+    Hashmap_bucket_cut(map, entry, i, old); // last node takes its place
+    Hashmap_node_free(map, found_node);
+    map->length--; // decrease length after removing
+
+    return data;
+}
+
+// remove data with key from map (deallocating returned data is your responsibility)
+void *Hashmap_remove(Hashmap *restrict map, void *restrict key)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    void *value;
+    return Hashmap_extract(map, key, &value);
+
+error:
+    return NULL;
+}
+
+/* batched API */
+
+// internally used to prefetch what lookups of count hashes are going to touch. every pass starts count independent
+// loads and uses what the previous pass has loaded, so cache misses of the batch overlap instead of coming one
+// after another. nodes tells whether first nodes of chained buckets and data compare reads are needed too (inserts
+// don't read them)
+static void Hashmap_prefetch(Hashmap *map, const uint32_t *hashes, cerb_size_t count, int nodes)
+{
+    cerb_size_t i;
+
+    if (map->engine == HASHMAP_ROBIN_HOOD) {
+        for (i = 0; i < count; i++) HASHMAP_PREFETCH(&map->slots[robin_hood_home(map, hashes[i])]);
+        if (!nodes || map->search_mode == HASHMAP_SEARCH_IDENTITY) return;
+        // data compare is going to read, when hash in home slot matches
+        for (i = 0; i < count; i++) {
+            Hashmap_slot *slot = &map->slots[robin_hood_home(map, hashes[i])];
+            if (slot->distance && slot->hash == hashes[i]) HASHMAP_PREFETCH(slot->data);
+        }
+        return;
+    }
+
+    // table slots (old table is only touched while map grows, its buckets aren't prefetched)
+    for (i = 0; i < count; i++) {
+        HASHMAP_PREFETCH(&map->entries[hashes[i] % map->capacity]);
+        if (Hashmap_is_rehashing(map)) HASHMAP_PREFETCH(&map->old_entries[hashes[i] % map->old_capacity]);
+    }
+    // buckets table slots point to
+    for (i = 0; i < count; i++) {
+        Hashmap_bucket *bucket = map->entries[hashes[i] % map->capacity];
+        if (bucket) HASHMAP_PREFETCH(bucket);
+    }
+    if (!nodes) return;
+    // first nodes of buckets (most buckets hold one)
+    for (i = 0; i < count; i++) {
+        Hashmap_bucket *bucket = map->entries[hashes[i] % map->capacity];
+        if (bucket && bucket->length) HASHMAP_PREFETCH(bucket->nodes[0]);
+    }
+    if (map->search_mode == HASHMAP_SEARCH_IDENTITY) return;
+    // data compare is going to read, when hash of first node matches
+    for (i = 0; i < count; i++) {
+        Hashmap_bucket *bucket = map->entries[hashes[i] % map->capacity];
+        if (bucket && bucket->length && bucket->nodes[0]->hash == hashes[i]) HASHMAP_PREFETCH(bucket->nodes[0]->data);
+    }
+}
+
+// find count keys, data of keys[i] (or NULL) goes to found[i]. keys are hashed and prefetched HASHMAP_BATCH at a time
+int Hashmap_find_batch(Hashmap *restrict map, void *const *keys, cerb_size_t count, void **found)
+{
+    check(map != NULL, "map is NULL.");
+    check(count == 0 || (keys != NULL && found != NULL), "keys or found is NULL.");
+
+    uint32_t hashes[HASHMAP_BATCH];
+    cerb_size_t start, i;
+
+    for (start = 0; start < count; start += HASHMAP_BATCH) {
+        cerb_size_t batch = count - start < HASHMAP_BATCH ? count - start : HASHMAP_BATCH;
+        void *const *batch_keys = keys + start;
+
+        // as much pending rehashing as Hashmap_find of every key would do, before anything is prefetched
+        if (Hashmap_is_rehashing(map)) Hashmap_rehash(map, HASHMAP_REHASH_STEP * batch);
+
+        for (i = 0; i < batch; i++) {
+            check(batch_keys[i] != NULL, "key is NULL.");
+            hashes[i] = Hashmap_hash_of(map, batch_keys[i]);
+        }
+        Hashmap_prefetch(map, hashes, batch, 1);
+
+        for (i = 0; i < batch; i++) {
+            if (map->engine == HASHMAP_ROBIN_HOOD) {
+                int64_t slot = robin_hood_slot_of(map, batch_keys[i], hashes[i]);
+                found[start + i] = slot < 0 ? NULL : map->slots[slot].data;
+            } else {
+                int64_t position;
+                Hashmap_bucket **entry = Hashmap_lookup(map, batch_keys[i], hashes[i], &position, NULL);
+                found[start + i] = entry ? (*entry)->nodes[position]->data : NULL;
+            }
+        }
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// insert count data the way Hashmap_insert does, hashing and prefetching HASHMAP_BATCH of them at a time
+int Hashmap_insert_batch(Hashmap *restrict map, void *const *data, cerb_size_t count)
+{
+    check(map != NULL, "map is NULL.");
+    check(count == 0 || data != NULL, "data is NULL.");
+
+    uint32_t hashes[HASHMAP_BATCH];
+    cerb_size_t start, i;
+
+    for (start = 0; start < count; start += HASHMAP_BATCH) {
+        cerb_size_t batch = count - start < HASHMAP_BATCH ? count - start : HASHMAP_BATCH;
+        void *const *batch_data = data + start;
+
+        // grow robin hood table for whole batch up front, so that prefetched slots stay where they are
+        while (map->engine == HASHMAP_ROBIN_HOOD &&
+               (uint64_t) (map->length + batch) * 100 > (uint64_t) map->capacity * map->max_load) {
+            check(robin_hood_grow(map) == CERB_OK, "Failed to grow table.");
+        }
+        if (Hashmap_is_rehashing(map)) Hashmap_rehash(map, HASHMAP_REHASH_STEP * batch);
+
+        for (i = 0; i < batch; i++) {
+            check(batch_data[i] != NULL, "data is NULL.");
+            hashes[i] = Hashmap_hash_of(map, batch_data[i]);
+        }
+        Hashmap_prefetch(map, hashes, batch, 0);
+
+        for (i = 0; i < batch; i++) {
+            if (map->engine == HASHMAP_ROBIN_HOOD) {
+                check(robin_hood_insert(map, batch_data[i], hashes[i]) == CERB_OK, "Failed to insert in map.");
+            } else {
+                check(Hashmap_bucket_add(map, batch_data[i], batch_data[i], hashes[i]) != NULL,
+                      "Failed to insert in map.");
+            }
+        }
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+/* key/value API */
+
+// internally used to find value of key in chained map, key is added with NULL value if it isn't there and inserted
+// isn't NULL. it goes to the bucket lookup has just scanned, so key is hashed and looked for only once
+static void **chained_probe(Hashmap *map, void *key, uint32_t hash, int *inserted)
+{
+    if (Hashmap_is_rehashing(map)) Hashmap_rehash(map, HASHMAP_REHASH_STEP);
+
+    int64_t i;
+    Hashmap_bucket **entry = Hashmap_lookup(map, key, hash, &i, NULL);
+    if (entry) return &(*entry)->nodes[i]->value;
+
+    if (!inserted) return NULL;
+
+    Hashmap_node *node = Hashmap_bucket_add(map, key, NULL, hash);
+    check(node != NULL, "Failed to insert in map.");
+    *inserted = 1;
+
+    return &node->value;
+
+error:
+    return NULL;
+}
+
+// internally used to dispatch probe to engine of map
+static inline void **Hashmap_probe(Hashmap *map, void *key, uint32_t hash, int *inserted)
+{
+    if (map->engine == HASHMAP_ROBIN_HOOD) return robin_hood_probe(map, key, hash, inserted);
+
+    return chained_probe(map, key, hash, inserted);
+}
+
+// hash of key as map computes it
+uint32_t Hashmap_hash(Hashmap *restrict map, void *restrict key)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    return Hashmap_hash_of(map, key);
+
+error:
+    return 0;
+}
+
+// set value of key, inserting key if it isn't there
+int Hashmap_put(Hashmap *restrict map, void *key, void *value)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    return Hashmap_put_prehashed(map, key, value, Hashmap_hash_of(map, key));
+
+error:
+    return CERB_ERR;
+}
+
+int Hashmap_put_prehashed(Hashmap *restrict map, void *key, void *value, uint32_t hash)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    int inserted = 0;
+    void **slot = Hashmap_probe(map, key, hash, &inserted);
+    check(slot != NULL, "Failed to put in map.");
+    *slot = value;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// value of key (NULL if it isn't there)
+void *Hashmap_get(Hashmap *restrict map, void *restrict key)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    return Hashmap_get_prehashed(map, key, Hashmap_hash_of(map, key));
+
+error:
+    return NULL;
+}
+
+void *Hashmap_get_prehashed(Hashmap *restrict map, void *restrict key, uint32_t hash)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    void **slot = Hashmap_probe(map, key, hash, NULL);
+    return slot ? *slot : NULL;
+
+error:
+    return NULL;
+}
+
+// pointer to value of key, key is inserted with NULL value if it isn't there
+void **Hashmap_upsert(Hashmap *restrict map, void *key, int *inserted)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    return Hashmap_upsert_prehashed(map, key, Hashmap_hash_of(map, key), inserted);
+
+error:
+    return NULL;
+}
+
+void **Hashmap_upsert_prehashed(Hashmap *restrict map, void *key, uint32_t hash, int *inserted)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    int was_inserted = 0;
+    void **slot = Hashmap_probe(map, key, hash, &was_inserted);
+    check(slot != NULL, "Failed to upsert in map.");
+    if (inserted) *inserted = was_inserted;
+
+    return slot;
+
+error:
+    return NULL;
+}
+
+// value of key if it is there, otherwise key is inserted with value
+void *Hashmap_get_or_insert(Hashmap *restrict map, void *key, void *value)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    return Hashmap_get_or_insert_prehashed(map, key, value, Hashmap_hash_of(map, key));
+
+error:
+    return NULL;
+}
+
+void *Hashmap_get_or_insert_prehashed(Hashmap *restrict map, void *key, void *value, uint32_t hash)
+{
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    int inserted = 0;
+    void **slot = Hashmap_probe(map, key, hash, &inserted);
+    check(slot != NULL, "Failed to insert in map.");
+    if (inserted) *slot = value;
+
+    return *slot;
+
+error:
+    return NULL;
+}
+
+// remove key and return its value (stored key goes to stored_key)
+void *Hashmap_take(Hashmap *restrict map, void *restrict key, void **stored_key)
+{
+    void *value = NULL, *data = NULL;
+
+    check(map != NULL, "map is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    data = Hashmap_extract(map, key, &value);
+
+error: // fall through
+    if (stored_key) *stored_key = data;
+    return data ? value : NULL;
+}
+
+// internally used to free value of element (if it is something else than data itself)
+static inline void Hashmap_value_free(void *data, void *value, Hashmap_dealloc value_dealloc_cb)
+{
+    if (value_dealloc_cb && value && value != data) value_dealloc_cb(value);
+}
+
+// internally used to free elements (and their buckets) of table of chained map, only buckets in active list
+// are visited, so it takes O(length) however big table is. old tells which table it is
+static void Hashmap_elements_free(Hashmap *map, int old, Hashmap_dealloc dealloc_cb, Hashmap_dealloc value_dealloc_cb)
+{
+    Hashmap_bucket **entries = old ? map->old_entries : map->entries;
+    cerb_size_t *active = old ? map->old_active : map->active;
+    cerb_size_t *active_length = old ? &map->old_active_length : &map->active_length;
+
+    cerb_size_t i;
+    for (i = 0; i < *active_length; i++) {
+        Hashmap_bucket *bucket = entries[active[i]];
+        cerb_size_t j;
+        for (j = 0; j < bucket->length; j++) {
+            Hashmap_node *node = bucket->nodes[j];
+            Hashmap_value_free(node->data, node->value, value_dealloc_cb);
+            if (dealloc_cb) dealloc_cb(node->data); // free actual data (node goes with its slab)
+        }
+        Hashmap_bucket_free(map, bucket); // free bucket and move to the next one
+        entries[active[i]] = NULL;
+    }
+    *active_length = 0;
+}
+
+// remove every element, map keeps its capacity
+int Hashmap_clear(Hashmap *map, Hashmap_dealloc dealloc_cb, Hashmap_dealloc value_dealloc_cb)
+{
+    check(map != NULL, "map is NULL.");
+
+    if (map->engine == HASHMAP_ROBIN_HOOD) {
+        cerb_size_t i;
+        for (i = 0; i < Hashmap_capacity(map); i++) {
+            Hashmap_slot *slot = &map->slots[i];
+            if (slot->distance) {
+                Hashmap_value_free(slot->data, slot->value, value_dealloc_cb);
+                if (dealloc_cb) dealloc_cb(slot->data); // free actual data
+                slot->data = NULL;
+                slot->value = NULL;
+                slot->distance = 0;
+            }
+        }
+    } else {
+        if (Hashmap_is_rehashing(map)) {
+            Hashmap_elements_free(map, 1, dealloc_cb, value_dealloc_cb);
+            Hashmap_rehash_finish(map);
+        }
+        Hashmap_elements_free(map, 0, dealloc_cb, value_dealloc_cb);
+        Hashmap_slabs_free(map);
+    }
+    map->length = 0;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// internally used to count bytes of table of chained map, its active list and buckets
+static size_t Hashmap_entries_usage(Hashmap_bucket **entries, cerb_size_t capacity, const cerb_size_t *active,
+                                    cerb_size_t active_length, cerb_size_t active_capacity)
+{
+    size_t bytes = sizeof(Hashmap_bucket *) * capacity + sizeof(cerb_size_t) * active_capacity;
+
+    cerb_size_t i;
+    for (i = 0; i < active_length; i++) {
+        Hashmap_bucket *bucket = entries[active[i]];
+        bytes += Hashmap_bucket_size(bucket->capacity);
+    }
+
+    return bytes;
+}
+
+// bytes map holds (data isn't counted)
+size_t Hashmap_memory_usage(Hashmap *map)
+{
+    check(map != NULL, "map is NULL.");
+
+    size_t bytes = sizeof(Hashmap);
+
+    if (map->engine == HASHMAP_ROBIN_HOOD) return bytes + sizeof(Hashmap_slot) * Hashmap_capacity(map);
+
+    bytes += Hashmap_entries_usage(map->entries, Hashmap_capacity(map), map->active, map->active_length,
+                                   map->active_capacity);
+    if (Hashmap_is_rehashing(map)) {
+        bytes += Hashmap_entries_usage(map->old_entries, map->old_capacity, map->old_active, map->old_active_length,
+                                       map->old_active_capacity);
+    }
+
+    Hashmap_slab *slab;
+    for (slab = map->slabs; slab; slab = slab->next) bytes += Hashmap_slab_size(slab->capacity);
+
+    return bytes;
+
+error:
+    return 0;
+}
+
+// internally used to count length in histogram of stats (last slot takes everything longer)
+static inline void Hashmap_stats_count(Hashmap_statistics *stats, cerb_size_t length)
+{
+    stats->histogram[length < HASHMAP_STATS_HISTOGRAM ? length : HASHMAP_STATS_HISTOGRAM - 1]++;
+}
+
+// internally used to add occupied buckets of one chained table to stats, chain and compares get sums per element
+static void Hashmap_stats_buckets(Hashmap_bucket **entries, const cerb_size_t *active,
+                                  cerb_size_t active_length, Hashmap_statistics *stats, double *chain,
+                                  double *compares)
+{
+    cerb_size_t i, j, k;
+
+    for (i = 0; i < active_length; i++) {
+        Hashmap_bucket *bucket = entries[active[i]];
+        Hashmap_stats_count(stats, bucket->length);
+        if (bucket->length > stats->max_chain) stats->max_chain = bucket->length;
+        stats->occupied++;
+
+        for (j = 0; j < bucket->length; j++) {
+            // lookup walks nodes before this one, compare is called for those with equal hash and for this one
+            cerb_size_t equal = 1;
+            for (k = 0; k < j; k++) equal += bucket->nodes[k]->hash == bucket->nodes[j]->hash;
+            *chain += j + 1;
+            *compares += equal;
+        }
+    }
+}
+
+// walk map and fill stats
+int Hashmap_stats(Hashmap *map, Hashmap_statistics *stats)
+{
+    check(map != NULL, "map is NULL.");
+    check(stats != NULL, "stats is NULL.");
+
+    double chain = 0, compares = 0;
+    cerb_size_t i;
+
+    memset(stats, 0, sizeof(Hashmap_statistics));
+    stats->length = map->length;
+    stats->capacity = Hashmap_capacity(map);
+
+    if (map->engine == HASHMAP_ROBIN_HOOD) {
+        cerb_size_t mask = Hashmap_capacity(map) - 1;
+        for (i = 0; i < Hashmap_capacity(map); i++) {
+            Hashmap_slot *slot = &map->slots[i];
+            if (slot->distance == 0) continue;
+
+            // probe from home slot to this one, compare is called for elements with equal hash on the way
+            cerb_size_t equal = 1, d;
+            for (d = 1; d < slot->distance; d++) equal += map->slots[(i - d) & mask].hash == slot->hash;
+            Hashmap_stats_count(stats, slot->distance - 1);
+            if (slot->distance > stats->max_chain) stats->max_chain = slot->distance;
+            stats->occupied++;
+            chain += slot->distance;
+            compares += equal;
+        }
+    } else {
+        Hashmap_stats_buckets(map->entries, map->active, map->active_length, stats, &chain, &compares);
+        if (Hashmap_is_rehashing(map)) {
+            stats->capacity += map->old_capacity;
+            Hashmap_stats_buckets(map->old_entries, map->old_active, map->old_active_length, stats, &chain, &compares);
+        }
+        stats->histogram[0] += stats->capacity - stats->occupied;
+    }
+
+    stats->load_factor = stats->capacity ? (double) stats->length / stats->capacity : 0.0;
+    if (stats->length) {
+        stats->average_chain = chain / stats->length;
+        stats->expected_compares = map->search_mode == HASHMAP_SEARCH_CALLBACK ? compares / stats->length : 0.0;
+    }
+
+#ifdef CERB_HASHMAP_COUNTERS
+    stats->counters = map->counters;
+    uint64_t lookups = map->counters.hits + map->counters.misses;
+    if (lookups) stats->compares_per_lookup = (double) map->counters.compares / lookups;
+#endif
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// start iteration over map
+int Hashmap_iter_begin(Hashmap *map, Hashmap_iter *iter)
+{
+    check(map != NULL, "map is NULL.");
+    check(iter != NULL, "iter is NULL.");
+
+    iter->map = map;
+    iter->old = 0;
+    iter->bucket = 0;
+    iter->node = 0;
+    iter->value = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// next data of iteration (NULL when there is nothing left), its value goes to iter->value
+void *Hashmap_iter_next(Hashmap_iter *iter)
+{
+    check(iter != NULL && iter->map != NULL, "iter isn't started.");
+
+    Hashmap *map = iter->map;
+
+    if (map->engine == HASHMAP_ROBIN_HOOD) {
+        while (iter->bucket < Hashmap_capacity(map)) {
+            Hashmap_slot *slot = &map->slots[iter->bucket++];
+            if (slot->distance) {
+                iter->value = slot->value;
+                return slot->data;
+            }
+        }
+        return NULL;
+    }
+
+    // active list of new table, then the one of old table if map is growing
+    for (;;) {
+        cerb_size_t active_length = iter->old ? map->old_active_length : map->active_length;
+
+        if (iter->bucket < active_length) {
+            Hashmap_bucket *bucket = iter->old ? map->old_entries[map->old_active[iter->bucket]] :
+                                                 map->entries[map->active[iter->bucket]];
+            if (iter->node < bucket->length) {
+                Hashmap_node *node = bucket->nodes[iter->node++];
+                iter->value = node->value;
+                return node->data;
+            }
+            iter->bucket++;
+            iter->node = 0;
+        } else if (!iter->old && Hashmap_is_rehashing(map)) {
+            iter->old = 1;
+            iter->bucket = 0;
+            iter->node = 0;
+        } else {
+            return NULL;
+        }
+    }
+
+error:
+    return NULL;
+}
+
+// deallocate entire hashmap
+int Hashmap_destroy(Hashmap **restrict map, Hashmap_dealloc dealloc_cb)
+{
+    return Hashmap_destroy_with_values(map, dealloc_cb, NULL);
+}
+
+// deallocate entire hashmap, values included (elements are freed in O(length), tables are freed at once)
+int Hashmap_destroy_with_values(Hashmap **restrict map, Hashmap_dealloc dealloc_cb, Hashmap_dealloc value_dealloc_cb)
+{
+    check(map != NULL, "Address of map is NULL.");
+    check(*map != NULL, "map is NULL.");
+
+    Hashmap_clear(*map, dealloc_cb, value_dealloc_cb);
+
+    if ((*map)->engine == HASHMAP_ROBIN_HOOD) {
+        cerb_free((*map)->allocator, (*map)->slots, sizeof(Hashmap_slot) * Hashmap_capacity(*map));
+    } else {
+        cerb_free((*map)->allocator, (*map)->entries, sizeof(Hashmap_bucket *) * Hashmap_capacity(*map));
+        cerb_free((*map)->allocator, (*map)->active, sizeof(cerb_size_t) * (*map)->active_capacity);
+    }
+    cerb_free((*map)->allocator, *map, sizeof(Hashmap));
+    *map = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -9,38 +9,148 @@
 
 #define DEFAULT_NUMBER_OF_ENTRIES 500
 
+// engines of Hashmap (see Hashmap_config)
+#define HASHMAP_CHAINED 0 // array of pointers to one-block buckets of node pointers, nodes come from slabs (default)
+#define HASHMAP_ROBIN_HOOD 1 // open addressing, elements inline in one table, linear probing with robin hood ordering
+#define HASHMAP_DEFAULT_MAX_LOAD 80 // robin hood table grows when it gets 80% full
+#define HASHMAP_DEFAULT_CHAINED_MAX_LOAD 100 // chained map grows when it has more elements than buckets
+#define HASHMAP_FIXED_SIZE UINT16_MAX // max_load which never lets chained map grow
+#define HASHMAP_REHASH_STEP 4 // occupied buckets moved by every insert, find and remove while chained map grows
+#define HASHMAP_BUCKET_CAPACITY 1 // initial capacity of chained buckets, they double when they fill up
+#define HASHMAP_SLAB_NODES 64 // nodes in first slab of chained map, next slabs double up to HASHMAP_SLAB_MAX_NODES
+#define HASHMAP_SLAB_MAX_NODES 4096 // nodes in biggest slab
+#define HASHMAP_BATCH 16 // keys _batch functions hash and prefetch at once before they look any of them up
+#define HASHMAP_ACTIVE_CAPACITY 8 // initial capacity of list of occupied buckets, it doubles when it fills up
+
+// search modes of Hashmap (see Hashmap_set_search_mode)
+#define HASHMAP_SEARCH_CALLBACK D_ARRAY_SEARCH_CALLBACK // bucket scan calls compare for every node (default)
+#define HASHMAP_SEARCH_IDENTITY D_ARRAY_SEARCH_IDENTITY // key is the same pointer as data (vectorized bucket scan)
+#define HASHMAP_SEARCH_INT D_ARRAY_SEARCH_INT // data are ints compared by value (vectorized bucket scan)
+
 // get map length
 #define Hashmap_length(map_ptr) (map_ptr)->length
 // get map capacity
 #define Hashmap_capacity(map_ptr) (map_ptr)->capacity
+// check whether chained map is in the middle of growing (nodes are moved from old_entries to entries)
+#define Hashmap_is_rehashing(map_ptr) ((map_ptr)->old_entries != NULL)
 
 // this macro supports printing Hashmap in pretty nice format (see d_array_print to find out about data_cb and format)
-#define Hashmap_print(map_ptr, data_cb, format) if(!map){log_err("map is NULL.");}else{uint32_t i;for(i=0;i<Hashmap_capacity(map);\
-        i++){if(map->entries[i]){printf("entry: %u -> [ ",i);int64_t j;for(j=0;j<(int64_t)d_array_length(map->entries[i])-1;j++){\
-        printf(format" ",data_cb(((Hashmap_node*)map->entries[i]->data[j])->data));}if(d_array_length(map->entries[i]))\
-        {printf(format,data_cb(((Hashmap_node*)map->entries[i]->data[j])->data));}printf(" ]\n");}}}
+// only occupied buckets are printed, chained map prints them in order they have been occupied in
+#define Hashmap_print(map_ptr, data_cb, format) if(!(map_ptr)){log_err("map is NULL.");}else{cerb_size_t i;\
+        if((map_ptr)->engine==HASHMAP_ROBIN_HOOD){for(i=0;i<Hashmap_capacity(map_ptr);i++){if((map_ptr)->slots[i].distance){\
+        printf("slot: %llu -> "format"\n",(unsigned long long)i,data_cb((map_ptr)->slots[i].data));}}}\
+        else for(i=0;i<(map_ptr)->active_length;i++){Hashmap_bucket *bucket=(map_ptr)->entries[(map_ptr)->active[i]];\
+        printf("entry: %llu -> [ ",(unsigned long long)(map_ptr)->active[i]);cerb_size_t j;for(j=0;j<bucket->length;j++){\
+        printf(j?" "format:format,data_cb(bucket->nodes[j]->data));}printf(" ]\n");}}
 
-// Hashmap_nodes are stored in Hashmap->entry d_arrays
+// Hashmap_nodes are stored in Hashmap->entries buckets
 typedef struct Hashmap_node {
-    void *data; // holds pointer to actual data
-    uint32_t hash; // hash value is stored here
+    void *data; // holds pointer to actual data (has to stay first member, vectorized bucket scan relies on it)
+    void *value; // value of key/value API (data itself when it came through Hashmap_insert)
+    uint32_t hash; // whole hash of data (not bucket index), compare is skipped when it differs and growing reuses it
 } Hashmap_node;
 
+// bucket of chained map, header and node pointers are one allocation (most buckets hold one or two nodes)
+typedef struct Hashmap_bucket {
+    cerb_size_t length; // number of nodes in bucket
+    cerb_size_t capacity; // number of node pointers allocated
+    cerb_size_t active; // position of bucket in active list of its table
+    Hashmap_node *nodes[]; // nodes of bucket
+} Hashmap_bucket;
+
+// block nodes of chained map are carved from. removed nodes go to free list of map and are reused by inserts,
+// slabs themselves are freed only by Hashmap_clear and Hashmap_destroy
+typedef struct Hashmap_slab {
+    struct Hashmap_slab *next; // slab allocated before this one
+    cerb_size_t capacity; // number of nodes in slab
+    Hashmap_node nodes[]; // nodes
+} Hashmap_slab;
+
+// slots of robin hood table, elements are stored inline so lookup touches one cache line most of the time
+typedef struct Hashmap_slot {
+    void *data; // holds pointer to actual data
+    void *value; // value of key/value API (data itself when it came through Hashmap_insert)
+    uint32_t hash; // full hash of data, compare is called only when it matches
+    uint32_t distance; // 1 + distance from home slot (0 means slot is empty)
+} Hashmap_slot;
+
 typedef uint32_t (*hash) (void *data); // hash function pointer
+typedef uint64_t (*Hashmap_seeded_hash) (const void *data, uint64_t seed); // hash function which gets seed of map
 // compare function pointer for map (note consts and restrict. your function has to follow the rules imposed by those)
 typedef int (*Hashmap_cmp) (const void *const restrict data1, const void *const restrict data2);
 
+// counters of map built with CERB_HASHMAP_COUNTERS (library and your code have to agree on it, as on CERB_SIZE_64),
+// they cost an increment on every lookup, so they are compiled out by default
+typedef struct Hashmap_counters {
+    uint64_t hits; // lookups which found key (find, remove, get, upsert...)
+    uint64_t misses; // lookups which didn't
+    uint64_t inserts; // elements added
+    uint64_t resizes; // times table grew
+    uint64_t compares; // compare callback calls
+} Hashmap_counters;
+
 typedef struct Hashmap {
-    d_array **entries; // entries contain other d_arrays as it's data
+    Hashmap_bucket **entries; // buckets, NULL until something is inserted in them (HASHMAP_CHAINED)
+    Hashmap_slot *slots; // table of capacity slots (HASHMAP_ROBIN_HOOD)
+    Hashmap_bucket **old_entries; // entries which are being moved to entries while chained map grows (NULL otherwise)
     Hashmap_cmp compare; // compare callback
-    hash hash; // hash is hash function for Hashmap
-    uint32_t capacity; // capacity is number of entries (wether they are allocated or not)
-    uint32_t length; // length is number of elements each entry holds combined
+    hash hash; // hash is hash function for Hashmap (NULL if seeded_hash is used)
+    Hashmap_seeded_hash seeded_hash; // hash function which gets seed (used when hash is NULL)
+    uint64_t seed; // seed of seeded_hash, random per map unless config gives one
+    const cerb_allocator *allocator; // allocator of entries, buckets and nodes (see allocator.h)
+    cerb_size_t capacity; // capacity is number of entries (wether they are allocated or not) or slots
+    cerb_size_t length; // length is number of elements each entry holds combined
+    cerb_size_t old_capacity; // number of old_entries
+    cerb_size_t rehash_position; // number of old buckets moved already
+    cerb_size_t *active; // indexes of occupied entries, iteration and destroy walk these instead of whole table
+    cerb_size_t active_length; // number of occupied entries
+    cerb_size_t active_capacity; // capacity of active
+    cerb_size_t *old_active; // indexes of occupied old_entries (buckets are moved from its end)
+    cerb_size_t old_active_length; // number of old_entries left to move
+    cerb_size_t old_active_capacity; // capacity of old_active
+    Hashmap_slab *slabs; // slabs nodes come from, newest first
+    Hashmap_node *free_nodes; // removed nodes waiting to be reused (linked through their data)
+    cerb_size_t slab_used; // nodes of newest slab handed out so far
+    uint16_t max_load; // map grows when length would exceed max_load percent of capacity
+    uint8_t search_mode; // how buckets are scanned (HASHMAP_SEARCH_*)
+    uint8_t engine; // HASHMAP_CHAINED or HASHMAP_ROBIN_HOOD
+    uint8_t shift; // 64 - log2(capacity), robin hood home slot is top bits of mixed hash
+#ifdef CERB_HASHMAP_COUNTERS
+    Hashmap_counters counters; // what map has done since it was created
+#endif
 } Hashmap;
 
+// everything Hashmap can be set up with, zeroed fields mean defaults
+typedef struct Hashmap_config {
+    Hashmap_cmp compare; // compare callback (NULL means ints)
+    hash hash; // hash function (NULL means seeded_hash is used)
+    cerb_size_t number_of_entries; // buckets of chained map, elements robin hood table holds without growing
+    const cerb_allocator *allocator; // NULL means cerb_libc_allocator
+    uint8_t engine; // HASHMAP_CHAINED or HASHMAP_ROBIN_HOOD
+    uint16_t max_load; // percent (1 - 99 for HASHMAP_ROBIN_HOOD, HASHMAP_FIXED_SIZE turns growing of chained map off),
+                       // 0 means HASHMAP_DEFAULT_MAX_LOAD or HASHMAP_DEFAULT_CHAINED_MAX_LOAD
+    Hashmap_seeded_hash seeded_hash; // hash function called with seed when hash is NULL (NULL means Hashmap_hash_string)
+    uint64_t seed; // seed for seeded_hash (0 means random seed, different for every map)
+} Hashmap_config;
+
 // create map with number_of_entries size, hash, and cmp (compare) function
 // if number_of_entries is 0, DEFAULT_NUMBER_OF_ENTRIES (500) is allocated
-Hashmap *Hashmap_create(Hashmap_cmp cmp, hash hash, uint32_t number_of_entries);
+// if hash is NULL, keys are nul terminated strings hashed by Hashmap_hash_string with random seed of map
+Hashmap *Hashmap_create(Hashmap_cmp cmp, hash hash, cerb_size_t number_of_entries);
+// create map which allocates its memory with allocator (NULL means cerb_libc_allocator)
+Hashmap *Hashmap_create_with_allocator(Hashmap_cmp cmp, hash hash, cerb_size_t number_of_entries,
+const cerb_allocator *allocator);
+// create map as described by config (see Hashmap_config)
+Hashmap *Hashmap_create_with_config(const Hashmap_config *config);
+
+// fast 64-bit hash of length bytes (wyhash, reads 8 bytes at a time), use it in your own hash functions
+uint64_t Hashmap_hash_bytes(const void *data, size_t length, uint64_t seed);
+// Hashmap_hash_bytes of nul terminated string (default seeded_hash)
+uint64_t Hashmap_hash_string(const void *data, uint64_t seed);
+// random seed, different for every call (map is only mixed in, pass address of your map or anything else)
+uint64_t Hashmap_random_seed(const void *map);
+// default compare of map (data are ints)
+int Hashmap_default_compare(const void *restrict data1, const void *restrict data2);
 
 // insert data in map
 int Hashmap_insert(Hashmap *restrict map, void *data);
@@ -49,9 +159,105 @@ void *Hashmap_find(Hashmap *restrict map, void *restrict key);
 // remove key from map (key and data are the same in most cases, but it still depends on your implementation of default_hash)
 void *Hashmap_remove(Hashmap *restrict map, void *restrict key);
 
+// batched Hashmap_find and Hashmap_insert: keys are hashed and their buckets / slots prefetched HASHMAP_BATCH at
+// a time before any of them is looked at, so cache misses of the batch overlap (pays off for maps much bigger than
+// cpu cache, when you have many keys at hand, joins for example)
+
+// find count keys, found[i] gets data of keys[i] (NULL if it isn't there)
+int Hashmap_find_batch(Hashmap *restrict map, void *const *keys, cerb_size_t count, void **found);
+// insert count data as Hashmap_insert would, on error data before failed one stay inserted
+int Hashmap_insert_batch(Hashmap *restrict map, void *const *data, cerb_size_t count);
+
+// key/value API: data is key (compare and hash get it as before) and every key has value next to it. unlike
+// Hashmap_insert these never add key which is there already, and every call hashes key once and walks its
+// bucket / probe sequence once. data inserted with Hashmap_insert is its own value
+
+// hash key the way map does (seed included), pass it to _prehashed functions to hash key once for several calls
+uint32_t Hashmap_hash(Hashmap *restrict map, void *restrict key);
+// set value of key, key is inserted if it isn't there (if it is, stored key stays and only value is replaced)
+int Hashmap_put(Hashmap *restrict map, void *key, void *value);
+int Hashmap_put_prehashed(Hashmap *restrict map, void *key, void *value, uint32_t hash);
+// value of key (NULL if key isn't there)
+void *Hashmap_get(Hashmap *restrict map, void *restrict key);
+void *Hashmap_get_prehashed(Hashmap *restrict map, void *restrict key, uint32_t hash);
+// pointer to value of key, key is inserted with NULL value if it isn't there (inserted tells which one happened,
+// can be NULL). pointer is valid until map is changed next time, read or write value through it, for example
+// (*(long *) Hashmap_upsert(map, word, NULL))++ if values are counters stored in pointers. NULL on error
+void **Hashmap_upsert(Hashmap *restrict map, void *key, int *inserted);
+void **Hashmap_upsert_prehashed(Hashmap *restrict map, void *key, uint32_t hash, int *inserted);
+// value of key if it is there, otherwise key is inserted with value and value is returned (NULL on error)
+void *Hashmap_get_or_insert(Hashmap *restrict map, void *key, void *value);
+void *Hashmap_get_or_insert_prehashed(Hashmap *restrict map, void *key, void *value, uint32_t hash);
+// remove key and return its value, stored key is put in stored_key (can be NULL) so that you can free it
+// (stored_key is set to NULL if key isn't there)
+void *Hashmap_take(Hashmap *restrict map, void *restrict key, void **stored_key);
+
+// chained map grows incrementally: when it gets max_load full, table of twice the buckets is allocated and every
+// insert, find and remove moves HASHMAP_REHASH_STEP old buckets into it, so no call stalls for whole rehash.
+// move buckets old buckets (0 means all that are left) right away, for example from idle thread or before latency
+// sensitive part starts (does nothing if map isn't growing or is robin hood one, which grows at once)
+int Hashmap_rehash_step(Hashmap *map, cerb_size_t buckets);
+// part of old buckets already moved (0.0 - 1.0, 1.0 when map isn't growing), for monitoring
+double Hashmap_rehash_progress(Hashmap *map);
+
+// choose how Hashmap_find and Hashmap_remove scan buckets (HASHMAP_SEARCH_*), compare isn't called in vectorized modes
+int Hashmap_set_search_mode(Hashmap *map, uint8_t search_mode);
+
+// bytes map holds: struct, table, buckets and slabs of nodes (data you store isn't counted)
+size_t Hashmap_memory_usage(Hashmap *map);
+
+#define HASHMAP_STATS_HISTOGRAM 8 // histogram slots, last one counts everything longer too
+
+// shape of map, Hashmap_stats fills it. bad hash shows up as long chains / probes and compares per lookup well
+// above 1.0 (keys whose hashes are equal are told apart only by compare)
+typedef struct Hashmap_statistics {
+    cerb_size_t length; // number of elements
+    cerb_size_t capacity; // buckets or slots (both tables while chained map grows)
+    double load_factor; // length / capacity
+    cerb_size_t occupied; // buckets or slots holding something
+    // chained: histogram[i] is number of buckets with i elements (empty ones in histogram[0])
+    // robin hood: histogram[i] is number of elements i slots away from their home slot
+    cerb_size_t histogram[HASHMAP_STATS_HISTOGRAM];
+    cerb_size_t max_chain; // longest bucket or probe (1 means every element is where its hash points)
+    double average_chain; // elements looked at by average successful lookup
+    double expected_compares; // compare calls average successful lookup makes (0.0 in vectorized search modes)
+    // CERB_HASHMAP_COUNTERS only (zeroed otherwise)
+    Hashmap_counters counters;
+    double compares_per_lookup; // counters.compares / (hits + misses)
+} Hashmap_statistics;
+
+// walk map and fill stats, O(capacity) for robin hood map and O(length) for chained one
+int Hashmap_stats(Hashmap *map, Hashmap_statistics *stats);
+
+// iterator over map, chained map visits only occupied buckets (O(length) whatever capacity is), robin hood map
+// scans its slots. map must not change while you iterate, and that includes Hashmap_find of growing chained map
+// (it moves buckets)
+typedef struct Hashmap_iter {
+    Hashmap *map;
+    int old; // old_entries are being visited
+    cerb_size_t bucket; // position in active list (slot of robin hood map)
+    cerb_size_t node; // position in bucket
+    void *value; // value of data last returned by Hashmap_iter_next
+} Hashmap_iter;
+
+// start iteration over map
+int Hashmap_iter_begin(Hashmap *map, Hashmap_iter *iter);
+// next data (NULL once every one has been returned), its value is put in iter->value
+void *Hashmap_iter_next(Hashmap_iter *iter);
+// loop over every data of map: Hashmap_iter iter; void *data; Hashmap_foreach(map, iter, data) { ... }
+#define Hashmap_foreach(map_ptr, iter, data_var) \
+        for (Hashmap_iter_begin((map_ptr), &(iter)); ((data_var) = Hashmap_iter_next(&(iter))) != NULL;)
+
 typedef void (*Hashmap_dealloc) (void *data); // function pointer for handling data freeing
 
+// remove every element (callbacks work as for Hashmap_destroy_with_values, NULL dealloc_cb leaves data alone),
+// map keeps its capacity. chained map frees only occupied buckets
+int Hashmap_clear(Hashmap *map, Hashmap_dealloc dealloc_cb, Hashmap_dealloc value_dealloc_cb);
+
 // destroy map and set it to NULL on stack (you have to provide reference for map)
 int Hashmap_destroy(Hashmap **restrict map, Hashmap_dealloc dealloc_cb);
+// destroy map whose values need freeing too, value_dealloc_cb isn't called for NULL values and for data which is
+// its own value (Hashmap_insert), dealloc_cb gets keys as Hashmap_destroy does
+int Hashmap_destroy_with_values(Hashmap **restrict map, Hashmap_dealloc dealloc_cb, Hashmap_dealloc value_dealloc_cb);
 
 #endif /* FA51084D_5EA5_4D17_AF8D_98B4A541B182 */
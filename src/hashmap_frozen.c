@@ -0,0 +1,384 @@
+#include <stdlib.h>
+#include "hashmap_frozen.h"
+
+// murmur3 64-bit finalizer, spreads every bit of x over the whole word
+static inline uint64_t Hashmap_frozen_mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// internally used to map x onto [0, range) with multiply instead of division (range fits in 32 bits almost always)
+static inline cerb_size_t Hashmap_frozen_reduce(uint64_t x, cerb_size_t range)
+{
+#ifdef CERB_SIZE_64
+    if (range > UINT32_MAX) return (cerb_size_t) (x % range);
+#endif
+
+    return (cerb_size_t) (((x >> 32) * (uint64_t) range) >> 32);
+}
+
+// internally used to hash key into 64 bits (32-bit hash callback is spread, seeded hash is 64-bit already)
+static inline uint64_t Hashmap_frozen_hash(const Hashmap_frozen *frozen, void *key)
+{
+    if (frozen->hash) return Hashmap_frozen_mix(frozen->hash(key));
+
+    return frozen->seeded_hash(key, frozen->seed);
+}
+
+// internally used to get bucket of hash. buckets are skewed (as in PTHash): 60% of keys go to the first 30% of
+// buckets, so that there are many big buckets, which get their pilots first while table is empty, and small
+// ones are left for the end, when free positions are hard to hit
+static inline cerb_size_t Hashmap_frozen_bucket(const Hashmap_frozen *frozen, uint64_t hash)
+{
+    if ((uint32_t) hash < (uint32_t) (UINT32_MAX * 0.6)) return Hashmap_frozen_reduce(hash, frozen->dense_buckets);
+
+    return frozen->dense_buckets + Hashmap_frozen_reduce(hash, frozen->buckets - frozen->dense_buckets);
+}
+
+// internally used to get position pilot sends key with hash to (it can be past table_length)
+static inline cerb_size_t Hashmap_frozen_place(const Hashmap_frozen *frozen, uint64_t hash, uint32_t pilot)
+{
+    return Hashmap_frozen_reduce(Hashmap_frozen_mix(hash ^ (pilot * 0x9E3779B97F4A7C15ULL)), frozen->positions);
+}
+
+// internally used to check whether data is key (search mode of map applies)
+static inline int Hashmap_frozen_matches(const Hashmap_frozen *frozen, void *data, void *key)
+{
+    switch (frozen->search_mode) {
+        case HASHMAP_SEARCH_IDENTITY: return data == key;
+        case HASHMAP_SEARCH_INT: return *(int *) data == *(int *) key;
+    }
+
+    return frozen->compare(data, key) == HASHMAP_EQUAL;
+}
+
+// bit i of bitmap
+#define Hashmap_frozen_taken(bitmap, i) (((bitmap)[(i) / 64] >> ((i) % 64)) & 1)
+
+// internally used to find pilot which sends all size keys (with hashes) of bucket to free and distinct positions,
+// positions they got are put in placed. returns CERB_ERR if there is no such pilot below HASHMAP_FROZEN_MAX_PILOT
+static int Hashmap_frozen_pilot(const Hashmap_frozen *frozen, const uint64_t *taken, const uint64_t *hashes,
+                                cerb_size_t size, cerb_size_t *placed, uint16_t *pilot)
+{
+    uint32_t candidate;
+    cerb_size_t i, j;
+
+    for (candidate = 0; candidate < HASHMAP_FROZEN_MAX_PILOT; candidate++) {
+        for (i = 0; i < size; i++) {
+            placed[i] = Hashmap_frozen_place(frozen, hashes[i], candidate);
+            if (Hashmap_frozen_taken(taken, placed[i])) break;
+            for (j = 0; j < i && placed[j] != placed[i]; j++);
+            if (j < i) break;
+        }
+        if (i == size) {
+            *pilot = (uint16_t) candidate;
+            return CERB_OK;
+        }
+    }
+
+    return CERB_ERR;
+}
+
+// scratch memory of Hashmap_freeze
+typedef struct Hashmap_frozen_scratch {
+    Hashmap_frozen_entry *items; // keys and values, grouped by bucket once they are sorted
+    uint64_t *hashes; // hashes of items
+    cerb_size_t *starts; // first item of every bucket
+    cerb_size_t *sizes; // number of items of every bucket
+    cerb_size_t *by_size; // buckets from the biggest one down, followed by counters of counting sort
+    cerb_size_t *placed; // positions of bucket pilot is tried for
+    uint64_t *taken; // bitmap of positions which are taken
+    cerb_size_t length, buckets, largest, words; // number of items, buckets, items of biggest bucket, taken words
+} Hashmap_frozen_scratch;
+
+// internally used to free scratch memory of Hashmap_freeze (whatever of it has been allocated)
+static void Hashmap_frozen_scratch_free(const cerb_allocator *allocator, Hashmap_frozen_scratch *scratch)
+{
+    cerb_size_t length = scratch->length ? scratch->length : 1;
+
+    if (scratch->items) cerb_free(allocator, scratch->items, sizeof(Hashmap_frozen_entry) * length);
+    if (scratch->hashes) cerb_free(allocator, scratch->hashes, sizeof(uint64_t) * length);
+    if (scratch->starts) cerb_free(allocator, scratch->starts, sizeof(cerb_size_t) * (scratch->buckets + 1));
+    if (scratch->sizes) cerb_free(allocator, scratch->sizes, sizeof(cerb_size_t) * scratch->buckets);
+    if (scratch->by_size) {
+        cerb_free(allocator, scratch->by_size, sizeof(cerb_size_t) * (scratch->buckets + scratch->largest + 2));
+    }
+    if (scratch->placed) cerb_free(allocator, scratch->placed, sizeof(cerb_size_t) * (scratch->largest + 1));
+    if (scratch->taken) cerb_free(allocator, scratch->taken, sizeof(uint64_t) * scratch->words);
+}
+
+// internally used to sort items into buckets (counting sort). items of every bucket end up next to each other,
+// so that pilots are tried on hashes which are in cache and placing bucket reads its items in one go
+static int Hashmap_frozen_sort(Hashmap_frozen *frozen, Hashmap_frozen_scratch *scratch)
+{
+    const cerb_allocator *allocator = frozen->allocator;
+    cerb_size_t length = scratch->length ? scratch->length : 1, i, b;
+
+    Hashmap_frozen_entry *items = cerb_alloc(allocator, sizeof(Hashmap_frozen_entry) * length);
+    uint64_t *hashes = cerb_alloc(allocator, sizeof(uint64_t) * length);
+    if (!items || !hashes) {
+        if (items) cerb_free(allocator, items, sizeof(Hashmap_frozen_entry) * length);
+        if (hashes) cerb_free(allocator, hashes, sizeof(uint64_t) * length);
+        sentinel("Out of memory.");
+    }
+
+    for (i = 0; i < scratch->length; i++) scratch->sizes[Hashmap_frozen_bucket(frozen, scratch->hashes[i])]++;
+    for (b = 0; b < scratch->buckets; b++) {
+        scratch->starts[b + 1] = scratch->starts[b] + scratch->sizes[b];
+        scratch->sizes[b] = 0;
+    }
+    for (i = 0; i < scratch->length; i++) {
+        b = Hashmap_frozen_bucket(frozen, scratch->hashes[i]);
+        cerb_size_t to = scratch->starts[b] + scratch->sizes[b]++;
+        items[to] = scratch->items[i];
+        hashes[to] = scratch->hashes[i];
+    }
+
+    cerb_free(allocator, scratch->items, sizeof(Hashmap_frozen_entry) * length);
+    cerb_free(allocator, scratch->hashes, sizeof(uint64_t) * length);
+    scratch->items = items;
+    scratch->hashes = hashes;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// internally used to put item in overflow map, which is created on first use
+static int Hashmap_frozen_overflow(Hashmap_frozen *frozen, Hashmap *map, Hashmap_frozen_entry *item)
+{
+    if (!frozen->overflow) {
+        Hashmap_config config = {map->compare, map->hash, 0, map->allocator, HASHMAP_ROBIN_HOOD, 0, map->seeded_hash,
+                                 map->seed};
+        frozen->overflow = Hashmap_create_with_config(&config);
+        check(frozen->overflow != NULL, "Failed to create overflow map.");
+        Hashmap_set_search_mode(frozen->overflow, map->search_mode);
+    }
+
+    // key which is there already (map got it twice through Hashmap_insert) keeps its first value
+    int inserted = 0;
+    void **value = Hashmap_upsert(frozen->overflow, item->data, &inserted);
+    check(value != NULL, "Failed to insert in overflow map.");
+    if (inserted) *value = item->value;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// build snapshot: keys are sorted into buckets, keys with duplicate hashes go to overflow map, then buckets get
+// their pilots from the biggest one down (big ones are hard to fit once table fills up), keys of bucket which
+// doesn't fit with any 16-bit pilot go to overflow map too (it practically never happens). positions past
+// table_length get remapped to free entries at the end
+Hashmap_frozen *Hashmap_freeze(Hashmap *map)
+{
+    Hashmap_frozen *frozen = NULL;
+    Hashmap_frozen_scratch scratch = {0};
+    cerb_size_t i, j, b;
+
+    check(map != NULL, "map is NULL.");
+
+    const cerb_allocator *allocator = map->allocator;
+    frozen = cerb_calloc(allocator, sizeof(Hashmap_frozen));
+    check_mem(frozen);
+
+    frozen->compare = map->compare;
+    frozen->hash = map->hash;
+    frozen->seeded_hash = map->seeded_hash;
+    frozen->seed = map->seed;
+    frozen->allocator = allocator;
+    frozen->search_mode = map->search_mode;
+    frozen->length = scratch.length = Hashmap_length(map);
+    frozen->buckets = scratch.buckets = scratch.length / HASHMAP_FROZEN_BUCKET_KEYS + 2;
+    frozen->dense_buckets = frozen->buckets * 3 / 10 + 1;
+
+    // keys and their hashes
+    scratch.items = cerb_alloc(allocator, sizeof(Hashmap_frozen_entry) * (scratch.length ? scratch.length : 1));
+    scratch.hashes = cerb_alloc(allocator, sizeof(uint64_t) * (scratch.length ? scratch.length : 1));
+    scratch.starts = cerb_calloc(allocator, sizeof(cerb_size_t) * (scratch.buckets + 1));
+    scratch.sizes = cerb_calloc(allocator, sizeof(cerb_size_t) * scratch.buckets);
+    frozen->pilots = cerb_calloc(allocator, sizeof(uint16_t) * frozen->buckets);
+    check_mem(scratch.items && scratch.hashes && scratch.starts && scratch.sizes && frozen->pilots);
+
+    Hashmap_iter iter;
+    void *data;
+    i = 0;
+    Hashmap_foreach(map, iter, data) {
+        scratch.items[i].data = data;
+        scratch.items[i].value = iter.value;
+        scratch.hashes[i++] = Hashmap_frozen_hash(frozen, data);
+    }
+    check(Hashmap_frozen_sort(frozen, &scratch) == CERB_OK, "Failed to sort keys.");
+
+    // equal hashes land in the same bucket, no pilot can separate them, so later ones go to overflow map
+    frozen->table_length = scratch.length;
+    for (b = 0; b < scratch.buckets; b++) {
+        Hashmap_frozen_entry *items = scratch.items + scratch.starts[b];
+        uint64_t *hashes = scratch.hashes + scratch.starts[b];
+        for (i = 1; i < scratch.sizes[b]; i++) {
+            for (j = 0; j < i && hashes[j] != hashes[i]; j++);
+            if (j == i) continue;
+
+            check(Hashmap_frozen_overflow(frozen, map, &items[i]) == CERB_OK, "Failed to freeze map.");
+            scratch.sizes[b]--;
+            items[i] = items[scratch.sizes[b]];
+            hashes[i] = hashes[scratch.sizes[b]];
+            i--;
+            frozen->table_length--;
+        }
+        if (scratch.sizes[b] > scratch.largest) scratch.largest = scratch.sizes[b];
+    }
+    frozen->positions = frozen->table_length + frozen->table_length / HASHMAP_FROZEN_SLACK + 1;
+
+    // buckets from the biggest one down (counting sort by size)
+    scratch.by_size = cerb_calloc(allocator, sizeof(cerb_size_t) * (scratch.buckets + scratch.largest + 2));
+    scratch.placed = cerb_alloc(allocator, sizeof(cerb_size_t) * (scratch.largest + 1));
+    scratch.words = frozen->positions / 64 + 1;
+    scratch.taken = cerb_calloc(allocator, sizeof(uint64_t) * scratch.words);
+    frozen->entries = cerb_alloc(allocator, sizeof(Hashmap_frozen_entry) * frozen->positions);
+    frozen->entries_capacity = frozen->positions;
+    check_mem(scratch.by_size && scratch.placed && scratch.taken && frozen->entries);
+
+    cerb_size_t *counts = scratch.by_size + scratch.buckets, largest = scratch.largest;
+    for (b = 0; b < scratch.buckets; b++) counts[largest - scratch.sizes[b] + 1]++;
+    for (i = 1; i <= largest + 1; i++) counts[i] += counts[i - 1];
+    for (b = 0; b < scratch.buckets; b++) scratch.by_size[counts[largest - scratch.sizes[b]]++] = b;
+
+    for (i = 0; i < scratch.buckets && scratch.sizes[scratch.by_size[i]]; i++) {
+        b = scratch.by_size[i];
+        Hashmap_frozen_entry *items = scratch.items + scratch.starts[b];
+        if (Hashmap_frozen_pilot(frozen, scratch.taken, scratch.hashes + scratch.starts[b], scratch.sizes[b],
+                                 scratch.placed, &frozen->pilots[b]) != CERB_OK) {
+            for (j = 0; j < scratch.sizes[b]; j++) {
+                check(Hashmap_frozen_overflow(frozen, map, &items[j]) == CERB_OK, "Failed to freeze map.");
+            }
+            frozen->table_length -= scratch.sizes[b];
+            continue;
+        }
+        for (j = 0; j < scratch.sizes[b]; j++) {
+            scratch.taken[scratch.placed[j] / 64] |= (uint64_t) 1 << (scratch.placed[j] % 64);
+            frozen->entries[scratch.placed[j]] = items[j];
+        }
+    }
+
+    // keys placed past table_length move to free entries below it, remap remembers where
+    frozen->remap = cerb_calloc(allocator, sizeof(cerb_size_t) * (frozen->positions - frozen->table_length));
+    check_mem(frozen->remap);
+    cerb_size_t free_entry = 0;
+    for (i = frozen->table_length; i < frozen->positions; i++) {
+        if (!Hashmap_frozen_taken(scratch.taken, i)) continue;
+        while (Hashmap_frozen_taken(scratch.taken, free_entry)) free_entry++;
+        frozen->entries[free_entry] = frozen->entries[i];
+        frozen->remap[i - frozen->table_length] = free_entry++;
+    }
+
+    // spare entries aren't needed anymore (if shrinking fails snapshot just keeps them)
+    if (frozen->table_length) {
+        Hashmap_frozen_entry *packed = cerb_realloc(allocator, frozen->entries,
+                                                    sizeof(Hashmap_frozen_entry) * frozen->positions,
+                                                    sizeof(Hashmap_frozen_entry) * frozen->table_length);
+        if (packed) {
+            frozen->entries = packed;
+            frozen->entries_capacity = frozen->table_length;
+        }
+    }
+
+    Hashmap_frozen_scratch_free(allocator, &scratch);
+
+    return frozen;
+
+error:
+    if (map) {
+        Hashmap_frozen_scratch_free(map->allocator, &scratch);
+        if (frozen) Hashmap_frozen_destroy(&frozen);
+    }
+    return NULL;
+}
+
+// find data with key, one probe in table (overflow map is searched only when it exists and key isn't in table)
+static inline Hashmap_frozen_entry *Hashmap_frozen_lookup(const Hashmap_frozen *frozen, void *key)
+{
+    if (frozen->table_length) {
+        uint64_t hash = Hashmap_frozen_hash(frozen, key);
+        uint16_t pilot = frozen->pilots[Hashmap_frozen_bucket(frozen, hash)];
+        cerb_size_t position = Hashmap_frozen_place(frozen, hash, pilot);
+        if (position >= frozen->table_length) position = frozen->remap[position - frozen->table_length];
+
+        Hashmap_frozen_entry *entry = &frozen->entries[position];
+        if (Hashmap_frozen_matches(frozen, entry->data, key)) return entry;
+    }
+
+    return NULL;
+}
+
+void *Hashmap_frozen_find(const Hashmap_frozen *frozen, void *key)
+{
+    check(frozen != NULL, "frozen is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    Hashmap_frozen_entry *entry = Hashmap_frozen_lookup(frozen, key);
+    if (entry) return entry->data;
+
+    if (frozen->overflow) return Hashmap_find(frozen->overflow, key);
+
+error: // fall through
+    return NULL;
+}
+
+void *Hashmap_frozen_get(const Hashmap_frozen *frozen, void *key)
+{
+    check(frozen != NULL, "frozen is NULL.");
+    check(key != NULL, "key is NULL.");
+
+    Hashmap_frozen_entry *entry = Hashmap_frozen_lookup(frozen, key);
+    if (entry) return entry->value;
+
+    if (frozen->overflow) return Hashmap_get(frozen->overflow, key);
+
+error: // fall through
+    return NULL;
+}
+
+// bytes snapshot holds
+size_t Hashmap_frozen_memory_usage(const Hashmap_frozen *frozen)
+{
+    check(frozen != NULL, "frozen is NULL.");
+
+    return sizeof(Hashmap_frozen) + sizeof(Hashmap_frozen_entry) * frozen->entries_capacity +
+           sizeof(uint16_t) * frozen->buckets + sizeof(cerb_size_t) * (frozen->positions - frozen->table_length) +
+           (frozen->overflow ? Hashmap_memory_usage(frozen->overflow) : 0);
+
+error:
+    return 0;
+}
+
+// deallocate snapshot
+int Hashmap_frozen_destroy(Hashmap_frozen **frozen)
+{
+    check(frozen != NULL, "Address of frozen is NULL.");
+    check(*frozen != NULL, "frozen is NULL.");
+
+    const cerb_allocator *allocator = (*frozen)->allocator;
+    if ((*frozen)->entries) {
+        cerb_free(allocator, (*frozen)->entries, sizeof(Hashmap_frozen_entry) * (*frozen)->entries_capacity);
+    }
+    if ((*frozen)->pilots) cerb_free(allocator, (*frozen)->pilots, sizeof(uint16_t) * (*frozen)->buckets);
+    if ((*frozen)->remap) {
+        cerb_free(allocator, (*frozen)->remap, sizeof(cerb_size_t) * ((*frozen)->positions - (*frozen)->table_length));
+    }
+    if ((*frozen)->overflow) Hashmap_destroy(&(*frozen)->overflow, NULL);
+    cerb_free(allocator, *frozen, sizeof(Hashmap_frozen));
+    *frozen = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
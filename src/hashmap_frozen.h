@@ -0,0 +1,61 @@
+#ifndef D93F6A1E_B84C_4E27_A5D0_3C6E19F7B240
+#define D93F6A1E_B84C_4E27_A5D0_3C6E19F7B240
+
+#include "hashmap.h"
+
+// read-only snapshot of Hashmap for maps which are built once and then only read. keys and values are packed
+// in one array and minimal perfect hash (PTHash style) tells where every key is: keys are split into small
+// buckets by hash, and every bucket gets pilot (found while freezing) which sends its keys to free positions.
+// lookup hashes key, reads pilot of its bucket and compares key at the one position it gets, no chains and no
+// probing. table costs 2 bytes of pilot per HASHMAP_FROZEN_BUCKET_KEYS keys and remap of spare positions on top
+// of keys and values (well under a byte per key).
+// snapshot holds pointers to data and values of map, they have to stay alive while it is used (map itself can
+// be destroyed, without freeing data). keys with the same 64-bit hash (possible when map has 32-bit hash
+// callback) can't be told apart by any hash, so all but one of them go to small ordinary Hashmap
+
+#define HASHMAP_FROZEN_BUCKET_KEYS 4 // average keys per pilot (more keys means less memory and slower freezing)
+#define HASHMAP_FROZEN_SLACK 8 // there are length / HASHMAP_FROZEN_SLACK spare positions, which are remapped
+#define HASHMAP_FROZEN_MAX_PILOT (1u << 16) // pilots are 16-bit, bucket which doesn't fit goes to overflow map
+
+// get number of keys in snapshot
+#define Hashmap_frozen_length(frozen_ptr) (frozen_ptr)->length
+
+typedef struct Hashmap_frozen_entry {
+    void *data; // key
+    void *value; // value of key (data itself when it came through Hashmap_insert)
+} Hashmap_frozen_entry;
+
+typedef struct Hashmap_frozen {
+    Hashmap_frozen_entry *entries; // table_length keys and values, packed
+    uint16_t *pilots; // pilot of every bucket
+    cerb_size_t *remap; // entries keys of positions past table_length have been moved to
+    Hashmap *overflow; // keys with 64-bit hash of another key or of bucket which didn't fit (NULL if there are none)
+    Hashmap_cmp compare; // compare callback of map
+    hash hash; // hash callback of map (NULL if seeded_hash is used)
+    Hashmap_seeded_hash seeded_hash; // seeded hash of map
+    uint64_t seed; // seed of map
+    const cerb_allocator *allocator; // allocator of map
+    cerb_size_t length; // number of keys (overflow included)
+    cerb_size_t table_length; // number of entries
+    cerb_size_t buckets; // number of pilots
+    cerb_size_t dense_buckets; // first buckets, which get most keys
+    cerb_size_t positions; // positions pilots send keys to (table_length and spare ones)
+    cerb_size_t entries_capacity; // entries allocated (table_length, unless shrinking them has failed)
+    uint8_t search_mode; // search mode of map
+} Hashmap_frozen;
+
+// build snapshot of map (map isn't changed), NULL on error. takes O(length) time and memory of map size
+Hashmap_frozen *Hashmap_freeze(Hashmap *map);
+
+// find data with key (NULL if it isn't there)
+void *Hashmap_frozen_find(const Hashmap_frozen *frozen, void *key);
+// value of key (NULL if it isn't there)
+void *Hashmap_frozen_get(const Hashmap_frozen *frozen, void *key);
+
+// bytes snapshot holds (data and values aren't counted)
+size_t Hashmap_frozen_memory_usage(const Hashmap_frozen *frozen);
+
+// destroy snapshot and set it to NULL on stack (data and values are left alone)
+int Hashmap_frozen_destroy(Hashmap_frozen **frozen);
+
+#endif /* D93F6A1E_B84C_4E27_A5D0_3C6E19F7B240 */
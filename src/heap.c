@@ -1,56 +1,85 @@
 #include <stdlib.h>
 #include "heap.h"
 
-// swap data on two different positions in heap (internally used by emerge and sink functions)
-#define HEAP_SWAP(heap, position1, position2)\
-            void *_data1 = (heap)->data[(position1)];\
-            (heap)->data[(position1)] = (heap)->data[(position2)];\
-            (heap)->data[(position2)] = _data1;
+// hint cpu to start loading address into cache (read, keep it), does nothing where builtin isn't there
+#if defined(__GNUC__)
+#define HEAP_PREFETCH(address) __builtin_prefetch((address), 0, 3)
+#else
+#define HEAP_PREFETCH(address) ((void) (address))
+#endif
 
 // emerge node from a bottom towards a root until needed
-static void emerge(Heap *restrict heap, uint32_t node_position)
+static void emerge(Heap *restrict heap, cerb_size_t node_position)
 {
-    // node_position is current node's position we are adjusting
-    uint32_t parent_index = parent(node_position); // determine parent of node
+    cerb_size_t arity = heap_arity(heap);
+    void *node = heap->data[node_position]; // node is written once, parents move down into the hole it leaves
 
     // loop until we have reached root or until invariant is corrupted
-    while (node_position != 0 && heap->compare(heap->data[node_position], heap->data[parent_index]) == HEAP_GREATER) {
-        HEAP_SWAP(heap, node_position, parent_index); // swap child and parent
-        node_position = parent_index; // update swapped child's position
-        parent_index = parent(node_position); // calculate new index for swapped child
+    while (node_position != 0) {
+        cerb_size_t parent_index = (node_position - 1) / arity; // determine parent of node
+        if (heap->compare(node, heap->data[parent_index]) != HEAP_GREATER) break;
+
+        heap->data[node_position] = heap->data[parent_index]; // move parent down
+        node_position = parent_index; // and go up
     }
+    heap->data[node_position] = node;
 }
 
 // sink node from up towards bottom until needed
-static void sink(Heap *restrict heap, uint32_t node_position)
-{ // node_position is current node's position we are adjusting and we assume it holds max value
-    uint64_t max_index = node_position;
+static void sink(Heap *restrict heap, cerb_size_t node_position)
+{
+    cerb_size_t arity = heap_arity(heap), length = d_array_length(heap);
+    void *node = heap->data[node_position]; // node is written once, children move up into the hole it leaves
 
     while (1) {
         // make this uint64_t to prevent overflow (position miscalculation)
-        uint64_t left_child_index = heap_index_of_left_child_of_parent(node_position);
-        
-        // check to see if we are going out of bounds with left node and break if so
-        if (left_child_index > heap_index_of_last(heap)) break;
-
-        // compare current node with left node and pick maximum out of those
-        if (heap->compare(heap->data[node_position], heap->data[left_child_index]) == HEAP_LESS) {
-            max_index = left_child_index;
+        uint64_t first_child = (uint64_t) arity * node_position + 1, child, max_index = first_child;
+
+        // check to see if we are going out of bounds with first child and break if so
+        if (first_child >= length) break;
+        uint64_t end = first_child + arity < length ? first_child + arity : length;
+
+        // children sit next to each other, start loading data compare reads and children of children (node goes
+        // to one of those next) before anything is compared, so that cache misses of one level overlap
+        for (child = first_child; child < end; child++) {
+            HEAP_PREFETCH(heap->data[child]);
+            if (arity * child + 1 < length) HEAP_PREFETCH(&heap->data[arity * child + 1]);
         }
-        // make this uint64_t to prevent overflow (position miscalculation)
-        uint64_t right_child_index = heap_index_of_right_child_of_parent(node_position);
 
-        // check to see if we are going out of bounds with right node and if not so
-        if (right_child_index <= heap_index_of_last(heap) && // compare current maximum with right node and pick maximum again
-        heap->compare(heap->data[max_index], heap->data[right_child_index]) == HEAP_LESS) {
-            max_index = right_child_index;
+        // pick maximum out of children
+        for (child = first_child + 1; child < end; child++) {
+            if (heap->compare(heap->data[max_index], heap->data[child]) == HEAP_LESS) max_index = child;
         }
 
-        if (max_index == node_position) break; // if max index hasn't changed at this point, heap invariant is satisfied
+        // if node isn't less than maximum child, heap invariant is satisfied
+        if (heap->compare(node, heap->data[max_index]) != HEAP_LESS) break;
+
+        heap->data[node_position] = heap->data[max_index]; // move maximum child up
+        node_position = max_index; // update node_position to its index
+    }
+    heap->data[node_position] = node;
+}
+
+// internally used to restore heap invariant after elements from position on were appended to heap (elements
+// before it are heap already). only nodes with new elements below them are sunk, level by level from the bottom
+// (Floyd's build, which is O(n) when from is 0 and O(appended + log n) otherwise)
+static void heap_build(Heap *heap, cerb_size_t from)
+{
+    cerb_size_t arity = heap_arity(heap);
+    if (d_array_length(heap) < 2 || from >= d_array_length(heap)) return;
+
+    // parents of appended elements, from parent of first one to parent of last one
+    cerb_size_t low = from ? (from - 1) / arity : 0, high = (heap_index_of_last(heap) - 1) / arity, i;
 
-        // swap current position of node and max_index (determined above)
-        HEAP_SWAP(heap, node_position, max_index);
-        node_position = max_index; // update node_position to swapped index
+    while (1) {
+        // nodes sink after every node below them, so their subtrees are heaps already
+        for (i = high + 1; i-- > low;) sink(heap, i);
+        if (low == 0) break;
+
+        // one level up: parents of this range which haven't been sunk yet
+        cerb_size_t parent_of_high = (high - 1) / arity;
+        high = parent_of_high < low ? parent_of_high : low - 1;
+        low = (low - 1) / arity;
     }
 }
 
@@ -81,21 +110,15 @@ void *heap_pop(Heap *heap)
     check(heap != NULL, "heap is NULL.");
     check(d_array_length(heap) != 0, "heap is empty.");
 
-    if (d_array_length(heap) < 3) { // if length is 0 we return 0. if length is 2 we return [0] and replacement is automatic
-        return d_array_pop_front(heap);
-    } else { // greater than 3 needs adjustments for heap invariant
-        void *max_index = heap->data[0]; // save max_index as its being overwritten
-        // heap->data[0] = d_array_pop_back(heap); // pop last element from array and assign it to root
-        // debug("max_index = %d", *(int *)max_index);
-        void *new_root = d_array_pop_back(heap);
+    void *max_index = heap->data[0]; // save max_index as its being overwritten
+    void *new_root = d_array_pop_back(heap); // pop last element from array and assign it to root (O(1) for any length)
+    if (d_array_length(heap)) { // if popped element was root itself, there is nothing to adjust
         heap->data[0] = new_root;
-        // debug("temp = %d", *(int *)temp);
-        // d_array_print(heap, data_cb, "%d");
-        // debug("(in heap) data = %d", *(int *)heap->data[0]);
         sink(heap, 0); // adjust to satisfy heap invariant
-        return max_index; // return value held by root
     }
 
+    return max_index; // return value held by root
+
 error:
     return NULL;
 }
@@ -148,20 +171,11 @@ Heap *heapify(d_array *restrict *restrict array)
     check(*array != NULL, "array is NULL.");
     check(d_array_length(*array) > 1, "Doesn't make sense to heapify array of length <= 1.");
 
-    // last non-leaf node
-    uint32_t node_pos = parent(heap_index_of_last(*array));
-
-    // emerge every node after last non-leaf node starting from lowest indexed leaf node
-    uint32_t i;
-    for (i = node_pos + 1; i < d_array_length(*array); i++) {
-        emerge(*array, i);
-    }
+    // heap functions index data block directly, so ring arrays have to become linear
+    int rc = d_array_set_mode(*array, D_ARRAY_LINEAR);
+    check(rc != CERB_ERR, "Failed to linearize array.");
 
-    // emerge and sink (depending which one is required) the rest of the nodes starting from root
-    for (i = 0; i < node_pos + 1; i++) {
-        emerge(*array, i);
-        sink(*array, i);
-    }
+    heap_build(*array, 0);
 
     Heap *new_heap = *array; // save heapified array
     *array = NULL; // set old array on stack to NULL
@@ -182,24 +196,124 @@ Heap *heap_meld(Heap *restrict *restrict heap1, Heap *restrict *restrict heap2)
     check(*heap2 != NULL, "heap2 is NULL.");
     check(d_array_length(*heap1) != 0, "heap1 is empty.");
     check(d_array_length(*heap2) != 0, "heap2 is empty.");
-    check((uint64_t) d_array_length(*heap1) + d_array_length(*heap2) <= UINT32_MAX,
-    "Can't expand past max available size, AKA UINT32_MAX.");
+    check(CERB_SIZE_FITS((uint64_t) d_array_length(*heap1) + d_array_length(*heap2)),
+    "Can't expand past max available size, AKA CERB_SIZE_MAX.");
     check((*heap1)->compare == (*heap2)->compare, "heap1 compare and heap2 compare don't match.");
 
-    d_array *new_array = d_array_create((*heap1)->compare, d_array_length(*heap1) + d_array_length(*heap2));
+    check(heap_arity(*heap1) == heap_arity(*heap2), "heap1 arity and heap2 arity don't match.");
+
+    // bigger heap goes first and stays heap as it is, only smaller one has to be built into it
+    Heap *bigger = d_array_length(*heap1) >= d_array_length(*heap2) ? *heap1 : *heap2;
+    Heap *smaller = bigger == *heap1 ? *heap2 : *heap1;
+
+    d_array *new_array = d_array_create_with_allocator((*heap1)->compare, d_array_length(*heap1) + d_array_length(*heap2),
+    (*heap1)->allocator);
+    check(new_array != NULL, "Failed to create melded heap.");
+    new_array->heap_arity = (*heap1)->heap_arity;
+
+    // copy memory from bigger heap to new_array
+    memcpy(new_array->data, bigger->data, d_array_length(bigger) * sizeof(void *));
+    new_array->length = d_array_length(bigger); // set length
+
+    // copy memory from smaller heap to new_array
+    memcpy(new_array->data + d_array_length(new_array), smaller->data, d_array_length(smaller) * sizeof(void *));
+    new_array->length += d_array_length(smaller); // set length
+
+    heap_build(new_array, d_array_length(bigger));
+
+    return new_array;
+
+error:
+    return NULL;
+}
+
+// make heap d-ary, elements heap holds are rearranged
+int heap_set_arity(Heap *heap, uint8_t arity)
+{
+    check(heap != NULL, "heap is NULL.");
+    check(arity >= 2 && arity <= HEAP_MAX_ARITY, "Invalid arity.");
+
+    // heap functions index data block directly, so ring arrays have to become linear
+    int rc = d_array_set_mode(heap, D_ARRAY_LINEAR);
+    check(rc != CERB_ERR, "Failed to linearize heap.");
+
+    if (arity == heap_arity(heap)) return CERB_OK;
+
+    heap->heap_arity = arity;
+    heap_build(heap, 0);
 
-    // copy memory from heap1 to new_array
-    memcpy(new_array->data, (*heap1)->data, d_array_length(*heap1) * sizeof(void *));
-    new_array->length = d_array_length(*heap1); // set length
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// merge 2 heaps. doesn't preserve original heaps
+Heap *heap_merge(Heap **heap1, Heap *restrict *restrict heap2)
+{
+    check(heap1 != NULL && *heap1 != NULL && heap2 != NULL && *heap2 != NULL, "heap1 or heap2 is NULL.");
+    check(heap_arity(*heap1) == heap_arity(*heap2), "heap1 arity and heap2 arity don't match.");
+
+    cerb_size_t from = d_array_length(*heap1); // heap1 stays heap, heap2 is built into it
 
-    // copy memory from heap2 to new_array
-    memcpy(new_array->data + d_array_length(new_array), (*heap2)->data, d_array_length(*heap2) * sizeof(void *));
-    new_array->length += d_array_length(*heap2); // set length
+    // join them as regular arrays (all safety checks are in d_array_join. see function for details)
+    d_array *joined = d_array_join(heap1, heap2);
+    check(joined != NULL, "Failed to join heaps.");
 
-    Heap *new_heap = heapify(&new_array); // heapify is needed
+    heap_build(joined, from);
 
-    return new_heap;
+    return joined;
 
 error:
     return NULL;
-}
\ No newline at end of file
+}
+
+// insert count data at once: they are appended and only nodes above them are sunk
+int heap_insert_batch(Heap *heap, void *const *data, cerb_size_t count)
+{
+    check(heap != NULL, "heap is NULL.");
+    check(count == 0 || data != NULL, "data is NULL.");
+
+    if (count == 0) return CERB_OK;
+
+    cerb_size_t from = d_array_length(heap);
+    int rc = d_array_push_back_n(heap, data, count);
+    check(rc != CERB_ERR, "Failed to add new values to heap.");
+
+    heap_build(heap, from);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// pop count elements with highest priority (fewer if heap holds fewer) and push them at the back of out
+int heap_pop_n(Heap *heap, cerb_size_t count, d_array *out)
+{
+    check(heap != NULL, "heap is NULL.");
+    check(out != NULL, "out is NULL.");
+    check(heap != out, "out is heap itself.");
+
+    if (count > d_array_length(heap)) count = d_array_length(heap);
+    if (count == 0) return CERB_OK;
+
+    // out grows once, pushes below never fail
+    int rc = d_array_reserve(out, d_array_length(out) + count);
+    check(rc != CERB_ERR, "Failed to make room in out.");
+
+    cerb_size_t i;
+    for (i = 0; i < count; i++) {
+        d_array_push_back(out, heap->data[0]);
+        void *new_root = d_array_pop_back(heap); // same as in heap_pop
+        if (d_array_length(heap)) {
+            heap->data[0] = new_root;
+            sink(heap, 0);
+        }
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
@@ -7,6 +7,9 @@
 #define HEAP_LESS -1
 #define HEAP_EQUAL 0
 
+#define HEAP_DEFAULT_ARITY 2 // binary heap
+#define HEAP_MAX_ARITY 16 // 8 children are 64 bytes of pointers, more than 16 only adds compares
+
 // get the index of last element of array
 #define heap_index_of_last(heap) d_array_index_of_last(heap)
 // get a left child's parent node index ( 2 * i + 1 = self_index )
@@ -20,17 +23,33 @@
 // get a left or right child's parent index ( index % 2 == 0 ? |it is right child| : |it is left child| )
 #define parent(index) ((index) % 2 == 0 ? heap_index_of_parent_of_right(index) : heap_index_of_parent_of_left(index))
 
+// get number of children every node of heap has
+#define heap_arity(heap) ((heap)->heap_arity ? (heap)->heap_arity : HEAP_DEFAULT_ARITY)
+
 // Heap is the same as d_array, only functions handle it differently
 // be careful not to call d_array functions on heap, as some of them might alter heap invariant
-// heap must have a valid compare function (see default compare for d_array)
+// heap must have a valid compare function (see default compare for d_array) and must be in D_ARRAY_LINEAR mode
 #define Heap d_array
 
 // create is the same as d_array_create (see d_array_create for details)
-static inline Heap *heap_create(d_array_cmp compare, uint32_t initial_capacity)
+static inline Heap *heap_create(d_array_cmp compare, cerb_size_t initial_capacity)
 {
     return d_array_create(compare, initial_capacity);
 }
 
+// create heap which allocates its memory with allocator (see d_array_create_with_allocator)
+static inline Heap *heap_create_with_allocator(d_array_cmp compare, cerb_size_t initial_capacity,
+const cerb_allocator *allocator)
+{
+    return d_array_create_with_allocator(compare, initial_capacity, allocator);
+}
+
+// make heap d-ary, every node gets arity children (2 - HEAP_MAX_ARITY), elements heap holds are rearranged.
+// children of a node sit next to each other, so 4 or 8 of them are read from one or two cache lines and heap
+// is half or third as deep as binary one: pops of big heaps (millions of elements) touch far fewer cache lines
+// for few more compares. the macros above are for binary heaps only
+int heap_set_arity(Heap *heap, uint8_t arity);
+
 // deallocate the whole heap
 static inline int heap_destroy(Heap **heap, d_array_dealloc dealloc_cb)
 {
@@ -78,6 +97,7 @@ int heap_insert(Heap *heap, void *data);
 int heap_replace(Heap *restrict heap, void *restrict new_data, d_array_dealloc dealloc_cb);
 
 // heapify array, return new heap and set old array reference to NULL (this needs an address of array)
+// bottom-up (Floyd's) build, O(n)
 Heap *heapify(d_array *restrict *restrict array);
 // meld 2 heaps. preserves original heaps by memcopying (this doesn't create copies of actual data, just copies pointers)
 // (if you deallocate data held by either of these 3 heaps the remaining heaps won't hold valid data)
@@ -85,13 +105,13 @@ Heap *heap_meld(Heap *restrict *restrict heap1, Heap *restrict *restrict heap2);
 
 // merge 2 heaps. doesn't preserve original heaps
 // (deallocation is only needed on returned heap not the original two)
-static inline Heap *heap_merge(Heap **heap1, Heap *restrict *restrict heap2)
-{
-    // join them as regular arrays (all safety checks are in d_array_join. see function for details)
-    d_array *joined = d_array_join(heap1, heap2);
-    // if join was successful heapify the result of it. else return NULL
-    if (joined) return heapify(&joined);
-    else return NULL;
-}
+Heap *heap_merge(Heap **heap1, Heap *restrict *restrict heap2);
+
+// insert count data at once (none of them can be NULL). they are appended and only nodes above them are sunk,
+// bottom level first, which is O(count + log n) instead of O(count * log n) of count heap_insert calls
+int heap_insert_batch(Heap *heap, void *const *data, cerb_size_t count);
+// pop count elements with highest priority (all of them if heap holds fewer) and push them at the back of out in
+// the order heap_pop would return them. out grows once, so popping top k of big heap costs k sinks only
+int heap_pop_n(Heap *heap, cerb_size_t count, d_array *out);
 
 #endif /* CFB2ECC9_5B49_46D7_B2E6_3D43B3A19FFF */
\ No newline at end of file
@@ -0,0 +1,301 @@
+#include <stdlib.h>
+#include <string.h>
+#include "indexed_heap.h"
+
+#define INDEXED_HEAP_MIN_CAPACITY 8
+
+// bytes of block which holds entries, positions and free_handles of capacity elements
+#define indexed_heap_block_size(capacity)\
+        ((size_t) (capacity) * (sizeof(Indexed_heap_entry) + 2 * sizeof(cerb_size_t)))
+
+// default compare type is integer
+static int default_compare(const void *const restrict data1, const void *const restrict data2)
+{
+    if ( *( (int *) data1 ) < *( (int *) data2 ) ) {
+        return HEAP_LESS;
+    } else if ( *( (int *) data1 ) > *( (int *) data2 ) ) {
+        return HEAP_GREATER;
+    } else {
+        return HEAP_EQUAL;
+    }
+}
+
+// create heap
+Indexed_heap *indexed_heap_create(d_array_cmp compare, cerb_size_t initial_capacity)
+{
+    return indexed_heap_create_with_allocator(compare, initial_capacity, NULL);
+}
+
+// create heap whose struct and arrays come from allocator
+Indexed_heap *indexed_heap_create_with_allocator(d_array_cmp compare, cerb_size_t initial_capacity,
+                                                 const cerb_allocator *allocator)
+{
+    allocator = cerb_allocator_or_default(allocator);
+    if (initial_capacity < INDEXED_HEAP_MIN_CAPACITY) initial_capacity = INDEXED_HEAP_MIN_CAPACITY;
+
+    Indexed_heap *heap = cerb_calloc(allocator, sizeof(Indexed_heap));
+    check_mem(heap);
+
+    heap->allocator = allocator;
+    heap->compare = compare ? compare : default_compare;
+    heap->capacity = initial_capacity;
+
+    // entries, positions and free_handles share one block, in this order
+    heap->entries = cerb_alloc(allocator, indexed_heap_block_size(initial_capacity));
+    check_mem(heap->entries);
+    heap->positions = (cerb_size_t *) (heap->entries + initial_capacity);
+    heap->free_handles = heap->positions + initial_capacity;
+
+    return heap;
+
+error:
+    cerb_free(allocator, heap, sizeof(Indexed_heap));
+    return NULL;
+}
+
+// internally used to double capacity of heap (handles never outnumber capacity, so their arrays grow with it)
+static int indexed_heap_grow(Indexed_heap *heap)
+{
+    check(CERB_SIZE_FITS((uint64_t) heap->capacity * 2), "Can't expand past max available size, AKA CERB_SIZE_MAX.");
+
+    cerb_size_t capacity = heap->capacity * 2;
+    Indexed_heap_entry *entries = cerb_alloc(heap->allocator, indexed_heap_block_size(capacity));
+    check_mem(entries);
+
+    cerb_size_t *positions = (cerb_size_t *) (entries + capacity), *free_handles = positions + capacity;
+    memcpy(entries, heap->entries, sizeof(Indexed_heap_entry) * heap->length);
+    memcpy(positions, heap->positions, sizeof(cerb_size_t) * heap->handles);
+    memcpy(free_handles, heap->free_handles, sizeof(cerb_size_t) * heap->free_length);
+
+    cerb_free(heap->allocator, heap->entries, indexed_heap_block_size(heap->capacity));
+    heap->entries = entries;
+    heap->positions = positions;
+    heap->free_handles = free_handles;
+    heap->capacity = capacity;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// internally used to put entry at position and record its position
+static inline void indexed_heap_place(Indexed_heap *heap, cerb_size_t position, Indexed_heap_entry entry)
+{
+    heap->entries[position] = entry;
+    heap->positions[entry.handle] = position;
+}
+
+// emerge entry at position towards root until needed
+static void emerge(Indexed_heap *heap, cerb_size_t position)
+{
+    Indexed_heap_entry entry = heap->entries[position]; // entry is placed once, parents move down into the hole
+
+    while (position != 0) {
+        cerb_size_t parent_index = (position - 1) / 2;
+        if (heap->compare(entry.data, heap->entries[parent_index].data) != HEAP_GREATER) break;
+
+        indexed_heap_place(heap, position, heap->entries[parent_index]);
+        position = parent_index;
+    }
+    indexed_heap_place(heap, position, entry);
+}
+
+// sink entry at position towards bottom until needed
+static void sink(Indexed_heap *heap, cerb_size_t position)
+{
+    Indexed_heap_entry entry = heap->entries[position]; // entry is placed once, children move up into the hole
+
+    while (1) {
+        // make this uint64_t to prevent overflow (position miscalculation)
+        uint64_t max_index = 2 * (uint64_t) position + 1;
+        if (max_index >= heap->length) break;
+
+        // pick maximum out of children
+        if (max_index + 1 < heap->length &&
+        heap->compare(heap->entries[max_index].data, heap->entries[max_index + 1].data) == HEAP_LESS) {
+            max_index++;
+        }
+        if (heap->compare(entry.data, heap->entries[max_index].data) != HEAP_LESS) break;
+
+        indexed_heap_place(heap, position, heap->entries[max_index]);
+        position = max_index;
+    }
+    indexed_heap_place(heap, position, entry);
+}
+
+// internally used to take entry at position out of heap (last entry fills its place and moves where it belongs)
+static void *indexed_heap_take(Indexed_heap *heap, cerb_size_t position)
+{
+    Indexed_heap_entry taken = heap->entries[position];
+
+    heap->positions[taken.handle] = INDEXED_HEAP_NONE;
+    heap->free_handles[heap->free_length++] = taken.handle; // handle is given to next inserted element
+
+    heap->length--;
+    if (position != heap->length) {
+        indexed_heap_place(heap, position, heap->entries[heap->length]);
+        // last entry can belong both above and below position when it wasn't popped from root
+        if (position != 0 && heap->compare(heap->entries[position].data,
+                                           heap->entries[(position - 1) / 2].data) == HEAP_GREATER) {
+            emerge(heap, position);
+        } else {
+            sink(heap, position);
+        }
+    }
+
+    return taken.data;
+}
+
+// insert data, its handle is put in handle
+int indexed_heap_insert(Indexed_heap *heap, void *data, cerb_size_t *handle)
+{
+    check(heap != NULL, "heap is NULL.");
+    check(data != NULL, "data is NULL.");
+
+    if (heap->length == heap->capacity) {
+        int rc = indexed_heap_grow(heap);
+        check(rc != CERB_ERR, "Failed to add new value to heap.");
+    }
+
+    // reuse handle of removed element if there is one
+    Indexed_heap_entry entry = {data, heap->free_length ? heap->free_handles[--heap->free_length] : heap->handles++};
+
+    indexed_heap_place(heap, heap->length, entry);
+    heap->length++;
+    emerge(heap, heap->length - 1);
+
+    if (handle) *handle = entry.handle;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// element with highest priority
+void *indexed_heap_top(Indexed_heap *heap, cerb_size_t *handle)
+{
+    check(heap != NULL, "heap is NULL.");
+
+    if (heap->length == 0) return NULL;
+    if (handle) *handle = heap->entries[0].handle;
+
+    return heap->entries[0].data;
+
+error:
+    return NULL;
+}
+
+// pop element with highest priority
+void *indexed_heap_pop(Indexed_heap *heap, cerb_size_t *handle)
+{
+    check(heap != NULL, "heap is NULL.");
+
+    if (heap->length == 0) return NULL;
+    if (handle) *handle = heap->entries[0].handle;
+
+    return indexed_heap_take(heap, 0);
+
+error:
+    return NULL;
+}
+
+// 1 if handle is in heap, 0 if it isn't
+int indexed_heap_contains(Indexed_heap *heap, cerb_size_t handle)
+{
+    check(heap != NULL, "heap is NULL.");
+
+    return handle < heap->handles && heap->positions[handle] != INDEXED_HEAP_NONE;
+
+error:
+    return CERB_ERR;
+}
+
+// element of handle
+void *indexed_heap_get(Indexed_heap *heap, cerb_size_t handle)
+{
+    check(heap != NULL, "heap is NULL.");
+
+    if (handle >= heap->handles || heap->positions[handle] == INDEXED_HEAP_NONE) return NULL;
+
+    return heap->entries[heap->positions[handle]].data;
+
+error:
+    return NULL;
+}
+
+// replace element of handle with data and move it wherever its priority takes it
+int indexed_heap_update_priority(Indexed_heap *heap, cerb_size_t handle, void *data)
+{
+    check(heap != NULL, "heap is NULL.");
+    check(data != NULL, "data is NULL.");
+    check(handle < heap->handles && heap->positions[handle] != INDEXED_HEAP_NONE, "handle isn't in heap.");
+
+    cerb_size_t position = heap->positions[handle];
+    heap->entries[position].data = data;
+
+    // element goes up if it is greater than its parent, otherwise it may have to go down
+    if (position != 0 && heap->compare(data, heap->entries[(position - 1) / 2].data) == HEAP_GREATER) {
+        emerge(heap, position);
+    } else {
+        sink(heap, position);
+    }
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// replace element of handle with data which has at least its priority, element only moves up
+int indexed_heap_decrease_key(Indexed_heap *heap, cerb_size_t handle, void *data)
+{
+    check(heap != NULL, "heap is NULL.");
+    check(data != NULL, "data is NULL.");
+    check(handle < heap->handles && heap->positions[handle] != INDEXED_HEAP_NONE, "handle isn't in heap.");
+
+    cerb_size_t position = heap->positions[handle];
+    heap->entries[position].data = data;
+    emerge(heap, position);
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
+
+// remove element of handle and return it
+void *indexed_heap_remove(Indexed_heap *heap, cerb_size_t handle)
+{
+    check(heap != NULL, "heap is NULL.");
+
+    if (handle >= heap->handles || heap->positions[handle] == INDEXED_HEAP_NONE) return NULL;
+
+    return indexed_heap_take(heap, heap->positions[handle]);
+
+error:
+    return NULL;
+}
+
+// deallocate heap and set it to NULL on stack
+int indexed_heap_destroy(Indexed_heap **heap, d_array_dealloc dealloc_cb)
+{
+    check(heap != NULL, "Address of heap is NULL.");
+    check(*heap != NULL, "heap is NULL.");
+
+    cerb_size_t i;
+    if (dealloc_cb) {
+        for (i = 0; i < (*heap)->length; i++) dealloc_cb((*heap)->entries[i].data);
+    }
+
+    cerb_free((*heap)->allocator, (*heap)->entries, indexed_heap_block_size((*heap)->capacity));
+    cerb_free((*heap)->allocator, *heap, sizeof(Indexed_heap));
+
+    *heap = NULL;
+
+    return CERB_OK;
+
+error:
+    return CERB_ERR;
+}
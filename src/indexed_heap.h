@@ -0,0 +1,64 @@
+#ifndef F2A94C17_6E3B_4D08_9C5A_1B7E0D83F6A2
+#define F2A94C17_6E3B_4D08_9C5A_1B7E0D83F6A2
+
+#include <stdint.h>
+#include "heap.h"
+
+// addressable heap: insert gives every element a handle and heap keeps position of every handle, so element
+// can be found, changed or removed in O(log n) without scanning heap (decrease-key of Dijkstra's algorithm,
+// cancelling scheduled jobs). priority is decided by compare as in Heap (HEAP_GREATER comes out first).
+// handles are small numbers (0, 1, 2 ...), handle of popped or removed element is given to next inserted one
+
+#define INDEXED_HEAP_NONE CERB_SIZE_MAX // position of handle which isn't in heap
+
+// get number of elements in heap
+#define indexed_heap_length(heap_ptr) ((heap_ptr)->length)
+
+typedef struct Indexed_heap_entry {
+    void *data; // element
+    cerb_size_t handle; // handle of element
+} Indexed_heap_entry;
+
+typedef struct Indexed_heap {
+    Indexed_heap_entry *entries; // heap itself, [0] has highest priority (block positions and free_handles are in)
+    cerb_size_t *positions; // position of every handle in entries (INDEXED_HEAP_NONE if handle isn't used)
+    cerb_size_t *free_handles; // handles of popped and removed elements, waiting to be reused
+    d_array_cmp compare; // compare callback (see heap.h)
+    const cerb_allocator *allocator; // allocator of arrays and struct itself
+    cerb_size_t length; // number of elements
+    cerb_size_t capacity; // number of entries allocated
+    cerb_size_t handles; // number of handles ever given out (never more than capacity)
+    cerb_size_t free_length; // number of free_handles
+} Indexed_heap;
+
+// create heap, compare orders elements (if NULL, default one compares ints)
+Indexed_heap *indexed_heap_create(d_array_cmp compare, cerb_size_t initial_capacity);
+// same as indexed_heap_create, but memory comes from allocator (NULL means cerb_libc_allocator)
+Indexed_heap *indexed_heap_create_with_allocator(d_array_cmp compare, cerb_size_t initial_capacity,
+                                                 const cerb_allocator *allocator);
+
+// insert data, its handle is put in handle (can be NULL)
+int indexed_heap_insert(Indexed_heap *heap, void *data, cerb_size_t *handle);
+// element with highest priority (NULL if heap is empty), its handle is put in handle (can be NULL)
+void *indexed_heap_top(Indexed_heap *heap, cerb_size_t *handle);
+// pop element with highest priority (NULL if heap is empty), its handle is put in handle (can be NULL)
+void *indexed_heap_pop(Indexed_heap *heap, cerb_size_t *handle);
+
+// 1 if handle is in heap, 0 if it isn't (CERB_ERR if heap is NULL)
+int indexed_heap_contains(Indexed_heap *heap, cerb_size_t handle);
+// element of handle (NULL if handle isn't in heap)
+void *indexed_heap_get(Indexed_heap *heap, cerb_size_t handle);
+
+// replace element of handle with data and move it wherever its priority takes it (pass element itself if you
+// changed its priority in place)
+int indexed_heap_update_priority(Indexed_heap *heap, cerb_size_t handle, void *data);
+// same as indexed_heap_update_priority, for data whose priority isn't lower than priority of element it replaces
+// (shorter distance in Dijkstra's algorithm, where compare says that smaller distance is greater), it only moves up
+int indexed_heap_decrease_key(Indexed_heap *heap, cerb_size_t handle, void *data);
+// remove element of handle and return it (NULL if handle isn't in heap)
+void *indexed_heap_remove(Indexed_heap *heap, cerb_size_t handle);
+
+// deallocate heap and set it to NULL on stack, dealloc_cb gets every element (NULL leaves elements alone)
+int indexed_heap_destroy(Indexed_heap **heap, d_array_dealloc dealloc_cb);
+
+#endif /* F2A94C17_6E3B_4D08_9C5A_1B7E0D83F6A2 */
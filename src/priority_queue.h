@@ -10,13 +10,43 @@
 // priority queue is wrapped in Heap
 #define priority_queue Heap
 
+// everything priority queue can be set up with, zeroed fields mean defaults
+typedef struct priority_queue_config {
+    d_array_cmp compare; // compare callback (NULL means ints)
+    cerb_size_t initial_capacity; // elements queue holds before it grows
+    const cerb_allocator *allocator; // NULL means cerb_libc_allocator
+    uint8_t arity; // children per node of heap (0 means binary, 4 or 8 pay off for queues of millions, see heap_set_arity)
+} priority_queue_config;
 
 // create priority queue
-static inline priority_queue *priority_queue_create(d_array_cmp compare, uint32_t initial_capacity)
+static inline priority_queue *priority_queue_create(d_array_cmp compare, cerb_size_t initial_capacity)
 {
     return heap_create(compare, initial_capacity);
 }
 
+// create priority queue which allocates its memory with allocator (see d_array_create_with_allocator)
+static inline priority_queue *priority_queue_create_with_allocator(d_array_cmp compare, cerb_size_t initial_capacity,
+const cerb_allocator *allocator)
+{
+    return heap_create_with_allocator(compare, initial_capacity, allocator);
+}
+
+// create priority queue as described by config (see priority_queue_config)
+static inline priority_queue *priority_queue_create_with_config(const priority_queue_config *config)
+{
+    check(config != NULL, "config is NULL.");
+    check(config->arity == 0 || (config->arity >= 2 && config->arity <= HEAP_MAX_ARITY), "Invalid arity.");
+
+    priority_queue *queue = heap_create_with_allocator(config->compare, config->initial_capacity, config->allocator);
+    check(queue != NULL, "Failed to create priority queue.");
+    queue->heap_arity = config->arity; // queue is empty, nothing to rearrange
+
+    return queue;
+
+error:
+    return NULL;
+}
+
 // insert in priority queue
 static inline int priority_queue_insert(priority_queue *queue, void *data)
 {
@@ -16,6 +16,12 @@ static inline Queue *Queue_create(doubly_linked_cmp cmp)
     return doubly_linked_create(cmp);
 }
 
+// create a queue which allocates its memory with allocator (NULL means cerb_libc_allocator)
+static inline Queue *Queue_create_with_allocator(doubly_linked_cmp cmp, const cerb_allocator *allocator)
+{
+    return doubly_linked_create_with_allocator(cmp, allocator);
+}
+
 // unshift void *data in queue
 // #define Queue_unshift(queue, data) doubly_linked_unshift(queue, data)
 
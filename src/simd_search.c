@@ -0,0 +1,158 @@
+#include <stddef.h>
+#include "simd_search.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CERB_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// element slot points to (through node if indirect is set)
+#define SLOT_ELEMENT(slots, i, indirect) ((indirect) ? *(void *const *) (slots)[i] : (slots)[i])
+
+static int simd_level = -1; // kernel level in use, detected on first call
+
+static int64_t find_pointer_scalar(void *const *slots, cerb_size_t from, cerb_size_t length, const void *needle, int indirect)
+{
+    cerb_size_t i;
+    for (i = from; i < length; i++) {
+        if (SLOT_ELEMENT(slots, i, indirect) == needle) return i;
+    }
+    return -1;
+}
+
+static int64_t find_int_scalar(void *const *slots, cerb_size_t from, cerb_size_t length, int key, int indirect)
+{
+    cerb_size_t i;
+    for (i = from; i < length; i++) {
+        if (*(const int *) SLOT_ELEMENT(slots, i, indirect) == key) return i;
+    }
+    return -1;
+}
+
+#ifdef CERB_SIMD_X86
+
+// SSE2 has no 64-bit compare, so 32-bit halves are compared and both of them have to match
+static inline int sse2_match_pointers(__m128i pointers, __m128i needles)
+{
+    __m128i halves = _mm_cmpeq_epi32(pointers, needles);
+    halves = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_movemask_pd(_mm_castsi128_pd(halves));
+}
+
+// 4 pointers per iteration (SSE2 is always there on x86-64). elements behind pointers need gathers, which SSE2
+// doesn't have, so indirect and int searches stay scalar on this level
+static int64_t find_pointer_sse2(void *const *slots, cerb_size_t length, const void *needle)
+{
+    __m128i needles = _mm_set1_epi64x((long long) (intptr_t) needle);
+    cerb_size_t i = 0;
+
+    for (; i + 4 <= length; i += 4) {
+        int mask = sse2_match_pointers(_mm_loadu_si128((const __m128i *) (slots + i)), needles);
+        mask |= sse2_match_pointers(_mm_loadu_si128((const __m128i *) (slots + i + 2)), needles) << 2;
+        if (mask) return i + __builtin_ctz(mask);
+    }
+
+    return find_pointer_scalar(slots, i, length, needle, 0);
+}
+
+// load 4 pointers from slots, or first members of 4 nodes slots point to (gathered with node addresses as indices)
+__attribute__((target("avx2")))
+static inline __m256i avx2_load_elements(void *const *slots, int indirect)
+{
+    __m256i pointers = _mm256_loadu_si256((const __m256i *) slots);
+    return indirect ? _mm256_i64gather_epi64((const long long *) 0, pointers, 1) : pointers;
+}
+
+// 8 pointers per iteration
+__attribute__((target("avx2")))
+static int64_t find_pointer_avx2(void *const *slots, cerb_size_t length, const void *needle, int indirect)
+{
+    __m256i needles = _mm256_set1_epi64x((long long) (intptr_t) needle);
+    cerb_size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        __m256i low = _mm256_cmpeq_epi64(avx2_load_elements(slots + i, indirect), needles);
+        __m256i high = _mm256_cmpeq_epi64(avx2_load_elements(slots + i + 4, indirect), needles);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(low)) | _mm256_movemask_pd(_mm256_castsi256_pd(high)) << 4;
+        if (mask) return i + __builtin_ctz(mask);
+    }
+
+    return find_pointer_scalar(slots, i, length, needle, indirect);
+}
+
+// 8 ints per iteration, gathered through pointers
+__attribute__((target("avx2")))
+static int64_t find_int_avx2(void *const *slots, cerb_size_t length, int key, int indirect)
+{
+    __m128i keys = _mm_set1_epi32(key);
+    cerb_size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        __m128i low = _mm256_i64gather_epi32((const int *) 0, avx2_load_elements(slots + i, indirect), 1);
+        __m128i high = _mm256_i64gather_epi32((const int *) 0, avx2_load_elements(slots + i + 4, indirect), 1);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(low, keys)))
+                 | _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(high, keys))) << 4;
+        if (mask) return i + __builtin_ctz(mask);
+    }
+
+    return find_int_scalar(slots, i, length, key, indirect);
+}
+
+#endif
+
+// best level CPU supports
+static int simd_detect()
+{
+#ifdef CERB_SIMD_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? CERB_SIMD_AVX2 : CERB_SIMD_SSE2;
+#else
+    return CERB_SIMD_SCALAR;
+#endif
+}
+
+// kernel level in use
+int cerb_simd_level()
+{
+    int level = __atomic_load_n(&simd_level, __ATOMIC_RELAXED);
+
+    if (level < 0) {
+        level = simd_detect(); // every thread detects the same, so racing here is harmless
+        __atomic_store_n(&simd_level, level, __ATOMIC_RELAXED);
+    }
+
+    return level;
+}
+
+// use lower kernel level, capped at what CPU supports
+int cerb_simd_set_level(int level)
+{
+    int supported = simd_detect();
+
+    if (level < CERB_SIMD_SCALAR) level = CERB_SIMD_SCALAR;
+    if (level > supported) level = supported;
+    __atomic_store_n(&simd_level, level, __ATOMIC_RELAXED);
+
+    return level;
+}
+
+// index of first slot which holds needle itself
+int64_t cerb_simd_find_pointer(void *const *slots, cerb_size_t length, const void *needle, int indirect)
+{
+#ifdef CERB_SIMD_X86
+    switch (cerb_simd_level()) {
+        case CERB_SIMD_AVX2: return find_pointer_avx2(slots, length, needle, indirect);
+        case CERB_SIMD_SSE2: if (!indirect) return find_pointer_sse2(slots, length, needle); break;
+    }
+#endif
+    return find_pointer_scalar(slots, 0, length, needle, indirect);
+}
+
+// index of first slot which points to int equal to key
+int64_t cerb_simd_find_int(void *const *slots, cerb_size_t length, int key, int indirect)
+{
+#ifdef CERB_SIMD_X86
+    if (cerb_simd_level() == CERB_SIMD_AVX2) return find_int_avx2(slots, length, key, indirect);
+#endif
+    return find_int_scalar(slots, 0, length, key, indirect);
+}
@@ -0,0 +1,26 @@
+#ifndef E6C1A4F9_2B8D_4F37_A5E2_9D0B3C7F8E16
+#define E6C1A4F9_2B8D_4F37_A5E2_9D0B3C7F8E16
+
+#include <stdint.h>
+#include "cerb_size.h"
+
+// linear search kernels over blocks of pointers (d_array data, Hashmap buckets) which don't call compare callback.
+// there are AVX2 and SSE2 versions and a scalar fallback, the best one CPU supports is picked at runtime.
+// slots are searched in order and index of first match is returned, -1 if there is none.
+// with indirect set slots point to structs whose first member is pointer to element (as Hashmap_node does)
+
+#define CERB_SIMD_SCALAR 0
+#define CERB_SIMD_SSE2 1
+#define CERB_SIMD_AVX2 2
+
+// index of first slot which holds needle itself (pointer identity)
+int64_t cerb_simd_find_pointer(void *const *slots, cerb_size_t length, const void *needle, int indirect);
+// index of first slot which points to int equal to key (elements have to be ints or start with one)
+int64_t cerb_simd_find_int(void *const *slots, cerb_size_t length, int key, int indirect);
+
+// kernel level in use (CERB_SIMD_*)
+int cerb_simd_level();
+// use lower kernel level (for benchmarks and tests), level is capped at what CPU supports. returns level set
+int cerb_simd_set_level(int level);
+
+#endif /* E6C1A4F9_2B8D_4F37_A5E2_9D0B3C7F8E16 */
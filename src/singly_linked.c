@@ -16,9 +16,17 @@ static inline int default_compare(const void *const restrict data1, const void *
 
 singly_linked *singly_linked_create(singly_linked_cmp cmp)
 {
-    singly_linked *list = calloc(1, sizeof(singly_linked));
+    return singly_linked_create_with_allocator(cmp, NULL);
+}
+
+singly_linked *singly_linked_create_with_allocator(singly_linked_cmp cmp, const cerb_allocator *allocator)
+{
+    allocator = cerb_allocator_or_default(allocator);
+
+    singly_linked *list = cerb_calloc(allocator, sizeof(singly_linked));
     check_mem(list);
 
+    list->allocator = allocator;
     list->compare = cmp == NULL ? default_compare : cmp;
     list->count = 0;
 
@@ -28,9 +36,9 @@ error:
     return NULL;
 }
 
-static inline singly_linked_node *singly_linked_node_create()
+static inline singly_linked_node *singly_linked_node_create(singly_linked *list)
 {
-    singly_linked_node *node = calloc(1, sizeof(singly_linked_node));
+    singly_linked_node *node = cerb_calloc(list->allocator, sizeof(singly_linked_node));
     check_mem(node);
 
     return node;
@@ -46,9 +54,9 @@ int singly_linked_push(singly_linked *restrict list, void *restrict data)
 {
     check(list != NULL, "list is NULL.");
     check(data != NULL, "data is NULL.");
-    check(list->count <= UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(list->count < CERB_SIZE_MAX, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
 
-    singly_linked_node *new_node = singly_linked_node_create();
+    singly_linked_node *new_node = singly_linked_node_create(list);
     check(new_node != NULL, "Failed to create new node.");
 
     new_node->data = data;
@@ -76,9 +84,9 @@ int singly_linked_unshift(singly_linked *restrict list, void *restrict data)
 {
     check(list != NULL, "list is NULL.");
     check(data != NULL, "data is NULL.");
-    check(list->count <= UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(list->count < CERB_SIZE_MAX, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
 
-    singly_linked_node *new_node = singly_linked_node_create();
+    singly_linked_node *new_node = singly_linked_node_create(list);
     check(new_node != NULL, "Failed to create new node.");
 
     new_node->data = data;
@@ -109,12 +117,12 @@ int singly_linked_insert_after(singly_linked *restrict list, void *restrict entr
     check(list != NULL, "list is NULL.");
     check(entry != NULL, "after is NULL.");
     check(data != NULL, "data is NULL.");
-    check(list->count <= UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(list->count < CERB_SIZE_MAX, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
 
     singly_linked_node *node; // initialized in below if
 
     if ((node = in_list(list, entry)) != NULL) {
-        singly_linked_node *new_node = singly_linked_node_create();
+        singly_linked_node *new_node = singly_linked_node_create(list);
         check(new_node != NULL, "Failed to create new node.");
 
         new_node->data = data;
@@ -136,7 +144,7 @@ int singly_linked_insert_before(singly_linked *restrict list, void *restrict ent
     check(list != NULL, "list is NULL.");
     check(entry != NULL, "entry is NULL.");
     check(data != NULL, "data is NULL.");
-    check(list->count <= UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(list->count < CERB_SIZE_MAX, "Can't expand past max available size, AKA CERB_SIZE_MAX.");
 
     // checking for first and last
     if (list->first && list->compare(list->first->data, entry) == SINGLY_LINKED_EQUAL) {
@@ -150,7 +158,7 @@ int singly_linked_insert_before(singly_linked *restrict list, void *restrict ent
     singly_linked_iter (list, cur) { // these checks everything but the first and last nodes
         if (!cur->next) break; // to prevent NULL dereference at last node
         if (list->compare(cur->next->data, entry) == SINGLY_LINKED_EQUAL) {
-            singly_linked_node *new_node = singly_linked_node_create();
+            singly_linked_node *new_node = singly_linked_node_create(list);
             check(new_node != NULL, "Failed to create new node.");
 
             new_node->data = data;
@@ -180,14 +188,14 @@ void *singly_linked_pop(singly_linked *restrict list)
     if (list->count == 1) {
         // means we are removing the one and only element 
         data = list->first->data;
-        free(list->first);
+        cerb_free(list->allocator, list->first, sizeof(singly_linked_node));
         list->first = NULL;
         list->count = 0; // or --; as list gets empty
     } else {
         singly_linked_iter (list, cur) {
             if (!cur->next->next) { // delete after cur
                 data = cur->next->data;
-                free(cur->next);
+                cerb_free(list->allocator, cur->next, sizeof(singly_linked_node));
                 cur->next = NULL;
                 list->count--;
             }
@@ -209,7 +217,7 @@ void *singly_linked_shift(singly_linked *restrict list)
         data = list->first->data;
         singly_linked_node *first_node = list->first; // not to loose or insta free the pointer
         list->first = list->first->next;
-        free(first_node);
+        cerb_free(list->allocator, first_node, sizeof(singly_linked_node));
         list->count--;
         return data;
     }
@@ -239,7 +247,7 @@ void *singly_linked_remove(singly_linked *restrict list, void *restrict entry)
             data = cur->next->data;
             singly_linked_node *remove_node = cur->next;
             cur->next = cur->next->next;
-            free(remove_node);
+            cerb_free(list->allocator, remove_node, sizeof(singly_linked_node));
             list->count--;
             return data;
         }
@@ -266,7 +274,7 @@ void *singly_linked_remove_after(singly_linked *restrict list, void *restrict en
         data = node->next->data;
         singly_linked_node *after_next = node->next; // not to loose or insta free the pointer
         node->next = node->next->next;
-        free(after_next);
+        cerb_free(list->allocator, after_next, sizeof(singly_linked_node));
         list->count--;
         return data;
     }
@@ -298,7 +306,7 @@ void *singly_linked_remove_before(singly_linked *restrict list, void *restrict e
                 data = cur->next->data;
                 singly_linked_node *cur_next = cur->next;  // not to loose or insta free the pointer
                 cur->next = cur->next->next;
-                free(cur_next);
+                cerb_free(list->allocator, cur_next, sizeof(singly_linked_node));
                 list->count--;
                 return data;
             }
@@ -322,8 +330,10 @@ int singly_linked_join(singly_linked *restrict *restrict list1, singly_linked *r
     check(*list2 != NULL, "list2 is NULL.");
     check((*list1)->count != 0, "Doesn't make sense to join to an empty list.");
     check((*list2)->count != 0, "Doesn't make sense to join an empty list.");    
-    check((*list1)->count + (*list2)->count <= UINT32_MAX, "Can't expand past max available size, AKA UINT32_MAX.");
+    check(CERB_SIZE_FITS((uint64_t) (*list1)->count + (*list2)->count),
+    "Can't expand past max available size, AKA CERB_SIZE_MAX.");
     check((*list1)->compare == (*list2)->compare, "Couldn't join lists of different compare callbacks");
+    check((*list1)->allocator == (*list2)->allocator, "Couldn't join lists of different allocators");
 
     singly_linked_iter (*list1, cur) {
         if (!cur->next) {
@@ -333,7 +343,7 @@ int singly_linked_join(singly_linked *restrict *restrict list1, singly_linked *r
         }
     }
 
-    free(*list2);
+    cerb_free((*list2)->allocator, *list2, sizeof(singly_linked));
     *list2 = NULL;
     
     return CERB_OK;
@@ -371,7 +381,7 @@ singly_linked_node *restrict to_node)
     }
 
     singly_linked *new_list = NULL;
-    uint32_t count = 0;
+    cerb_size_t count = 0;
 
     if (from_node == NULL) {
         singly_linked_iter (*list, cur) {
@@ -381,7 +391,7 @@ singly_linked_node *restrict to_node)
             if (cur == to_node) {
                 check(cur->next, "Doesn't make sense to split from first including last.");
 
-                new_list = singly_linked_create((*list)->compare);
+                new_list = singly_linked_create_with_allocator((*list)->compare, (*list)->allocator);
                 check(new_list != NULL, "Couldn't create new list.");
 
                 new_list->first = (*list)->first;
@@ -400,7 +410,7 @@ singly_linked_node *restrict to_node)
             count++;
 
             if (cur->next == from_node) {
-                new_list = singly_linked_create((*list)->compare);
+                new_list = singly_linked_create_with_allocator((*list)->compare, (*list)->allocator);
                 check(new_list != NULL, "Couldn't create new list.");
 
                 new_list->first = from_node;
@@ -421,7 +431,7 @@ singly_linked_node *restrict to_node)
         // if we are splitting not from the first to not to the last
         singly_linked_iter (*list, cur) {
             if (cur->next == from_node) {
-                new_list = singly_linked_create((*list)->compare);
+                new_list = singly_linked_create_with_allocator((*list)->compare, (*list)->allocator);
                 check(new_list != NULL, "Couldn't create new list.");
                 new_list->first = from_node;
                 cur->next = to_node->next; // move link to to node's next element
@@ -480,14 +490,14 @@ int singly_linked_destroy(singly_linked *restrict *restrict list, singly_linked_
     
     for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next) {
         dealloc_cb(cur_node->data);
-        free(cur_node);
+        cerb_free((*list)->allocator, cur_node, sizeof(singly_linked_node));
         cur_node = next_node;
     }
     dealloc_cb(cur_node->data);
-    free(cur_node); // free the last one and we are done
+    cerb_free((*list)->allocator, cur_node, sizeof(singly_linked_node)); // free the last one and we are done
 
 empty_list: // fall through
-    free(*list);
+    cerb_free((*list)->allocator, *list, sizeof(singly_linked));
     *list = NULL;
 
     return CERB_OK;
@@ -508,14 +518,14 @@ int singly_linked_clear_destroy(singly_linked **list) // pass by reference to ma
     
     for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next) {
         free(cur_node->data);
-        free(cur_node);
+        cerb_free((*list)->allocator, cur_node, sizeof(singly_linked_node));
         cur_node = next_node;
     }
     free(cur_node->data);
-    free(cur_node); // free the last one and we are done
+    cerb_free((*list)->allocator, cur_node, sizeof(singly_linked_node)); // free the last one and we are done
 
 empty_list: // fall through
-    free(*list);
+    cerb_free((*list)->allocator, *list, sizeof(singly_linked));
     *list = NULL;
 
     return CERB_OK;
@@ -536,14 +546,14 @@ int singly_linked_free_complex_data(singly_linked **list, singly_linked_dealloc
     
     for (next_node = cur_node->next; next_node != NULL; next_node = cur_node->next) {
         handler_func(cur_node->data);
-        free(cur_node);
+        cerb_free((*list)->allocator, cur_node, sizeof(singly_linked_node));
         cur_node = next_node;
     }
     handler_func(cur_node->data);
-    free(cur_node); // free the last one and we are done
+    cerb_free((*list)->allocator, cur_node, sizeof(singly_linked_node)); // free the last one and we are done
 
 empty_list: // fall through
-    free(*list);
+    cerb_free((*list)->allocator, *list, sizeof(singly_linked));
     *list = NULL;
 
     return CERB_OK;
@@ -558,10 +568,10 @@ int singly_linked_free_list(singly_linked **list)
     check(*list != NULL, "Somehow got list that is NULL.");
 
     singly_linked_iter (*list, cur) {
-        free(cur);
+        cerb_free((*list)->allocator, cur, sizeof(singly_linked_node));
     }
 
-    free(*list);
+    cerb_free((*list)->allocator, *list, sizeof(singly_linked));
 
     *list = NULL;
 
@@ -2,6 +2,8 @@
 #define D84C1D58_017D_4D7A_947A_C40713539E7F
 
 #include <stdint.h>
+#include "cerb_size.h"
+#include "allocator.h"
 #include "dbg.h"
 
 #define CERB_OK 0
@@ -24,11 +26,14 @@ typedef struct singly_linked_node {
 typedef struct singly_linked {
     singly_linked_node *first; // first node
     singly_linked_cmp compare; // compare callback
-    uint32_t count; // count of list (length)
+    const cerb_allocator *allocator; // allocator of struct and nodes (see allocator.h)
+    cerb_size_t count; // count of list (length)
 } singly_linked;
 
 // create singly_linked *list ( specify cmp if you need to sorted insert )
 singly_linked *singly_linked_create(singly_linked_cmp compare); //
+// create list which allocates struct and nodes with allocator (NULL means cerb_libc_allocator)
+singly_linked *singly_linked_create_with_allocator(singly_linked_cmp compare, const cerb_allocator *allocator);
 // push data in list
 int singly_linked_push(singly_linked *restrict list, void *restrict data); //
 // pop data from list and return
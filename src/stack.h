@@ -17,6 +17,12 @@ static inline Stack *Stack_create(doubly_linked_cmp cmp)
     return doubly_linked_create(cmp);
 }
 
+// create a stack which allocates its memory with allocator (NULL means cerb_libc_allocator)
+static inline Stack *Stack_create_with_allocator(doubly_linked_cmp cmp, const cerb_allocator *allocator)
+{
+    return doubly_linked_create_with_allocator(cmp, allocator);
+}
+
 // push void *data in stack
 // #define Stack_push(stack, data) doubly_linked_push(stack, data)
 
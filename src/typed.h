@@ -0,0 +1,544 @@
+#ifndef B52E0C41_8A7D_4C55_9F0B_2D6B1A4E7C93
+#define B52E0C41_8A7D_4C55_9F0B_2D6B1A4E7C93
+
+#include <stdint.h>
+#include "cerb_size.h"
+#include <stdlib.h>
+#include "allocator.h"
+#include "dbg.h"
+
+#define CERB_OK  0
+#define CERB_ERR -1
+
+/*
+ * Typed containers, which store elements of type T inline (no malloc per element and no void * to chase) and
+ * compare them with an expression, which compiler inlines (no indirect call per comparison).
+ * Every macro below generates struct and static inline functions prefixed with name, they behave like their
+ * void * counterparts (d_array.h, heap.h, hashmap.h) and return CERB_OK / CERB_ERR the same way.
+ *
+ * cmp_expr compares a and b (both of type const T) and works like strcmp(), for example for ints:
+ *     CERB_DARRAY_DEFINE(int_array, int, ((a) > (b)) - ((a) < (b)))
+ * hash_expr hashes a (of type const T) and gives uint64_t, for example:
+ *     CERB_HASHMAP_DEFINE(int_set, int, (uint64_t) (a) * 0x9E3779B97F4A7C15ULL, ((a) > (b)) - ((a) < (b)))
+ * name##_create_with_allocator variants take memory from given allocator (see allocator.h), others use libc.
+ */
+
+#define CERB_TYPED_DEFAULT_CAPACITY 8 // capacity used when 0 is requested
+#define CERB_TYPED_SHRINK_THRESHOLD 4 // shrink when length drops to 1/4 of capacity (d_array default)
+
+// ==============================================================================================================================
+// dynamic array of T (see d_array.h), grows geometrically and shrinks with hysteresis like d_array does by default
+
+#define CERB_DARRAY_DEFINE(name, T, cmp_expr)\
+\
+typedef struct name {\
+    T *data; /* elements stored inline */\
+    cerb_size_t capacity; /* capacity of array */\
+    cerb_size_t length; /* length of array */\
+    const cerb_allocator *allocator; /* allocator of struct and data block */\
+} name;\
+\
+/* compare a and b with cmp_expr */\
+static inline int name##_compare(const T a, const T b)\
+{\
+    return (cmp_expr);\
+}\
+\
+/* internally used to change capacity of array */\
+static inline int name##_resize(name *array, cerb_size_t new_capacity)\
+{\
+    T *new_data = (T *) cerb_realloc(array->allocator, array->data, array->data ? sizeof(T) * (array->capacity ? array->capacity : 1) : 0,\
+                                     sizeof(T) * (new_capacity ? new_capacity : 1));\
+    check_mem(new_data);\
+\
+    array->data = new_data;\
+    array->capacity = new_capacity;\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* create array with initial_capacity on top of allocator (NULL means cerb_libc_allocator) */\
+static inline name *name##_create_with_allocator(cerb_size_t initial_capacity, const cerb_allocator *allocator)\
+{\
+    allocator = cerb_allocator_or_default(allocator);\
+\
+    name *array = (name *) cerb_calloc(allocator, sizeof(name));\
+    check_mem(array);\
+    array->allocator = allocator;\
+\
+    int rc = name##_resize(array, initial_capacity ? initial_capacity : CERB_TYPED_DEFAULT_CAPACITY);\
+    check(rc != CERB_ERR, "Failed to create array.");\
+\
+    return array;\
+\
+error:\
+    cerb_free(allocator, array, sizeof(name));\
+    return NULL;\
+}\
+\
+/* create array with initial_capacity (CERB_TYPED_DEFAULT_CAPACITY if it is 0) */\
+static inline name *name##_create(cerb_size_t initial_capacity)\
+{\
+    return name##_create_with_allocator(initial_capacity, NULL);\
+}\
+\
+/* make sure array can hold at least capacity elements */\
+static inline int name##_reserve(name *array, uint64_t capacity)\
+{\
+    check(array != NULL, "array is NULL.");\
+    check(CERB_SIZE_FITS(capacity), "Can't expand past max available size, AKA CERB_SIZE_MAX.");\
+\
+    if (capacity <= array->capacity) return CERB_OK;\
+\
+    /* double the capacity, or take required one if doubling isn't enough */\
+    uint64_t new_capacity = (uint64_t) array->capacity * 2;\
+    if (new_capacity < capacity) new_capacity = capacity;\
+    if (!CERB_SIZE_FITS(new_capacity)) new_capacity = CERB_SIZE_MAX;\
+\
+    return name##_resize(array, (cerb_size_t) new_capacity);\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* internally used to shrink array after removing, leaving room for one growth step */\
+static inline void name##_shrink(name *array)\
+{\
+    if (array->capacity > CERB_TYPED_DEFAULT_CAPACITY &&\
+    array->length <= array->capacity / CERB_TYPED_SHRINK_THRESHOLD) {\
+        cerb_size_t new_capacity = array->length * 2;\
+        name##_resize(array, new_capacity > CERB_TYPED_DEFAULT_CAPACITY ? new_capacity : CERB_TYPED_DEFAULT_CAPACITY);\
+    }\
+}\
+\
+/* get pointer to [position] (NULL if position is invalid) */\
+static inline T *name##_get(name *array, cerb_size_t position)\
+{\
+    check(array != NULL, "array is NULL.");\
+    check(position < array->length, "Invalid position.");\
+\
+    return &array->data[position];\
+\
+error:\
+    return NULL;\
+}\
+\
+/* set [position] to value */\
+static inline int name##_set(name *array, cerb_size_t position, T value)\
+{\
+    check(array != NULL, "array is NULL.");\
+    check(position < array->length, "Invalid position.");\
+\
+    array->data[position] = value;\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* get index of value in array (-1 if it doesn't exist) */\
+static inline int64_t name##_index_of(name *array, T value)\
+{\
+    check(array != NULL, "array is NULL.");\
+\
+    cerb_size_t i;\
+    for (i = 0; i < array->length; i++) {\
+        if (name##_compare(array->data[i], value) == 0) return i;\
+    }\
+\
+error: /* fall through */\
+    return CERB_ERR;\
+}\
+\
+/* push value at the back of array */\
+static inline int name##_push_back(name *array, T value)\
+{\
+    check(array != NULL, "array is NULL.");\
+\
+    if (array->length == array->capacity) {\
+        int rc = name##_reserve(array, (uint64_t) array->length + 1);\
+        if (rc == CERB_ERR) return CERB_ERR;\
+    }\
+    array->data[array->length++] = value;\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* insert value at [position] (position can be length, which is the same as push_back) */\
+static inline int name##_insert_at(name *array, cerb_size_t position, T value)\
+{\
+    check(array != NULL, "array is NULL.");\
+    check(position <= array->length, "Invalid position.");\
+\
+    if (array->length == array->capacity) {\
+        int rc = name##_reserve(array, (uint64_t) array->length + 1);\
+        if (rc == CERB_ERR) return CERB_ERR;\
+    }\
+    memmove(array->data + position + 1, array->data + position, sizeof(T) * (array->length - position));\
+    array->data[position] = value;\
+    array->length++;\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* push value at the front of array */\
+static inline int name##_push_front(name *array, T value)\
+{\
+    return name##_insert_at(array, 0, value);\
+}\
+\
+/* remove [position] and store it in out (out can be NULL) */\
+static inline int name##_remove_at(name *array, cerb_size_t position, T *out)\
+{\
+    check(array != NULL, "array is NULL.");\
+    check(position < array->length, "Invalid position.");\
+\
+    if (out) *out = array->data[position];\
+    array->length--;\
+    memmove(array->data + position, array->data + position + 1, sizeof(T) * (array->length - position));\
+    name##_shrink(array);\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* pop value from the back of array and store it in out (out can be NULL) */\
+static inline int name##_pop_back(name *array, T *out)\
+{\
+    check(array != NULL, "array is NULL.");\
+    check(array->length, "array is empty.");\
+\
+    return name##_remove_at(array, array->length - 1, out);\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* pop value from the front of array and store it in out (out can be NULL) */\
+static inline int name##_pop_front(name *array, T *out)\
+{\
+    return name##_remove_at(array, 0, out);\
+}\
+\
+/* remove every element, but leave memory block allocated */\
+static inline int name##_clear(name *array)\
+{\
+    check(array != NULL, "array is NULL.");\
+\
+    array->length = 0;\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* destroy array and set it to NULL on stack (you need to provide reference to array) */\
+static inline int name##_destroy(name **array)\
+{\
+    check(array != NULL, "Address of array is NULL.");\
+    check(*array != NULL, "array is NULL.");\
+\
+    cerb_free((*array)->allocator, (*array)->data, sizeof(T) * ((*array)->capacity ? (*array)->capacity : 1));\
+    cerb_free((*array)->allocator, *array, sizeof(name));\
+    *array = NULL;\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}
+
+// ==============================================================================================================================
+// max heap of T (see heap.h), it is the typed array above, only functions handle it differently (Heap is d_array too)
+
+#define CERB_HEAP_DEFINE(name, T, cmp_expr)\
+\
+CERB_DARRAY_DEFINE(name, T, cmp_expr)\
+\
+/* internally used to emerge node from a bottom towards a root until needed */\
+static inline void name##_emerge(name *heap, cerb_size_t position)\
+{\
+    T value = heap->data[position];\
+    while (position) {\
+        cerb_size_t parent = (position - 1) / 2;\
+        if (name##_compare(value, heap->data[parent]) <= 0) break;\
+        heap->data[position] = heap->data[parent]; /* move parent down instead of swapping */\
+        position = parent;\
+    }\
+    heap->data[position] = value;\
+}\
+\
+/* internally used to sink node from up towards bottom until needed */\
+static inline void name##_sink(name *heap, cerb_size_t position)\
+{\
+    T value = heap->data[position];\
+    uint64_t child;\
+    while ((child = 2 * (uint64_t) position + 1) < heap->length) {\
+        if (child + 1 < heap->length && name##_compare(heap->data[child + 1], heap->data[child]) > 0) child++;\
+        if (name##_compare(heap->data[child], value) <= 0) break;\
+        heap->data[position] = heap->data[child]; /* move child up instead of swapping */\
+        position = child;\
+    }\
+    heap->data[position] = value;\
+}\
+\
+/* insert value in heap (satisfy heap invariant automatically after insertion) */\
+static inline int name##_insert(name *heap, T value)\
+{\
+    int rc = name##_push_back(heap, value);\
+    if (rc == CERB_ERR) return CERB_ERR;\
+\
+    name##_emerge(heap, heap->length - 1);\
+\
+    return CERB_OK;\
+}\
+\
+/* get pointer to highest priority element (NULL if heap is empty) */\
+static inline T *name##_top(name *heap)\
+{\
+    return name##_get(heap, 0);\
+}\
+\
+/* pop highest priority element and store it in out (out can be NULL) */\
+static inline int name##_pop(name *heap, T *out)\
+{\
+    check(heap != NULL, "heap is NULL.");\
+    check(heap->length, "heap is empty.");\
+\
+    if (out) *out = heap->data[0];\
+    heap->data[0] = heap->data[--heap->length];\
+    if (heap->length) name##_sink(heap, 0);\
+    name##_shrink(heap);\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* turn array of the same type into heap in place */\
+static inline int name##_heapify(name *heap)\
+{\
+    check(heap != NULL, "heap is NULL.");\
+\
+    cerb_size_t i; /* sink every non-leaf node starting from the last one */\
+    for (i = heap->length / 2; i > 0; i--) {\
+        name##_sink(heap, i - 1);\
+    }\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}
+
+// ==============================================================================================================================
+// hash set of T (see hashmap.h, keys are embedded in T the same way), stores elements inline in an open addressing
+// table with linear probing. capacity is always a power of 2 and table grows when it gets 3/4 full
+
+#define CERB_HASHMAP_DEFINE(name, T, hash_expr, cmp_expr)\
+\
+typedef struct name {\
+    T *slots; /* elements stored inline */\
+    cerb_size_t *hashes; /* hash of element in each slot (0 means empty slot) */\
+    cerb_size_t capacity; /* number of slots */\
+    cerb_size_t length; /* number of elements */\
+    const cerb_allocator *allocator; /* allocator of struct and table */\
+} name;\
+\
+/* hash a with hash_expr (never gives 0, which marks empty slots) */\
+static inline cerb_size_t name##_hash(const T a)\
+{\
+    uint64_t hash = (hash_expr);\
+    /* 32-bit sizes keep folded 32-bit hashes, 64-bit ones keep the whole hash */\
+    cerb_size_t folded = (cerb_size_t) (sizeof(cerb_size_t) < sizeof(uint64_t) ? hash ^ (hash >> 32) : hash);\
+    return folded ? folded : 1;\
+}\
+\
+/* compare a and b with cmp_expr */\
+static inline int name##_compare(const T a, const T b)\
+{\
+    return (cmp_expr);\
+}\
+\
+/* internally used to allocate table of capacity (which is a power of 2) slots */\
+static inline int name##_alloc(name *map, cerb_size_t capacity)\
+{\
+    map->slots = (T *) cerb_alloc(map->allocator, sizeof(T) * capacity);\
+    check_mem(map->slots);\
+    map->hashes = (cerb_size_t *) cerb_calloc(map->allocator, sizeof(cerb_size_t) * capacity);\
+    check_mem(map->hashes);\
+    map->capacity = capacity;\
+    map->length = 0;\
+\
+    return CERB_OK;\
+\
+error:\
+    cerb_free(map->allocator, map->slots, sizeof(T) * capacity);\
+    return CERB_ERR;\
+}\
+\
+/* internally used to place value with hash in the first free slot of its probe sequence */\
+static inline void name##_place(name *map, cerb_size_t hash, T value)\
+{\
+    cerb_size_t mask = map->capacity - 1, i = hash & mask;\
+    while (map->hashes[i]) i = (i + 1) & mask;\
+    map->hashes[i] = hash;\
+    map->slots[i] = value;\
+    map->length++;\
+}\
+\
+/* create map which can hold at least number_of_entries elements without growing, on top of allocator */\
+static inline name *name##_create_with_allocator(cerb_size_t number_of_entries, const cerb_allocator *allocator)\
+{\
+    allocator = cerb_allocator_or_default(allocator);\
+\
+    name *map = (name *) cerb_calloc(allocator, sizeof(name));\
+    check_mem(map);\
+    map->allocator = allocator;\
+\
+    cerb_size_t capacity = CERB_TYPED_DEFAULT_CAPACITY;\
+    while (capacity < CERB_SIZE_MAX / 2 && (uint64_t) capacity * 3 / 4 < number_of_entries) capacity *= 2;\
+\
+    int rc = name##_alloc(map, capacity);\
+    check(rc != CERB_ERR, "Failed to create map.");\
+\
+    return map;\
+\
+error:\
+    cerb_free(allocator, map, sizeof(name));\
+    return NULL;\
+}\
+\
+/* create map which can hold at least number_of_entries elements without growing */\
+static inline name *name##_create(cerb_size_t number_of_entries)\
+{\
+    return name##_create_with_allocator(number_of_entries, NULL);\
+}\
+\
+/* internally used to double the capacity of table */\
+static inline int name##_grow(name *map)\
+{\
+    name old = *map;\
+\
+    check(map->capacity < CERB_SIZE_MAX / 2 + 1, "Can't expand past max available size, AKA CERB_SIZE_MAX.");\
+    int rc = name##_alloc(map, map->capacity * 2);\
+    if (rc == CERB_ERR) {\
+        *map = old;\
+        return CERB_ERR;\
+    }\
+\
+    cerb_size_t i; /* stored hashes are reused, hash_expr isn't evaluated again */\
+    for (i = 0; i < old.capacity; i++) {\
+        if (old.hashes[i]) name##_place(map, old.hashes[i], old.slots[i]);\
+    }\
+    cerb_free(map->allocator, old.slots, sizeof(T) * old.capacity);\
+    cerb_free(map->allocator, old.hashes, sizeof(cerb_size_t) * old.capacity);\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* internally used to find the slot of key (-1 if it doesn't exist) */\
+static inline int64_t name##_slot_of(name *map, T key)\
+{\
+    cerb_size_t hash = name##_hash(key), mask = map->capacity - 1, i = hash & mask;\
+    for (; map->hashes[i]; i = (i + 1) & mask) {\
+        if (map->hashes[i] == hash && name##_compare(map->slots[i], key) == 0) return i;\
+    }\
+    return CERB_ERR;\
+}\
+\
+/* insert value in map (duplicates are allowed, as in Hashmap_insert) */\
+static inline int name##_insert(name *map, T value)\
+{\
+    check(map != NULL, "map is NULL.");\
+\
+    if (((uint64_t) map->length + 1) * 4 > (uint64_t) map->capacity * 3) {\
+        int rc = name##_grow(map);\
+        if (rc == CERB_ERR) return CERB_ERR;\
+    }\
+    name##_place(map, name##_hash(value), value);\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* find key in map and return pointer to element stored inline (NULL if it doesn't exist) */\
+static inline T *name##_find(name *map, T key)\
+{\
+    check(map != NULL, "map is NULL.");\
+\
+    int64_t slot = name##_slot_of(map, key);\
+    return slot == CERB_ERR ? NULL : &map->slots[slot];\
+\
+error:\
+    return NULL;\
+}\
+\
+/* remove key from map and store removed element in out (out can be NULL) */\
+static inline int name##_remove(name *map, T key, T *out)\
+{\
+    check(map != NULL, "map is NULL.");\
+\
+    int64_t slot = name##_slot_of(map, key);\
+    if (slot == CERB_ERR) return CERB_ERR;\
+    if (out) *out = map->slots[slot];\
+\
+    /* shift following elements of the cluster back, so that no tombstones are needed */\
+    cerb_size_t mask = map->capacity - 1, i = (cerb_size_t) slot, j = i;\
+    while (1) {\
+        j = (j + 1) & mask;\
+        if (!map->hashes[j]) break;\
+        cerb_size_t home = map->hashes[j] & mask;\
+        /* element at j can be moved to i only if its home slot isn't cyclically in (i, j] */\
+        if ((i <= j) ? (home <= i || home > j) : (home <= i && home > j)) {\
+            map->hashes[i] = map->hashes[j];\
+            map->slots[i] = map->slots[j];\
+            i = j;\
+        }\
+    }\
+    map->hashes[i] = 0;\
+    map->length--;\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}\
+\
+/* destroy map and set it to NULL on stack (you need to provide reference to map) */\
+static inline int name##_destroy(name **map)\
+{\
+    check(map != NULL, "Address of map is NULL.");\
+    check(*map != NULL, "map is NULL.");\
+\
+    cerb_free((*map)->allocator, (*map)->slots, sizeof(T) * (*map)->capacity);\
+    cerb_free((*map)->allocator, (*map)->hashes, sizeof(cerb_size_t) * (*map)->capacity);\
+    cerb_free((*map)->allocator, *map, sizeof(name));\
+    *map = NULL;\
+\
+    return CERB_OK;\
+\
+error:\
+    return CERB_ERR;\
+}
+
+#endif /* B52E0C41_8A7D_4C55_9F0B_2D6B1A4E7C93 */
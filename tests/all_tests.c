@@ -3,12 +3,21 @@
 #include "../src/singly_linked.h"
 #include "../src/doubly_linked.h"
 #include "../src/d_array.h"
+#include "../src/d_array_sort.h"
+#include "../src/d_array_parallel.h"
 #include "../src/hashmap.h"
+#include "../src/chashmap.h"
+#include "../src/hashmap_frozen.h"
 #include "../src/heap.h"
 #include "../src/priority_queue.h"
+#include "../src/indexed_heap.h"
 #include "../src/binary_search_tree.h"
+#include "../src/flatmap.h"
 #include "../src/stack.h"
 #include "../src/queue.h"
+#include "../src/typed.h"
+#include "../src/simd_search.h"
+#include "../src/allocator.h"
 #include <string.h>
 
 
@@ -252,6 +261,421 @@ char *test_pop_DA()
     return NULL;
 }
 
+// custom growth policy for test_growth_policy_DA (grows by exactly what is required)
+cerb_size_t exact_growth_cb(cerb_size_t capacity, cerb_size_t required)
+{
+    return capacity > required ? capacity : required;
+}
+
+char *test_growth_policy_DA()
+{
+    d_array *grow = d_array_create(NULL, 1);
+    mu_assert(grow != NULL, "failed to create array.");
+
+    // geometric growth is default, capacity never exceeds twice the length
+    uint32_t i;
+    for (i = 0; i < 100000; i++) {
+        rc = d_array_push_back(grow, test1);
+        mu_assert(rc != CERB_ERR, "push failed.");
+    }
+    mu_assert(d_array_capacity(grow) < 2 * 100000, "geometric growth overallocated.");
+
+    // push/pop at the boundary of capacity doesn't resize array
+    while (d_array_length(grow) != d_array_capacity(grow)) d_array_push_back(grow, test1);
+    uint32_t capacity = d_array_capacity(grow);
+    d_array_pop_back(grow);
+    for (i = 0; i < 100; i++) {
+        d_array_push_back(grow, test1);
+        d_array_pop_back(grow);
+    }
+    mu_assert(d_array_capacity(grow) == capacity, "push/pop at the boundary resized array.");
+
+    // shrinking happens only after length drops to shrink_threshold of capacity
+    while (d_array_length(grow) > capacity / 4 + 1) d_array_pop_back(grow);
+    mu_assert(d_array_capacity(grow) == capacity, "array shrinked too early.");
+    d_array_pop_back(grow);
+    mu_assert(d_array_capacity(grow) < capacity, "array didn't shrink.");
+    mu_assert(d_array_capacity(grow) > d_array_length(grow), "array shrinked without leaving room to grow.");
+
+    // fixed and custom policies
+    rc = d_array_set_growth_fixed(grow, 10);
+    mu_assert(rc != CERB_ERR && d_array_growth_policy(grow) == D_ARRAY_GROWTH_FIXED, "failed to set fixed growth.");
+    while (d_array_length(grow) != d_array_capacity(grow)) d_array_push_back(grow, test1);
+    capacity = d_array_capacity(grow);
+    d_array_push_back(grow, test1);
+    mu_assert(d_array_capacity(grow) == capacity + 10, "fixed growth failed.");
+
+    rc = d_array_set_growth_custom(grow, exact_growth_cb);
+    mu_assert(rc != CERB_ERR, "failed to set custom growth.");
+    while (d_array_length(grow) != d_array_capacity(grow)) d_array_push_back(grow, test1);
+    capacity = d_array_capacity(grow);
+    d_array_push_back(grow, test1);
+    mu_assert(d_array_capacity(grow) == capacity + 1, "custom growth failed.");
+
+    mu_assert(d_array_set_growth_geometric(grow, 100) == CERB_ERR, "growth factor of 100 accepted.");
+
+    rc = d_array_destroy(&grow, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+
+    return NULL;
+}
+
+char *test_ring_mode_DA()
+{
+    static int values[1000];
+    d_array *ring = d_array_create(NULL, 4);
+    mu_assert(ring != NULL, "failed to create array.");
+
+    rc = d_array_set_mode(ring, D_ARRAY_RING);
+    mu_assert(rc != CERB_ERR && d_array_mode(ring) == D_ARRAY_RING, "failed to set ring mode.");
+
+    // use array as a FIFO, so that elements wrap around the end of data block
+    uint32_t i, next = 0;
+    for (i = 0; i < 1000; i++) {
+        values[i] = i;
+        rc = d_array_push_back(ring, &values[i]);
+        mu_assert(rc != CERB_ERR, "push failed.");
+        if (i % 3 == 2) {
+            data = d_array_pop_front(ring);
+            mu_assert(data != NULL && *(int *)data == (int) next++, "pop_front returned wrong element.");
+        }
+    }
+    mu_assert(d_array_length(ring) == 1000 - next, "wrong length of ring.");
+
+    // push_front and pop_back on the other ends
+    rc = d_array_push_front(ring, &values[0]);
+    mu_assert(rc != CERB_ERR && d_array_at_zero(ring) == &values[0], "push_front failed.");
+    mu_assert(d_array_at_last(ring) == &values[999], "wrong last element.");
+    mu_assert(d_array_pop_back(ring) == &values[999], "pop_back failed.");
+    mu_assert(d_array_pop_front(ring) == &values[0], "pop_front failed.");
+
+    // positional operations work on ring arrays too
+    rc = d_array_insert_at(ring, 10, &values[0]);
+    mu_assert(rc != CERB_ERR && d_array_get(ring, 10) == &values[0], "insert_at failed.");
+    mu_assert(d_array_get(ring, 11) == &values[next + 10], "insert_at broke order.");
+    mu_assert(d_array_remove_at(ring, 10) == &values[0], "remove_at failed.");
+    mu_assert(d_array_index_of(ring, &values[next + 5]) == 5, "index_of failed.");
+
+    // slices cover the whole array in order
+    void **first = NULL, **second = NULL;
+    cerb_size_t first_length = 0, second_length = 0;
+    rc = d_array_slices(ring, &first, &first_length, &second, &second_length);
+    mu_assert(rc != CERB_ERR && first_length + second_length == d_array_length(ring), "wrong slices.");
+    for (i = 0; i < d_array_length(ring); i++) {
+        void *expected = i < first_length ? first[i] : second[i - first_length];
+        mu_assert(expected == &values[next + i], "slices are out of order.");
+    }
+
+    rc = d_array_linearize(ring);
+    mu_assert(rc != CERB_ERR && ring->head == 0, "failed to linearize.");
+    for (i = 0; i < d_array_length(ring); i++) {
+        mu_assert(ring->data[i] == &values[next + i], "linearize broke order.");
+    }
+
+    rc = d_array_destroy(&ring, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+
+    return NULL;
+}
+
+char *test_bulk_DA()
+{
+    static int values[3000];
+    void *batch[1000];
+    uint32_t i;
+    for (i = 0; i < 3000; i++) values[i] = i;
+    for (i = 0; i < 1000; i++) batch[i] = &values[i + 1000];
+
+    d_array *bulk = d_array_create(NULL, 1);
+    mu_assert(bulk != NULL, "failed to create array.");
+
+    rc = d_array_reserve(bulk, 2000);
+    mu_assert(rc != CERB_ERR && d_array_capacity(bulk) >= 2000, "reserve failed.");
+
+    // [ 0 .. 999 ] then [ 2000 .. 2999 ] then insert [ 1000 .. 1999 ] between them
+    for (i = 0; i < 1000; i++) d_array_push_back(bulk, &values[i]);
+    void *tail[1000];
+    for (i = 0; i < 1000; i++) tail[i] = &values[i + 2000];
+    rc = d_array_push_back_n(bulk, tail, 1000);
+    mu_assert(rc != CERB_ERR && d_array_length(bulk) == 2000, "push_back_n failed.");
+    rc = d_array_insert_range(bulk, 1000, batch, 1000);
+    mu_assert(rc != CERB_ERR && d_array_length(bulk) == 3000, "insert_range failed.");
+    for (i = 0; i < 3000; i++) {
+        mu_assert(d_array_get(bulk, i) == &values[i], "insert_range broke order.");
+    }
+
+    // remove [ 500 .. 2499 ] and check that removed elements were handed back
+    void *removed[2000];
+    rc = d_array_remove_range(bulk, 500, 2500, removed);
+    mu_assert(rc != CERB_ERR && d_array_length(bulk) == 1000, "remove_range failed.");
+    mu_assert(removed[0] == &values[500] && removed[1999] == &values[2499], "wrong removed elements.");
+    mu_assert(d_array_get(bulk, 499) == &values[499] && d_array_get(bulk, 500) == &values[2500],
+    "remove_range broke order.");
+
+    // append ring array, which wraps around, to linear one
+    d_array *ring = d_array_create(NULL, 8);
+    d_array_set_mode(ring, D_ARRAY_RING);
+    for (i = 0; i < 6; i++) d_array_push_back(ring, &values[i]);
+    d_array_remove_range(ring, 0, 4, NULL);
+    for (i = 6; i < 12; i++) d_array_push_back(ring, &values[i]);
+    mu_assert(d_array_get(ring, 0) == &values[4], "remove_range from the front of ring failed.");
+    rc = d_array_append_array(bulk, ring);
+    mu_assert(rc != CERB_ERR && d_array_length(bulk) == 1008, "append_array failed.");
+    for (i = 0; i < 8; i++) {
+        mu_assert(d_array_get(bulk, 1000 + i) == &values[4 + i], "append_array broke order.");
+    }
+
+    rc = d_array_destroy(&ring, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+    rc = d_array_destroy(&bulk, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+
+    return NULL;
+}
+
+// records for test_sort_DA, ordered by key only, so that stability can be checked with position
+typedef struct sort_record {
+    int key;
+    int position;
+} sort_record;
+
+int sort_record_cmp(const void *const restrict data1, const void *const restrict data2)
+{
+    return cmp_func_ALL(&((sort_record *) data1)->key, &((sort_record *) data2)->key);
+}
+
+uint64_t sort_record_key(const void *data)
+{
+    return D_ARRAY_SIGNED_KEY(((sort_record *) data)->key);
+}
+
+// checks that array is sorted by key (and by position too if stable is set)
+int is_sorted_records(d_array *records, uint32_t count, int stable)
+{
+    uint32_t i;
+    for (i = 1; i < count; i++) {
+        sort_record *previous = d_array_get(records, i - 1), *current = d_array_get(records, i);
+        if (previous->key > current->key) return 0;
+        if (stable && previous->key == current->key && previous->position > current->position) return 0;
+    }
+    return 1;
+}
+
+char *test_sort_DA()
+{
+    static sort_record records[10000];
+    d_array *sorted = d_array_create(sort_record_cmp, 10000);
+    mu_assert(sorted != NULL, "failed to create array.");
+
+    // random keys with a lot of duplicates (and negative ones for radix sort)
+    uint32_t i, seed = 12345;
+    for (i = 0; i < 10000; i++) {
+        seed = seed * 1103515245 + 12345;
+        records[i].key = (int) ((seed >> 16) % 2000) - 1000;
+        records[i].position = i;
+        d_array_push_back(sorted, &records[i]);
+    }
+
+    rc = d_array_stable_sort(sorted);
+    mu_assert(rc != CERB_ERR && is_sorted_records(sorted, 10000, 1), "stable sort failed.");
+
+    // sort again from reversed order, which is one of the patterns pdqsort handles in linear time
+    for (i = 0; i < 5000; i++) {
+        void *temp = sorted->data[i];
+        sorted->data[i] = sorted->data[9999 - i];
+        sorted->data[9999 - i] = temp;
+    }
+    rc = d_array_sort(sorted);
+    mu_assert(rc != CERB_ERR && is_sorted_records(sorted, 10000, 0), "sort failed.");
+
+    // radix sort is stable, so positions need to be restored first
+    for (i = 0; i < 10000; i++) sorted->data[i] = &records[i];
+    rc = d_array_radix_sort(sorted, sort_record_key);
+    mu_assert(rc != CERB_ERR && is_sorted_records(sorted, 10000, 1), "radix sort failed.");
+
+    // selection
+    int median = ((sort_record *) d_array_get(sorted, 5000))->key;
+    for (i = 0; i < 10000; i++) sorted->data[i] = &records[i];
+    rc = d_array_nth_element(sorted, 5000);
+    mu_assert(rc != CERB_ERR && ((sort_record *) d_array_get(sorted, 5000))->key == median, "nth_element failed.");
+    for (i = 0; i < 10000; i++) {
+        int key = ((sort_record *) d_array_get(sorted, i))->key;
+        mu_assert(i < 5000 ? key <= median : key >= median, "nth_element didn't partition array.");
+    }
+
+    for (i = 0; i < 10000; i++) sorted->data[i] = &records[i];
+    rc = d_array_partial_sort(sorted, 100);
+    mu_assert(rc != CERB_ERR && is_sorted_records(sorted, 100, 0), "partial_sort failed.");
+    int hundredth = ((sort_record *) d_array_get(sorted, 99))->key;
+    for (i = 100; i < 10000; i++) {
+        mu_assert(((sort_record *) d_array_get(sorted, i))->key >= hundredth, "partial_sort missed smaller element.");
+    }
+
+    // all equal keys
+    for (i = 0; i < 10000; i++) records[i].key = 7;
+    rc = d_array_sort(sorted);
+    mu_assert(rc != CERB_ERR && is_sorted_records(sorted, 10000, 0), "sort of equal keys failed.");
+
+    rc = d_array_destroy(&sorted, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+
+    return NULL;
+}
+
+int parallel_negative_cb(void *data)
+{
+    return ((sort_record *) data)->key < 0 ? CERB_ERR : CERB_OK;
+}
+
+void parallel_sum_cb(void *accumulator, void *data)
+{
+    *(long *) accumulator += ((sort_record *) data)->key;
+}
+
+void parallel_combine_cb(void *accumulator, const void *other)
+{
+    *(long *) accumulator += *(const long *) other;
+}
+
+// libc allocator which notes calls from threads other than one which set it up (it isn't thread-safe itself)
+typedef struct owned_allocator_DA {
+    pthread_t owner;
+    int foreign_calls;
+} owned_allocator_DA;
+
+static void *owned_alloc_DA(void *context, size_t size)
+{
+    owned_allocator_DA *owned = context;
+    if (!pthread_equal(owned->owner, pthread_self())) owned->foreign_calls++;
+    return malloc(size);
+}
+
+static void *owned_realloc_DA(void *context, void *ptr, size_t old_size, size_t new_size)
+{
+    (void) old_size;
+    owned_allocator_DA *owned = context;
+    if (!pthread_equal(owned->owner, pthread_self())) owned->foreign_calls++;
+    return realloc(ptr, new_size);
+}
+
+static void owned_free_DA(void *context, void *ptr, size_t size)
+{
+    (void) size;
+    owned_allocator_DA *owned = context;
+    if (!pthread_equal(owned->owner, pthread_self())) owned->foreign_calls++;
+    free(ptr);
+}
+
+char *test_parallel_DA()
+{
+    static sort_record records[50000];
+    owned_allocator_DA owned = {pthread_self(), 0};
+    cerb_allocator allocator = {owned_alloc_DA, owned_realloc_DA, owned_free_DA, &owned};
+    cerb_executor *executor = cerb_executor_create(4);
+    d_array *sorted = d_array_create_with_allocator(sort_record_cmp, 50000, &allocator);
+    mu_assert(executor != NULL && sorted != NULL, "failed to create executor or array.");
+
+    uint32_t i, seed = 54321;
+    long sum = 0;
+    for (i = 0; i < 50000; i++) {
+        seed = seed * 1103515245 + 12345;
+        records[i].key = (int) ((seed >> 16) % 5000);
+        records[i].position = i;
+        sum += records[i].key;
+        d_array_push_back(sorted, &records[i]);
+    }
+
+    rc = d_array_parallel_traverse(sorted, executor, 1000, parallel_negative_cb);
+    mu_assert(rc != CERB_ERR, "parallel traverse failed.");
+
+    long result = 0;
+    rc = d_array_parallel_reduce(sorted, executor, 0, &result, sizeof(result), parallel_sum_cb, parallel_combine_cb);
+    mu_assert(rc != CERB_ERR && result == sum, "parallel reduce failed.");
+
+    rc = d_array_parallel_sort(sorted, executor);
+    mu_assert(rc != CERB_ERR && is_sorted_records(sorted, 50000, 1), "parallel sort failed.");
+    mu_assert(owned.foreign_calls == 0, "allocator was called from executor threads.");
+
+    // failing callback is reported
+    records[49999].key = -1;
+    rc = d_array_parallel_traverse(sorted, executor, 1000, parallel_negative_cb);
+    mu_assert(rc == CERB_ERR, "parallel traverse didn't report failure.");
+
+    rc = d_array_destroy(&sorted, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+    rc = cerb_executor_destroy(&executor);
+    mu_assert(rc != CERB_ERR && executor == NULL, "error while destroying executor.");
+
+    return NULL;
+}
+
+char *test_search_DA()
+{
+    static int values[100];
+    d_array *searched = d_array_create(NULL, 8);
+    mu_assert(searched != NULL, "failed to create array.");
+
+    // ring array which wraps around, so both slices are searched
+    uint32_t i;
+    int level, copy = 77;
+    d_array_set_mode(searched, D_ARRAY_RING);
+    for (i = 0; i < 100; i++) {
+        values[i] = (int) i;
+        d_array_push_front(searched, &values[i]);
+    }
+
+    // every kernel level CPU has, from scalar up
+    for (level = CERB_SIMD_SCALAR; level <= CERB_SIMD_AVX2; level++) {
+        cerb_simd_set_level(level);
+
+        d_array_set_search_mode(searched, D_ARRAY_SEARCH_IDENTITY);
+        mu_assert(d_array_index_of(searched, &values[0]) == 99, "identity search failed.");
+        mu_assert(d_array_index_of(searched, &values[93]) == 6, "identity search failed.");
+        mu_assert(d_array_index_of(searched, &copy) == -1, "identity search matched equal value.");
+
+        d_array_set_search_mode(searched, D_ARRAY_SEARCH_INT);
+        mu_assert(d_array_index_of(searched, &copy) == 22, "int search failed.");
+        copy = 100;
+        mu_assert(d_array_index_of(searched, &copy) == -1, "int search found missing value.");
+        copy = 77;
+    }
+    cerb_simd_set_level(CERB_SIMD_AVX2); // back to the best one
+
+    rc = d_array_destroy(&searched, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+
+    return NULL;
+}
+
+static int printed_DA = 0;
+
+static int print_cb_DA(void *data)
+{
+    printed_DA++;
+    return *(int *) data;
+}
+
+char *test_print_DA()
+{
+    static int values[3] = {1, 2, 3};
+    int i;
+
+    // empty array prints only brackets (index of last element mustn't wrap around with 64-bit cerb_size_t)
+    d_array *printed = d_array_create(NULL, 0);
+    mu_assert(printed != NULL, "failed to create array.");
+    d_array_print(printed, print_cb_DA, "%d");
+    mu_assert(printed_DA == 0, "empty array printed elements.");
+
+    for (i = 0; i < 3; i++) d_array_push_back(printed, &values[i]);
+    d_array_print(printed, print_cb_DA, "%d");
+    mu_assert(printed_DA == 3, "wrong number of elements printed.");
+
+    rc = d_array_destroy(&printed, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+
+    return NULL;
+}
+
 char *test_free_array_DA()
 {
     rc = d_array_destroy(&array, nofree_cb);
@@ -312,6 +736,575 @@ char *test_delete_HM()
     return NULL;
 }
 
+uint32_t int_hash_HM(void *data)
+{
+    return (uint32_t) *(int *) data;
+}
+
+char *test_search_HM()
+{
+    static int values[200];
+    // few buckets which never grow, so that they are long
+    Hashmap_config config = {NULL, int_hash_HM, 7, NULL, HASHMAP_CHAINED, HASHMAP_FIXED_SIZE, NULL, 0};
+    Hashmap *searched = Hashmap_create_with_config(&config);
+    mu_assert(searched != NULL, "failed to create map.");
+
+    uint32_t i;
+    for (i = 0; i < 200; i++) {
+        values[i] = (int) i;
+        Hashmap_insert(searched, &values[i]);
+    }
+
+    int key = 150;
+    Hashmap_set_search_mode(searched, HASHMAP_SEARCH_INT);
+    mu_assert(Hashmap_find(searched, &key) == &values[150], "int search failed.");
+    Hashmap_set_search_mode(searched, HASHMAP_SEARCH_IDENTITY);
+    mu_assert(Hashmap_find(searched, &key) == NULL, "identity search matched equal value.");
+    mu_assert(Hashmap_remove(searched, &values[150]) == &values[150], "identity remove failed.");
+    mu_assert(Hashmap_find(searched, &values[150]) == NULL, "removed value is still there.");
+
+    rc = Hashmap_destroy(&searched, nofree_cb);
+    mu_assert(rc != CERB_ERR, "failed to free.");
+
+    return NULL;
+}
+
+static int string_compares_HM = 0;
+
+int string_cmp_HM(const void *const restrict data1, const void *const restrict data2)
+{
+    string_compares_HM++;
+    return strcmp((const char *) data1, (const char *) data2);
+}
+
+char *test_hash_compare_HM()
+{
+    static char keys[64][16];
+    // one bucket, so that every key collides on bucket index (default hash is fnv1a of strings)
+    Hashmap_config config = {string_cmp_HM, NULL, 1, NULL, HASHMAP_CHAINED, HASHMAP_FIXED_SIZE, NULL, 0};
+    Hashmap *strings = Hashmap_create_with_config(&config);
+    mu_assert(strings != NULL, "failed to create map.");
+
+    int i;
+    for (i = 0; i < 64; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "key-%d", i);
+        Hashmap_insert(strings, keys[i]);
+    }
+
+    // only node with the same whole hash gets compared
+    char key[16] = "key-63";
+    string_compares_HM = 0;
+    mu_assert(Hashmap_find(strings, key) == keys[63], "find failed.");
+    mu_assert(string_compares_HM == 1, "compare was called for nodes with different hashes.");
+    strcpy(key, "missing");
+    mu_assert(Hashmap_find(strings, key) == NULL, "found missing key.");
+    mu_assert(string_compares_HM == 1, "compare was called for missing key.");
+
+    rc = Hashmap_destroy(&strings, nofree_cb);
+    mu_assert(rc != CERB_ERR, "failed to free.");
+
+    return NULL;
+}
+
+char *test_hash_bytes_HM()
+{
+    static const char text[] = "https://example.com/api/v1/users/1234/orders?page=2&limit=50&sort=created_at";
+    size_t length;
+
+    // every length hashes differently and only given bytes are read (asan build checks the latter)
+    for (length = 0; length < sizeof(text) - 1; length++) {
+        char *copy = malloc(length ? length : 1);
+        mu_assert(copy != NULL, "out of memory.");
+        memcpy(copy, text, length);
+        mu_assert(Hashmap_hash_bytes(copy, length, 7) == Hashmap_hash_bytes(text, length, 7), "hash isn't deterministic.");
+        mu_assert(Hashmap_hash_bytes(copy, length, 7) != Hashmap_hash_bytes(text, length + 1, 7), "prefix hashed the same.");
+        mu_assert(Hashmap_hash_bytes(copy, length, 7) != Hashmap_hash_bytes(copy, length, 8), "seed is ignored.");
+        free(copy);
+    }
+
+    // default hash is seeded string hash, seeds differ from map to map
+    Hashmap *first = Hashmap_create(string_cmp_HM, NULL, 0);
+    Hashmap *second = Hashmap_create(string_cmp_HM, NULL, 0);
+    mu_assert(first != NULL && second != NULL, "failed to create maps.");
+    mu_assert(first->seed != second->seed, "maps got the same seed.");
+
+    rc = Hashmap_insert(first, (void *) text);
+    mu_assert(rc != CERB_ERR, "insert failed.");
+    char key[sizeof(text)];
+    strcpy(key, text);
+    mu_assert(Hashmap_find(first, key) == text, "find failed.");
+
+    Hashmap_destroy(&first, nofree_cb);
+    Hashmap_destroy(&second, nofree_cb);
+
+    return NULL;
+}
+
+char *test_rehash_HM()
+{
+    static int values[100000];
+    Hashmap *growing = Hashmap_create(NULL, int_hash_HM, 8);
+    mu_assert(growing != NULL, "failed to create map.");
+
+    int i, key, seen_rehashing = 0;
+    for (i = 0; i < 100000; i++) {
+        values[i] = i;
+        rc = Hashmap_insert(growing, &values[i]);
+        mu_assert(rc != CERB_ERR, "insert failed.");
+
+        if (Hashmap_is_rehashing(growing)) {
+            seen_rehashing = 1;
+            mu_assert(Hashmap_rehash_progress(growing) < 1.0, "wrong progress while rehashing.");
+            // elements are reachable whichever table they are in
+            key = i / 2;
+            mu_assert(Hashmap_find(growing, &key) == &values[i / 2], "find failed while rehashing.");
+        }
+    }
+    mu_assert(seen_rehashing, "map didn't grow.");
+    mu_assert(Hashmap_capacity(growing) >= 100000 / 2, "map didn't grow enough.");
+
+    rc = Hashmap_rehash_step(growing, 0);
+    mu_assert(rc != CERB_ERR && !Hashmap_is_rehashing(growing), "rehash step didn't finish rehashing.");
+    mu_assert(Hashmap_rehash_progress(growing) == 1.0, "wrong progress after rehashing.");
+
+    for (i = 0; i < 100000; i++) {
+        mu_assert(Hashmap_remove(growing, &values[i]) == &values[i], "remove failed.");
+    }
+    mu_assert(Hashmap_length(growing) == 0, "wrong length after remove.");
+
+    rc = Hashmap_destroy(&growing, nofree_cb);
+    mu_assert(rc != CERB_ERR, "failed to free.");
+
+    return NULL;
+}
+
+char *test_robin_hood_HM()
+{
+    static int values[10000];
+    Hashmap_config config = {NULL, int_hash_HM, 16, NULL, HASHMAP_ROBIN_HOOD, 90, NULL, 0};
+    Hashmap *table = Hashmap_create_with_config(&config);
+    mu_assert(table != NULL, "failed to create map.");
+
+    int i;
+    for (i = 0; i < 10000; i++) {
+        values[i] = i * 7;
+        rc = Hashmap_insert(table, &values[i]);
+        mu_assert(rc != CERB_ERR, "insert failed.");
+    }
+    mu_assert(Hashmap_length(table) == 10000, "wrong length after insert.");
+    mu_assert(Hashmap_length(table) * 100 <= Hashmap_capacity(table) * 90, "table didn't grow.");
+
+    // remove every other key, backward shift has to keep the rest reachable
+    for (i = 0; i < 10000; i += 2) {
+        mu_assert(Hashmap_remove(table, &values[i]) == &values[i], "remove failed.");
+    }
+    int key;
+    for (i = 0; i < 10000; i++) {
+        key = i * 7;
+        mu_assert((Hashmap_find(table, &key) != NULL) == (i % 2 == 1), "wrong find after remove.");
+    }
+    key = 3;
+    mu_assert(Hashmap_find(table, &key) == NULL, "found missing key.");
+    mu_assert(Hashmap_remove(table, &key) == NULL, "removed missing key.");
+
+    Hashmap_set_search_mode(table, HASHMAP_SEARCH_IDENTITY);
+    key = 7;
+    mu_assert(Hashmap_find(table, &key) == NULL, "identity search matched equal value.");
+    mu_assert(Hashmap_find(table, &values[1]) == &values[1], "identity search failed.");
+
+    rc = Hashmap_destroy(&table, nofree_cb);
+    mu_assert(rc != CERB_ERR, "failed to free.");
+
+    return NULL;
+}
+
+char *test_key_value_HM()
+{
+    static int keys[1000];
+    Hashmap_config configs[] = {
+        {NULL, int_hash_HM, 8, NULL, HASHMAP_CHAINED, 0, NULL, 0},
+        {NULL, int_hash_HM, 8, NULL, HASHMAP_ROBIN_HOOD, 0, NULL, 0}
+    };
+    int i, c, inserted;
+
+    for (i = 0; i < 1000; i++) keys[i] = i;
+
+    for (c = 0; c < 2; c++) {
+        Hashmap *counts = Hashmap_create_with_config(&configs[c]);
+        mu_assert(counts != NULL, "failed to create map.");
+
+        // count occurrences of i % 100, values are counters kept in pointers (maps grow on the way)
+        for (i = 0; i < 1000; i++) {
+            void **slot = Hashmap_upsert(counts, &keys[i % 100], &inserted);
+            mu_assert(slot != NULL, "upsert failed.");
+            mu_assert(inserted == (i < 100), "upsert inserted existing key.");
+            *slot = (void *) ((intptr_t) *slot + 1);
+        }
+        mu_assert(Hashmap_length(counts) == 100, "key was inserted twice.");
+        int key = 42;
+        mu_assert((intptr_t) Hashmap_get(counts, &key) == 10, "wrong count.");
+        mu_assert(Hashmap_find(counts, &key) == &keys[42], "find doesn't return stored key.");
+
+        // put replaces value and keeps stored key, get_or_insert inserts only missing keys
+        rc = Hashmap_put(counts, &key, (void *) (intptr_t) 7);
+        mu_assert(rc != CERB_ERR, "put failed.");
+        mu_assert((intptr_t) Hashmap_get(counts, &keys[42]) == 7, "put didn't replace value.");
+        mu_assert(Hashmap_find(counts, &key) == &keys[42], "put replaced stored key.");
+        mu_assert((intptr_t) Hashmap_get_or_insert(counts, &keys[42], (void *) (intptr_t) 1) == 7, "get_or_insert replaced value.");
+        mu_assert((intptr_t) Hashmap_get_or_insert(counts, &keys[500], (void *) (intptr_t) 1) == 1, "get_or_insert failed.");
+        mu_assert(Hashmap_length(counts) == 101, "wrong length after get_or_insert.");
+
+        // prehashed calls work with hash map computes
+        uint32_t hash = Hashmap_hash(counts, &keys[600]);
+        mu_assert(Hashmap_get_prehashed(counts, &keys[600], hash) == NULL, "found missing key.");
+        rc = Hashmap_put_prehashed(counts, &keys[600], (void *) (intptr_t) 3, hash);
+        mu_assert(rc != CERB_ERR, "prehashed put failed.");
+        mu_assert((intptr_t) Hashmap_get(counts, &keys[600]) == 3, "prehashed put went to wrong place.");
+
+        // take gives value and stored key back
+        void *stored = NULL;
+        mu_assert((intptr_t) Hashmap_take(counts, &key, &stored) == 7 && stored == &keys[42], "take failed.");
+        mu_assert(Hashmap_take(counts, &key, &stored) == NULL && stored == NULL, "took missing key.");
+        mu_assert(Hashmap_get(counts, &key) == NULL, "taken key is still there.");
+
+        rc = Hashmap_destroy(&counts, nofree_cb);
+        mu_assert(rc != CERB_ERR, "failed to free.");
+    }
+
+    // existing key costs one compare, missing one none
+    Hashmap_config config = {string_cmp_HM, NULL, 1, NULL, HASHMAP_CHAINED, HASHMAP_FIXED_SIZE, NULL, 0};
+    Hashmap *strings = Hashmap_create_with_config(&config);
+    mu_assert(strings != NULL, "failed to create map.");
+    char word[] = "word", other[] = "word";
+    string_compares_HM = 0;
+    mu_assert(Hashmap_get_or_insert(strings, word, word) == word, "get_or_insert failed.");
+    mu_assert(Hashmap_get_or_insert(strings, other, other) == word, "get_or_insert inserted existing key.");
+    mu_assert(string_compares_HM == 1, "key was looked for more than once.");
+
+    // values are freed with their own callback
+    rc = Hashmap_put(strings, "value", malloc(sizeof(int)));
+    mu_assert(rc != CERB_ERR, "put failed.");
+    rc = Hashmap_destroy_with_values(&strings, nofree_cb, free);
+    mu_assert(rc != CERB_ERR, "failed to free.");
+
+    return NULL;
+}
+
+char *test_memory_usage_HM()
+{
+    static int values[20000];
+    cerb_counting_allocator counter;
+    int i, e;
+
+    for (e = 0; e < 2; e++) {
+        cerb_counting_allocator_init(&counter, NULL);
+        Hashmap_config config = {NULL, int_hash_HM, 16, &counter.allocator, (uint8_t) e, 0, NULL, 0};
+        Hashmap *counted = Hashmap_create_with_config(&config);
+        mu_assert(counted != NULL, "failed to create map.");
+
+        // usage is exactly what map got from allocator, while growing and after removals too
+        for (i = 0; i < 20000; i++) {
+            values[i] = i;
+            rc = Hashmap_insert(counted, &values[i]);
+            mu_assert(rc != CERB_ERR, "insert failed.");
+            if (i % 997 == 0) {
+                mu_assert(Hashmap_memory_usage(counted) == cerb_counting_allocator_in_use(&counter), "wrong usage.");
+            }
+        }
+        // buckets are one small block each, so chained map (old table and active lists included, it is still
+        // growing) stays well under node + d_array bucket per element it used to take
+        size_t bound = 20000 * (sizeof(Hashmap_node) + 6 * sizeof(void *) + 4 * sizeof(cerb_size_t));
+        mu_assert(Hashmap_memory_usage(counted) < bound, "map is too big.");
+
+        for (i = 0; i < 20000; i += 3) Hashmap_remove(counted, &values[i]);
+        mu_assert(Hashmap_memory_usage(counted) == cerb_counting_allocator_in_use(&counter), "wrong usage after remove.");
+
+        rc = Hashmap_destroy(&counted, nofree_cb);
+        mu_assert(rc != CERB_ERR, "failed to free.");
+        mu_assert(cerb_counting_allocator_in_use(&counter) == 0, "map leaked memory.");
+    }
+
+    return NULL;
+}
+
+char *test_iter_HM()
+{
+    static int values[5000];
+    cerb_counting_allocator counter;
+    Hashmap_iter iter;
+    void *data;
+    int i, e;
+
+    for (e = 0; e < 2; e++) {
+        cerb_counting_allocator_init(&counter, NULL);
+        Hashmap_config config = {NULL, int_hash_HM, 64, &counter.allocator, (uint8_t) e, 0, NULL, 0};
+        Hashmap *iterated = Hashmap_create_with_config(&config);
+        mu_assert(iterated != NULL, "failed to create map.");
+
+        long sum = 0;
+        for (i = 0; i < 5000; i++) {
+            values[i] = i;
+            rc = Hashmap_insert(iterated, &values[i]);
+            mu_assert(rc != CERB_ERR, "insert failed.");
+            sum += i;
+        }
+        for (i = 0; i < 5000; i += 5) {
+            Hashmap_remove(iterated, &values[i]);
+            sum -= i;
+        }
+
+        // chained map is in the middle of growing here, foreach visits both of its tables
+        long seen = 0, count = 0;
+        Hashmap_foreach(iterated, iter, data) {
+            mu_assert(iter.value == data, "value of inserted data is data.");
+            seen += *(int *) data;
+            count++;
+        }
+        mu_assert(count == (long) Hashmap_length(iterated), "foreach missed elements.");
+        mu_assert(seen == sum, "foreach returned wrong elements.");
+
+        rc = Hashmap_clear(iterated, NULL, NULL);
+        mu_assert(rc != CERB_ERR, "clear failed.");
+        mu_assert(Hashmap_length(iterated) == 0, "clear left elements.");
+        mu_assert(Hashmap_find(iterated, &values[1]) == NULL, "clear left elements.");
+        mu_assert(Hashmap_iter_begin(iterated, &iter) == CERB_OK && Hashmap_iter_next(&iter) == NULL,
+                  "cleared map isn't empty.");
+        mu_assert(Hashmap_memory_usage(iterated) == cerb_counting_allocator_in_use(&counter), "wrong usage.");
+
+        // map is usable after clear
+        rc = Hashmap_insert(iterated, &values[7]);
+        mu_assert(rc != CERB_ERR && Hashmap_find(iterated, &values[7]) == &values[7], "insert after clear failed.");
+
+        rc = Hashmap_destroy(&iterated, nofree_cb);
+        mu_assert(rc != CERB_ERR, "failed to free.");
+        mu_assert(cerb_counting_allocator_in_use(&counter) == 0, "map leaked memory.");
+    }
+
+    return NULL;
+}
+
+char *test_batch_HM()
+{
+    static int values[3000], missing[3000];
+    static void *data[3000], *keys[6000], *found[6000];
+    int i, e;
+
+    for (i = 0; i < 3000; i++) {
+        values[i] = i;
+        missing[i] = -i - 1;
+        data[i] = &values[i];
+        keys[2 * i] = &values[(i * 7) % 3000];
+        keys[2 * i + 1] = &missing[i];
+    }
+
+    for (e = 0; e < 2; e++) {
+        Hashmap_config config = {NULL, int_hash_HM, 16, NULL, (uint8_t) e, 0, NULL, 0};
+        Hashmap *batched = Hashmap_create_with_config(&config);
+        mu_assert(batched != NULL, "failed to create map.");
+
+        // batch which doesn't fill HASHMAP_BATCH and ones which grow map while they go
+        rc = Hashmap_insert_batch(batched, data, 5);
+        mu_assert(rc == CERB_OK, "batch insert failed.");
+        rc = Hashmap_insert_batch(batched, data + 5, 2995);
+        mu_assert(rc == CERB_OK, "batch insert failed.");
+        mu_assert(Hashmap_length(batched) == 3000, "wrong length after batch insert.");
+
+        rc = Hashmap_find_batch(batched, keys, 6000, found);
+        mu_assert(rc == CERB_OK, "batch find failed.");
+        for (i = 0; i < 6000; i++) {
+            mu_assert(found[i] == ((i & 1) ? NULL : keys[i]), "batch find returned wrong data.");
+            mu_assert(found[i] == Hashmap_find(batched, keys[i]), "batch find differs from find.");
+        }
+        mu_assert(Hashmap_find_batch(batched, keys, 0, NULL) == CERB_OK, "empty batch failed.");
+
+        rc = Hashmap_destroy(&batched, nofree_cb);
+        mu_assert(rc != CERB_ERR, "failed to free.");
+    }
+
+    return NULL;
+}
+
+// hash which collides a lot, so that frozen map has to put keys in its overflow map
+static uint32_t colliding_hash_HM(void *data)
+{
+    return (uint32_t) (*(int *) data % 1000);
+}
+
+char *test_freeze_HM()
+{
+    static int values[20000], missing = -5;
+    static char words[100][8];
+    cerb_counting_allocator counter;
+    int i, e;
+
+    for (i = 0; i < 20000; i++) values[i] = i;
+
+    // both engines, and hash which gives equal hashes to different keys
+    for (e = 0; e < 3; e++) {
+        cerb_counting_allocator_init(&counter, NULL);
+        Hashmap_config config = {NULL, e == 2 ? colliding_hash_HM : int_hash_HM, 64, &counter.allocator,
+                                 (uint8_t) (e & 1), 0, NULL, 0};
+        Hashmap *source = Hashmap_create_with_config(&config);
+        mu_assert(source != NULL, "failed to create map.");
+        for (i = 0; i < 20000; i++) {
+            rc = Hashmap_put(source, &values[i], &values[19999 - i]);
+            mu_assert(rc != CERB_ERR, "put failed.");
+        }
+
+        Hashmap_frozen *frozen = Hashmap_freeze(source);
+        mu_assert(frozen != NULL, "failed to freeze map.");
+        mu_assert(Hashmap_frozen_length(frozen) == 20000, "wrong frozen length.");
+        mu_assert((e == 2) == (frozen->overflow != NULL), "overflow map is there for wrong hash.");
+
+        // snapshot doesn't depend on map
+        rc = Hashmap_destroy(&source, NULL);
+        mu_assert(rc != CERB_ERR, "failed to free.");
+
+        for (i = 0; i < 20000; i++) {
+            mu_assert(Hashmap_frozen_find(frozen, &values[i]) == &values[i], "frozen map lost key.");
+            mu_assert(Hashmap_frozen_get(frozen, &values[i]) == &values[19999 - i], "frozen map lost value.");
+        }
+        mu_assert(Hashmap_frozen_find(frozen, &missing) == NULL, "frozen map found missing key.");
+
+        if (e == 0) {
+            // keys and values packed with a few bytes of pilots and remap on top
+            size_t packed = 20000 * sizeof(Hashmap_frozen_entry);
+            mu_assert(Hashmap_frozen_memory_usage(frozen) < packed + packed / 8, "frozen map is too big.");
+        }
+        mu_assert(Hashmap_frozen_memory_usage(frozen) == cerb_counting_allocator_in_use(&counter), "wrong usage.");
+
+        rc = Hashmap_frozen_destroy(&frozen);
+        mu_assert(rc == CERB_OK && frozen == NULL, "failed to free frozen map.");
+        mu_assert(cerb_counting_allocator_in_use(&counter) == 0, "frozen map leaked memory.");
+    }
+
+    // string keys with default (seeded 64-bit) hash, and empty map
+    Hashmap *strings = Hashmap_create(string_cmp_HM, NULL, 0);
+    mu_assert(strings != NULL, "failed to create map.");
+    for (i = 0; i < 100; i++) {
+        snprintf(words[i], sizeof(words[i]), "w%d", i);
+        Hashmap_insert(strings, words[i]);
+    }
+    Hashmap_frozen *frozen = Hashmap_freeze(strings);
+    mu_assert(frozen != NULL && frozen->overflow == NULL, "failed to freeze map.");
+    mu_assert(Hashmap_frozen_find(frozen, "w42") == words[42], "frozen map lost string key.");
+    mu_assert(Hashmap_frozen_find(frozen, "w100") == NULL, "frozen map found missing string key.");
+    Hashmap_frozen_destroy(&frozen);
+    Hashmap_destroy(&strings, NULL);
+
+    Hashmap *empty = Hashmap_create(NULL, int_hash_HM, 0);
+    frozen = Hashmap_freeze(empty);
+    mu_assert(frozen != NULL && Hashmap_frozen_find(frozen, &values[1]) == NULL, "empty frozen map failed.");
+    Hashmap_frozen_destroy(&frozen);
+    Hashmap_destroy(&empty, NULL);
+
+    return NULL;
+}
+
+char *test_slab_HM()
+{
+    static int values[1000];
+    cerb_counting_allocator counter;
+    int i, round;
+
+    cerb_counting_allocator_init(&counter, NULL);
+    Hashmap *churned = Hashmap_create_with_allocator(NULL, int_hash_HM, 2048, &counter.allocator);
+    mu_assert(churned != NULL, "failed to create map.");
+
+    for (i = 0; i < 1000; i++) {
+        values[i] = i;
+        Hashmap_insert(churned, &values[i]);
+    }
+    uint64_t in_use = cerb_counting_allocator_in_use(&counter), allocations = counter.allocations;
+
+    // removed nodes are reused, churn doesn't take more memory and doesn't allocate nodes
+    for (round = 0; round < 10; round++) {
+        for (i = 0; i < 1000; i++) mu_assert(Hashmap_remove(churned, &values[i]) == &values[i], "remove failed.");
+        for (i = 0; i < 1000; i++) Hashmap_insert(churned, &values[i]);
+    }
+    mu_assert(cerb_counting_allocator_in_use(&counter) == in_use, "churn took more memory.");
+    mu_assert(counter.allocations - allocations <= 10 * 1000, "churn allocated nodes.");
+    for (i = 0; i < 1000; i++) mu_assert(Hashmap_find(churned, &values[i]) == &values[i], "churn lost keys.");
+
+    // clear gives slabs back
+    Hashmap_clear(churned, NULL, NULL);
+    mu_assert(churned->slabs == NULL && churned->free_nodes == NULL, "clear kept slabs.");
+    mu_assert(Hashmap_memory_usage(churned) == cerb_counting_allocator_in_use(&counter), "wrong usage.");
+
+    rc = Hashmap_destroy(&churned, nofree_cb);
+    mu_assert(rc != CERB_ERR, "failed to free.");
+    mu_assert(cerb_counting_allocator_in_use(&counter) == 0, "map leaked memory.");
+
+    return NULL;
+}
+
+static uint32_t constant_hash_HM(void *data)
+{
+    (void) data;
+    return 7;
+}
+
+char *test_stats_HM()
+{
+    static int values[64];
+    Hashmap_statistics stats;
+    int i;
+
+    // identity hash over 16 buckets which never grow puts exactly 4 keys in every bucket
+    Hashmap_config config = {NULL, int_hash_HM, 16, NULL, HASHMAP_CHAINED, HASHMAP_FIXED_SIZE, NULL, 0};
+    Hashmap *even = Hashmap_create_with_config(&config);
+    mu_assert(even != NULL, "failed to create map.");
+    for (i = 0; i < 64; i++) {
+        values[i] = i;
+        Hashmap_insert(even, &values[i]);
+    }
+    mu_assert(Hashmap_stats(even, &stats) == CERB_OK, "stats failed.");
+    mu_assert(stats.length == 64 && stats.capacity == 16 && stats.occupied == 16, "wrong size in stats.");
+    mu_assert(stats.load_factor == 4.0 && stats.histogram[4] == 16 && stats.max_chain == 4, "wrong chains.");
+    mu_assert(stats.average_chain == 2.5 && stats.expected_compares == 1.0, "wrong lookup cost.");
+
+    // constant hash piles everything in one bucket, and every key before the one looked for gets compared
+    config.hash = constant_hash_HM;
+    Hashmap *piled = Hashmap_create_with_config(&config);
+    mu_assert(piled != NULL, "failed to create map.");
+    for (i = 0; i < 64; i++) Hashmap_insert(piled, &values[i]);
+    Hashmap_stats(piled, &stats);
+    mu_assert(stats.occupied == 1 && stats.histogram[0] == 15, "wrong occupied buckets.");
+    mu_assert(stats.histogram[HASHMAP_STATS_HISTOGRAM - 1] == 1 && stats.max_chain == 64, "wrong long chain.");
+    mu_assert(stats.expected_compares == 32.5, "wrong compares.");
+
+    // robin hood histogram counts elements by distance from home slot
+    config.hash = int_hash_HM;
+    config.engine = HASHMAP_ROBIN_HOOD;
+    config.max_load = 0;
+    Hashmap *probed = Hashmap_create_with_config(&config);
+    mu_assert(probed != NULL, "failed to create map.");
+    for (i = 0; i < 64; i++) Hashmap_insert(probed, &values[i]);
+    Hashmap_stats(probed, &stats);
+    cerb_size_t counted = 0;
+    for (i = 0; i < HASHMAP_STATS_HISTOGRAM; i++) counted += stats.histogram[i];
+    mu_assert(stats.occupied == 64 && counted == 64 && stats.max_chain >= 1, "wrong robin hood stats.");
+    mu_assert(stats.load_factor < 1.0 && stats.expected_compares == 1.0, "wrong robin hood load.");
+
+#ifdef CERB_HASHMAP_COUNTERS
+    int missing = 100;
+    for (i = 0; i < 64; i++) Hashmap_find(even, &values[i]);
+    Hashmap_find(even, &missing);
+    Hashmap_stats(even, &stats);
+    mu_assert(stats.counters.inserts == 64 && stats.counters.resizes == 0, "wrong insert counters.");
+    mu_assert(stats.counters.hits == 64 && stats.counters.misses >= 1, "wrong lookup counters.");
+    Hashmap_stats(probed, &stats);
+    mu_assert(stats.counters.inserts == 64 && stats.counters.resizes > 0, "wrong robin hood counters.");
+#endif
+
+    Hashmap_destroy(&even, nofree_cb);
+    Hashmap_destroy(&piled, nofree_cb);
+    rc = Hashmap_destroy(&probed, nofree_cb);
+    mu_assert(rc != CERB_ERR, "failed to free.");
+
+    return NULL;
+}
+
 char *test_free_complex_data_HM()
 {
     rc = Hashmap_destroy(&map, nofree_cb);
@@ -320,6 +1313,176 @@ char *test_free_complex_data_HM()
     return NULL;
 }
 
+// test indexed heap
+
+// smaller distance comes out first (distances are ints)
+static int distance_cmp_IH(const void *const restrict data1, const void *const restrict data2)
+{
+    return (*(const int *) data1 < *(const int *) data2) - (*(const int *) data1 > *(const int *) data2);
+}
+
+char *test_indexed_heap_IH()
+{
+    static int values[100];
+    cerb_size_t handles[100], handle;
+    cerb_counting_allocator counter;
+    int i;
+
+    cerb_counting_allocator_init(&counter, NULL);
+    Indexed_heap *jobs = indexed_heap_create_with_allocator(NULL, 4, &counter.allocator);
+    mu_assert(jobs != NULL, "failed to create indexed heap.");
+
+    for (i = 0; i < 100; i++) {
+        values[i] = (i * 37) % 100;
+        rc = indexed_heap_insert(jobs, &values[i], &handles[i]);
+        mu_assert(rc != CERB_ERR && indexed_heap_get(jobs, handles[i]) == &values[i], "failed to insert.");
+    }
+
+    // cancel every third job, and move some others up and down
+    for (i = 0; i < 100; i += 3) mu_assert(indexed_heap_remove(jobs, handles[i]) == &values[i], "failed to remove.");
+    mu_assert(!indexed_heap_contains(jobs, handles[0]) && indexed_heap_remove(jobs, handles[0]) == NULL,
+              "removed handle is still there.");
+    for (i = 1; i < 100; i += 3) {
+        values[i] = i % 2 ? values[i] + 200 : values[i] - 200;
+        indexed_heap_update_priority(jobs, handles[i], &values[i]);
+    }
+    mu_assert(indexed_heap_length(jobs) == 66 && indexed_heap_contains(jobs, handles[1]), "wrong jobs left.");
+
+    int previous = 1000, popped = 0;
+    int *top;
+    while ((top = indexed_heap_pop(jobs, &handle)) != NULL) {
+        mu_assert(*top <= previous && top == &values[top - values] && handles[top - values] == handle, "wrong pop.");
+        previous = *top;
+        popped++;
+    }
+    mu_assert(popped == 66, "lost jobs.");
+
+    // handles of removed elements are reused
+    rc = indexed_heap_insert(jobs, &values[0], &handle);
+    mu_assert(rc != CERB_ERR && handle < 100, "handle wasn't reused.");
+
+    rc = indexed_heap_destroy(&jobs, NULL);
+    mu_assert(rc != CERB_ERR && jobs == NULL, "failed to free.");
+    mu_assert(cerb_counting_allocator_in_use(&counter) == 0, "indexed heap leaked memory.");
+
+    // dijkstra over ring of 50 nodes with chords, checked against bellman-ford
+    static int distances[50], expected[50];
+    int from[150], to[150], weight[150], e, round;
+    for (e = 0; e < 150; e++) {
+        from[e] = e % 50;
+        to[e] = e < 50 ? (e + 1) % 50 : (e * 7) % 50;
+        weight[e] = e < 50 ? 10 : 1 + (e * 13) % 17;
+    }
+    for (i = 0; i < 50; i++) expected[i] = distances[i] = i ? 1000000 : 0;
+    for (round = 0; round < 50; round++) {
+        for (e = 0; e < 150; e++) {
+            if (expected[from[e]] + weight[e] < expected[to[e]]) expected[to[e]] = expected[from[e]] + weight[e];
+        }
+    }
+
+    Indexed_heap *frontier = indexed_heap_create(distance_cmp_IH, 0);
+    mu_assert(frontier != NULL, "failed to create indexed heap.");
+    for (i = 0; i < 50; i++) indexed_heap_insert(frontier, &distances[i], &handles[i]); // handle i is node i
+
+    while ((top = indexed_heap_pop(frontier, NULL)) != NULL) {
+        int node = (int) (top - distances);
+        for (e = 0; e < 150; e++) {
+            if (from[e] != node || !indexed_heap_contains(frontier, handles[to[e]])) continue;
+            if (distances[node] + weight[e] < distances[to[e]]) {
+                distances[to[e]] = distances[node] + weight[e];
+                indexed_heap_decrease_key(frontier, handles[to[e]], &distances[to[e]]);
+            }
+        }
+    }
+    for (i = 0; i < 50; i++) mu_assert(distances[i] == expected[i], "dijkstra got wrong distance.");
+
+    rc = indexed_heap_destroy(&frontier, NULL);
+    mu_assert(rc != CERB_ERR, "failed to free.");
+
+    return NULL;
+}
+
+// test concurrent hashmap
+
+typedef struct chm_reader_context {
+    CHashmap *map;
+    int *values;
+    int stop;
+    int failed;
+    uint64_t rounds;
+} chm_reader_context;
+
+// stable keys have to be found all the time, churning ones are read inside read section
+static void *chm_reader(void *arg)
+{
+    chm_reader_context *context = arg;
+    int i;
+
+    while (!__atomic_load_n(&context->stop, __ATOMIC_ACQUIRE)) {
+        for (i = 0; i < 2000; i++) {
+            if (i < 1000) {
+                if (CHashmap_find(context->map, &context->values[i]) != &context->values[i]) context->failed = 1;
+            } else {
+                unsigned token = CHashmap_read_lock(context->map);
+                int *found = CHashmap_find(context->map, &context->values[i]);
+                if (found && *found != i) context->failed = 1;
+                CHashmap_read_unlock(context->map, token);
+            }
+        }
+        __atomic_add_fetch(&context->rounds, 1, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+char *test_concurrent_CHM()
+{
+    static int values[20000];
+    int i, round;
+
+    for (i = 0; i < 20000; i++) values[i] = i;
+
+    CHashmap *shared = CHashmap_create(NULL, int_hash_HM, 0);
+    mu_assert(shared != NULL, "failed to create map.");
+
+    for (i = 0; i < 1000; i++) {
+        rc = CHashmap_insert(shared, &values[i]);
+        mu_assert(rc == CERB_OK, "insert failed.");
+    }
+    mu_assert(CHashmap_insert(shared, &values[5]) == CHASHMAP_EXISTS, "key was inserted twice.");
+    mu_assert(CHashmap_length(shared) == 1000, "wrong length.");
+    mu_assert(shared->table->capacity >= 1000, "table didn't grow.");
+
+    chm_reader_context context = {shared, values, 0, 0, 0};
+    pthread_t readers[3];
+    for (i = 0; i < 3; i++) mu_assert(pthread_create(&readers[i], NULL, chm_reader, &context) == 0, "failed to start reader.");
+
+    // writer grows table and removes keys under readers' feet (sanitizer build catches early frees)
+    for (round = 0; round < 5; round++) {
+        for (i = 1000; i < 20000; i++) CHashmap_insert(shared, &values[i]);
+        for (i = 1000; i < 20000; i++) {
+            if (CHashmap_remove(shared, &values[i]) != &values[i]) context.failed = 1;
+        }
+    }
+    CHashmap_synchronize(shared);
+    // let readers do at least one round while table is settled
+    uint64_t seen = __atomic_load_n(&context.rounds, __ATOMIC_RELAXED);
+    while (__atomic_load_n(&context.rounds, __ATOMIC_RELAXED) < seen + 3) sched_yield();
+
+    __atomic_store_n(&context.stop, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < 3; i++) pthread_join(readers[i], NULL);
+
+    mu_assert(!context.failed, "reader or writer saw wrong data.");
+    mu_assert(CHashmap_length(shared) == 1000, "wrong length after removals.");
+    mu_assert(CHashmap_remove(shared, &values[1500]) == NULL, "removed missing key.");
+    mu_assert(CHashmap_find(shared, &values[999]) == &values[999], "find failed.");
+
+    rc = CHashmap_destroy(&shared, NULL); // values are static
+    mu_assert(rc != CERB_ERR, "failed to free.");
+
+    return NULL;
+}
+
 // test heap
 
 char *test_create_H()
@@ -372,6 +1535,112 @@ char *test_free_complex_data_H()
     return NULL;
 }
 
+char *test_arity_H()
+{
+    static int values[1000];
+    uint8_t arities[] = {2, 3, 4, 8, 16};
+    int i, a;
+
+    for (i = 0; i < 1000; i++) values[i] = (i * 7919) % 1000;
+
+    for (a = 0; a < 5; a++) {
+        priority_queue_config config = {NULL, 16, NULL, arities[a]};
+        priority_queue *queue = priority_queue_create_with_config(&config);
+        mu_assert(queue != NULL && heap_arity(queue) == arities[a], "failed to create d-ary queue.");
+
+        for (i = 0; i < 1000; i++) priority_queue_insert(queue, &values[i]);
+        int previous = 1000;
+        for (i = 0; i < 500; i++) {
+            int *top = priority_queue_shift(queue);
+            mu_assert(top != NULL && *top <= previous, "d-ary heap invariant is broken.");
+            previous = *top;
+        }
+
+        // rearranged heap goes on where it stopped
+        rc = heap_set_arity(queue, arities[(a + 1) % 5]);
+        mu_assert(rc != CERB_ERR, "failed to change arity.");
+        for (i = 0; i < 500; i++) {
+            int *top = priority_queue_shift(queue);
+            mu_assert(top != NULL && *top <= previous, "heap invariant is broken after arity change.");
+            previous = *top;
+        }
+        mu_assert(d_array_length(queue) == 0 && previous == 0, "wrong elements popped.");
+
+        priority_queue_destroy(&queue, nofree_cb);
+    }
+
+    priority_queue_config invalid = {NULL, 16, NULL, 1};
+    mu_assert(priority_queue_create_with_config(&invalid) == NULL, "arity 1 was accepted.");
+
+    return NULL;
+}
+
+// check that no element of heap is greater than its parent
+static int heap_valid_H(Heap *checked)
+{
+    cerb_size_t i;
+    for (i = 1; i < d_array_length(checked); i++) {
+        if (checked->compare(checked->data[i], checked->data[(i - 1) / heap_arity(checked)]) == HEAP_GREATER) return 0;
+    }
+    return 1;
+}
+
+char *test_bulk_H()
+{
+    static int values[1000];
+    void *pointers[1000];
+    uint8_t arities[] = {2, 3, 8};
+    int i, a;
+
+    for (i = 0; i < 1000; i++) {
+        values[i] = (i * 7919) % 1000;
+        pointers[i] = &values[i];
+    }
+
+    for (a = 0; a < 3; a++) {
+        // heapify of shuffled array
+        d_array *array = d_array_create(NULL, 16);
+        d_array_push_back_n(array, pointers, 1000);
+        array->heap_arity = arities[a];
+        Heap *built = heapify(&array);
+        mu_assert(built != NULL && array == NULL && heap_valid_H(built), "heapify broke heap invariant.");
+
+        // batches of every size go into heap which already holds something
+        Heap *batched = heap_create(NULL, 4);
+        heap_set_arity(batched, arities[a]);
+        int inserted = 0, size;
+        for (size = 1; inserted + size <= 1000; inserted += size, size *= 3) {
+            rc = heap_insert_batch(batched, pointers + inserted, size);
+            mu_assert(rc != CERB_ERR && heap_valid_H(batched), "insert_batch broke heap invariant.");
+        }
+
+        // melding and merging keep everything and heap invariant
+        Heap *melded = heap_meld(&built, &batched);
+        mu_assert(melded != NULL && d_array_length(melded) == 1000 + (cerb_size_t) inserted, "wrong meld length.");
+        mu_assert(heap_valid_H(melded) && built != NULL && batched != NULL, "meld broke heaps.");
+        Heap *merged = heap_merge(&batched, &built);
+        mu_assert(merged != NULL && batched == NULL && built == NULL && heap_valid_H(merged), "merge broke heap.");
+
+        // top 10 come out in order, and rest of heap is still heap under them
+        d_array *top = d_array_create(NULL, 1);
+        rc = heap_pop_n(merged, 10, top);
+        mu_assert(rc != CERB_ERR && d_array_length(top) == 10 && heap_valid_H(merged), "pop_n failed.");
+        for (i = 1; i < 10; i++) mu_assert(*(int *) top->data[i - 1] >= *(int *) top->data[i], "pop_n order is wrong.");
+        mu_assert(*(int *) top->data[9] >= *(int *) heap_find_max_index(merged), "pop_n skipped greater element.");
+
+        // asking for more than heap holds drains it
+        rc = heap_pop_n(merged, 100000, top);
+        mu_assert(rc != CERB_ERR && d_array_length(merged) == 0, "pop_n didn't drain heap.");
+        mu_assert(d_array_length(top) == 1000 + (cerb_size_t) inserted, "pop_n lost elements.");
+
+        heap_destroy(&merged, nofree_cb);
+        heap_destroy(&melded, nofree_cb);
+        d_array_destroy(&top, nofree_cb);
+    }
+
+    return NULL;
+}
+
 // test binary search tree
 
 char *test_create_BS()
@@ -429,6 +1698,277 @@ char *test_free_complex_data_BS()
     return NULL;
 }
 
+// test flatmap
+
+char *test_flatmap_FM()
+{
+    static int values[1000];
+    void *batch[500];
+    cerb_size_t i, from, to;
+
+    cerb_flatmap *flat = cerb_flatmap_create(NULL, 0);
+    mu_assert(flat != NULL, "failed to create flatmap.");
+
+    // odd values one by one in descending order, even ones in one batch, every value twice
+    for (i = 0; i < 1000; i++) values[i] = (int) (i % 500);
+    for (i = 500; i-- > 0;) {
+        if (values[i] % 2) {
+            rc = cerb_flatmap_insert(flat, &values[i]);
+            mu_assert(rc != CERB_ERR, "failed to insert.");
+        }
+    }
+    uint32_t batched = 0;
+    for (i = 0; i < 1000; i++) {
+        if (values[i] % 2 == 0 || i >= 500) batch[batched++ % 500] = &values[i];
+        if (batched == 500) {
+            rc = cerb_flatmap_insert_batch(flat, batch, 500);
+            mu_assert(rc != CERB_ERR, "failed to insert batch.");
+            batched = 0;
+        }
+    }
+    rc = cerb_flatmap_insert_batch(flat, batch, batched);
+    mu_assert(rc != CERB_ERR && cerb_flatmap_length(flat) == 1000, "wrong length after batch insert.");
+
+    // in order, equal elements in insertion order
+    for (i = 1; i < 1000; i++) {
+        int *previous = cerb_flatmap_at(flat, i - 1), *current = cerb_flatmap_at(flat, i);
+        mu_assert(*previous < *current || (*previous == *current && previous < current), "flatmap is not sorted.");
+    }
+
+    int key = 250;
+    rc = cerb_flatmap_equal_range(flat, &key, &from, &to);
+    mu_assert(rc != CERB_ERR && from == 500 && to == 502, "wrong equal range.");
+    mu_assert(cerb_flatmap_upper_bound(flat, &key) == 502, "wrong upper bound.");
+    key = 1000;
+    mu_assert(cerb_flatmap_lower_bound(flat, &key) == 1000 && cerb_flatmap_search(flat, &key) == NULL, "found missing key.");
+
+    key = 7;
+    mu_assert(cerb_flatmap_delete(flat, &key) == &values[7], "wrong element deleted.");
+    mu_assert(cerb_flatmap_search(flat, &key) == &values[507], "second equal element is gone.");
+
+    rc = cerb_flatmap_destroy(&flat, nofree_cb);
+    mu_assert(rc != CERB_ERR && flat == NULL, "error while freeing.");
+
+    return NULL;
+}
+
+// libc allocator which fails once allocations left in context run out
+static void *limited_alloc_FM(void *context, size_t size)
+{
+    int *left = context;
+    if (*left == 0) return NULL;
+    (*left)--;
+    return malloc(size);
+}
+
+static void *limited_realloc_FM(void *context, void *ptr, size_t old_size, size_t new_size)
+{
+    (void) old_size;
+    int *left = context;
+    if (*left == 0) return NULL;
+    (*left)--;
+    return realloc(ptr, new_size);
+}
+
+static void limited_free_FM(void *context, void *ptr, size_t size)
+{
+    (void) context;
+    (void) size;
+    free(ptr);
+}
+
+char *test_flatmap_failed_batch_FM()
+{
+    static int values[1000];
+    void *batch[500];
+    int left = 100, i, failing;
+    cerb_allocator limited = {limited_alloc_FM, limited_realloc_FM, limited_free_FM, &left};
+
+    cerb_flatmap *flat = cerb_flatmap_create_with_allocator(NULL, 1000, &limited);
+    mu_assert(flat != NULL, "failed to create flatmap.");
+    for (i = 0; i < 1000; i++) values[i] = (i * 7919) % 1000;
+    for (i = 0; i < 500; i++) batch[i] = &values[i];
+    rc = cerb_flatmap_insert_batch(flat, batch, 500);
+    mu_assert(rc != CERB_ERR, "failed to insert batch.");
+
+    // merge buffer fails first, then sort scratch: map has to stay as it was both times
+    for (i = 0; i < 500; i++) batch[i] = &values[500 + i];
+    for (failing = 0; failing < 2; failing++) {
+        left = failing;
+        rc = cerb_flatmap_insert_batch(flat, batch, 500);
+        mu_assert(rc == CERB_ERR && cerb_flatmap_length(flat) == 500, "failed batch was left in map.");
+        for (i = 1; i < 500; i++) {
+            mu_assert(*(int *) cerb_flatmap_at(flat, i - 1) <= *(int *) cerb_flatmap_at(flat, i), "map isn't sorted.");
+        }
+    }
+
+    left = 100;
+    rc = cerb_flatmap_insert_batch(flat, batch, 500);
+    mu_assert(rc != CERB_ERR && cerb_flatmap_length(flat) == 1000, "failed to insert batch.");
+
+    rc = cerb_flatmap_destroy(&flat, nofree_cb);
+    mu_assert(rc != CERB_ERR, "error while freeing.");
+
+    return NULL;
+}
+
+// test typed containers
+
+CERB_DARRAY_DEFINE(int_array, int, ((a) > (b)) - ((a) < (b)))
+CERB_HEAP_DEFINE(int_heap, int, ((a) > (b)) - ((a) < (b)))
+CERB_HASHMAP_DEFINE(int_set, int, (uint64_t) (a) * 0x9E3779B97F4A7C15ULL, ((a) > (b)) - ((a) < (b)))
+
+char *test_typed_array_TY()
+{
+    int_array *ints = int_array_create(0);
+    mu_assert(ints != NULL, "failed to create typed array.");
+
+    int i, value = 0;
+    for (i = 0; i < 1000; i++) {
+        rc = int_array_push_back(ints, i);
+        mu_assert(rc != CERB_ERR, "push failed.");
+    }
+    rc = int_array_push_front(ints, -1);
+    mu_assert(rc != CERB_ERR && *int_array_get(ints, 0) == -1, "push_front failed.");
+    rc = int_array_insert_at(ints, 500, 7777);
+    mu_assert(rc != CERB_ERR && *int_array_get(ints, 500) == 7777, "insert_at failed.");
+    mu_assert(int_array_index_of(ints, 7777) == 500, "index_of failed.");
+    mu_assert(int_array_index_of(ints, 998) == 1000, "index_of failed.");
+
+    rc = int_array_remove_at(ints, 500, &value);
+    mu_assert(rc != CERB_ERR && value == 7777, "remove_at failed.");
+    rc = int_array_pop_front(ints, &value);
+    mu_assert(rc != CERB_ERR && value == -1, "pop_front failed.");
+    while (ints->length) int_array_pop_back(ints, &value);
+    mu_assert(value == 0, "pop_back failed.");
+    mu_assert(ints->capacity == CERB_TYPED_DEFAULT_CAPACITY, "typed array didn't shrink.");
+
+    rc = int_array_destroy(&ints);
+    mu_assert(rc != CERB_ERR && ints == NULL, "failed to destroy typed array.");
+
+    return NULL;
+}
+
+char *test_typed_heap_TY()
+{
+    int_heap *ints = int_heap_create(4);
+    mu_assert(ints != NULL, "failed to create typed heap.");
+
+    int i, value = 0, previous = 1000;
+    for (i = 0; i < 500; i++) {
+        rc = int_heap_insert(ints, (i * 7919) % 500);
+        mu_assert(rc != CERB_ERR, "insert failed.");
+    }
+    mu_assert(*int_heap_top(ints) == 499, "wrong top of heap.");
+
+    while (ints->length) {
+        rc = int_heap_pop(ints, &value);
+        mu_assert(rc != CERB_ERR && value <= previous, "heap invariant is broken.");
+        previous = value;
+    }
+
+    for (i = 0; i < 100; i++) int_heap_push_back(ints, i);
+    int_heap_heapify(ints);
+    mu_assert(*int_heap_top(ints) == 99, "heapify failed.");
+
+    rc = int_heap_destroy(&ints);
+    mu_assert(rc != CERB_ERR, "failed to destroy typed heap.");
+
+    return NULL;
+}
+
+char *test_typed_hashmap_TY()
+{
+    int_set *set = int_set_create(0);
+    mu_assert(set != NULL, "failed to create typed map.");
+
+    int i, value = 0;
+    for (i = 0; i < 10000; i++) {
+        rc = int_set_insert(set, i * 3);
+        mu_assert(rc != CERB_ERR, "insert failed.");
+    }
+    mu_assert(set->length == 10000, "wrong length of typed map.");
+    mu_assert(int_set_find(set, 2997) != NULL && *int_set_find(set, 2997) == 2997, "find failed.");
+    mu_assert(int_set_find(set, 2998) == NULL, "found missing key.");
+
+    // remove every other key and make sure that the rest is still reachable
+    for (i = 0; i < 10000; i += 2) {
+        rc = int_set_remove(set, i * 3, &value);
+        mu_assert(rc != CERB_ERR && value == i * 3, "remove failed.");
+    }
+    for (i = 0; i < 10000; i++) {
+        mu_assert((int_set_find(set, i * 3) != NULL) == (i % 2 == 1), "wrong find after remove.");
+    }
+
+    rc = int_set_destroy(&set);
+    mu_assert(rc != CERB_ERR, "failed to destroy typed map.");
+
+    return NULL;
+}
+
+// test allocators
+
+char *test_allocator_ALL()
+{
+    static int values[1000];
+    cerb_counting_allocator counter;
+    cerb_counting_allocator_init(&counter, NULL);
+    const cerb_allocator *allocator = &counter.allocator;
+
+    int i;
+    for (i = 0; i < 1000; i++) values[i] = (1000 - i) * 7 % 1009; // distinct values in shuffled order
+
+    // every container takes all of its memory from counter and gives all of it back
+    d_array *array = d_array_create_with_allocator(NULL, 4, allocator);
+    Hashmap *hashmap = Hashmap_create_with_allocator(NULL, int_hash_HM, 16, allocator);
+    Heap *allocated_heap = heap_create_with_allocator(NULL, 4, allocator);
+    singly_linked *singly = singly_linked_create_with_allocator(NULL, allocator);
+    Queue *queue = Queue_create_with_allocator(NULL, allocator);
+    BS_tree *tree = BS_tree_create_with_allocator(NULL, allocator);
+    cerb_flatmap *flatmap = cerb_flatmap_create_with_allocator(NULL, 4, allocator);
+    int_set *set = int_set_create_with_allocator(0, allocator);
+    mu_assert(array && hashmap && allocated_heap && singly && queue && tree && flatmap && set, "failed to create containers.");
+
+    for (i = 0; i < 1000; i++) {
+        d_array_push_back(array, &values[i]);
+        Hashmap_insert(hashmap, &values[i]);
+        heap_insert(allocated_heap, &values[i]);
+        singly_linked_push(singly, &values[i]);
+        Queue_push(queue, &values[i]);
+        BS_tree_insert(tree, &values[i]);
+        int_set_insert(set, values[i]);
+    }
+    cerb_flatmap_insert_batch(flatmap, (void **) array->data, 500);
+    cerb_flatmap_insert_batch(flatmap, (void **) array->data + 500, 500);
+    d_array_stable_sort(array);
+
+    // hashmap nodes come from slabs, so they add only a few allocations
+    mu_assert(counter.allocations > 3000, "containers didn't allocate through allocator.");
+    mu_assert(cerb_counting_allocator_in_use(&counter) > 0, "nothing is in use.");
+
+    for (i = 0; i < 500; i++) {
+        d_array_pop_back(array);
+        Hashmap_remove(hashmap, &values[i]);
+        heap_pop(allocated_heap);
+        singly_linked_shift(singly);
+        BS_tree_delete(tree, &values[i]);
+    }
+
+    d_array_destroy(&array, nofree_cb);
+    Hashmap_destroy(&hashmap, nofree_cb);
+    heap_destroy(&allocated_heap, nofree_cb);
+    singly_linked_destroy(&singly, nofree_cb);
+    Queue_destroy(&queue, nofree_cb);
+    BS_tree_destroy(&tree, nofree_cb);
+    cerb_flatmap_destroy(&flatmap, nofree_cb);
+    int_set_destroy(&set);
+
+    mu_assert(cerb_counting_allocator_in_use(&counter) == 0, "containers leaked memory.");
+    mu_assert(counter.allocations + counter.reallocations > 0 && counter.frees > 0, "allocator wasn't used.");
+
+    return NULL;
+}
+
 // =========================================================================================================
 
 // run all tests
@@ -455,23 +1995,56 @@ char *all_tests()
     mu_run_test(test_create_DA);
     mu_run_test(test_push_DA);
     mu_run_test(test_pop_DA);
+    mu_run_test(test_print_DA);
     mu_run_test(test_free_array_DA);
+    mu_run_test(test_growth_policy_DA);
+    mu_run_test(test_ring_mode_DA);
+    mu_run_test(test_bulk_DA);
+    mu_run_test(test_sort_DA);
+    mu_run_test(test_parallel_DA);
+    mu_run_test(test_search_DA);
 
     mu_run_test(test_create_HM);
     mu_run_test(test_set_HM);
     mu_run_test(test_delete_HM);
+    mu_run_test(test_search_HM);
+    mu_run_test(test_hash_compare_HM);
+    mu_run_test(test_hash_bytes_HM);
+    mu_run_test(test_rehash_HM);
+    mu_run_test(test_robin_hood_HM);
+    mu_run_test(test_key_value_HM);
+    mu_run_test(test_memory_usage_HM);
+    mu_run_test(test_iter_HM);
+    mu_run_test(test_batch_HM);
+    mu_run_test(test_freeze_HM);
+    mu_run_test(test_slab_HM);
+    mu_run_test(test_stats_HM);
     mu_run_test(test_free_complex_data_HM);
 
+    mu_run_test(test_concurrent_CHM);
+
     mu_run_test(test_create_H);
     mu_run_test(test_insert_H);
     mu_run_test(test_delete_H);
     mu_run_test(test_free_complex_data_H);
+    mu_run_test(test_arity_H);
+    mu_run_test(test_bulk_H);
+    mu_run_test(test_indexed_heap_IH);
 
     mu_run_test(test_create_BS);
     mu_run_test(test_insert_BS);
     mu_run_test(test_delete_BS);
     mu_run_test(test_free_complex_data_BS);
 
+    mu_run_test(test_flatmap_FM);
+    mu_run_test(test_flatmap_failed_batch_FM);
+
+    mu_run_test(test_typed_array_TY);
+    mu_run_test(test_typed_heap_TY);
+    mu_run_test(test_typed_hashmap_TY);
+
+    mu_run_test(test_allocator_ALL);
+
     return NULL;
 }
 